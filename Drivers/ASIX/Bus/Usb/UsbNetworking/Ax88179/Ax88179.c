@@ -934,9 +934,23 @@ Ax88179GetLinkStatus (
 
 }
 
+/**
+  Perform one bulk-in transfer of a full receive aggregate into Buffer.
+
+  @param [in]  NicDevice       Pointer to the NIC_DEVICE structure
+  @param [in]  Buffer          Receive ring buffer of AX88179_MAX_BULKIN_SIZE bytes
+  @param [out] Length          Number of bytes received
+
+  @retval EFI_SUCCESS          A complete aggregate was received
+  @retval EFI_NOT_READY        No data, or the aggregate was discarded
+
+**/
+STATIC
 EFI_STATUS
-Ax88179BulkIn(
-  IN NIC_DEVICE *NicDevice
+Ax88179BulkInTransfer (
+  IN  NIC_DEVICE *NicDevice,
+  IN  UINT8      *Buffer,
+  OUT UINTN      *Length
 )
 {
   int i;
@@ -968,7 +982,7 @@ Ax88179BulkIn(
       }
       NicDevice->SetZeroLen = FALSE;
     }
-    TmpAddr = (VOID*) &NicDevice->BulkInbuf[LengthInBytes];
+    TmpAddr = (VOID*) &Buffer[LengthInBytes];
 
     Status =  EFI_NOT_READY;
     Status = UsbIo->UsbBulkTransfer (UsbIo,
@@ -1021,17 +1035,16 @@ done:
     UINT16 tmplen = 0;
     UINT16 TmpPktCnt = 0;
 
-    TmpPktCnt = *((UINT16 *) (NicDevice->BulkInbuf + LengthInBytes - 4));
-    tmplen =  *((UINT16*) (NicDevice->BulkInbuf + LengthInBytes - 2));
+    TmpPktCnt = *((UINT16 *) (Buffer + LengthInBytes - 4));
+    tmplen =  *((UINT16*) (Buffer + LengthInBytes - 2));
 
     if (((UINTN)(((TmpPktCnt * 4 + 4 + 7) & 0xfff8) + tmplen)) == LengthInBytes) {
-      NicDevice->PktCnt = TmpPktCnt;
-      NicDevice->CurPktHdrOff = NicDevice->BulkInbuf + tmplen;
-      NicDevice->CurPktOff = NicDevice->BulkInbuf;
-      *((UINT16 *) (NicDevice->BulkInbuf + LengthInBytes - 4)) = 0;
-      *((UINT16*) (NicDevice->BulkInbuf + LengthInBytes - 2)) = 0;
+      *Length = LengthInBytes;
       Status = EFI_SUCCESS;
     } else {
+      NicDevice->RxOverflowCnt++;
+      DEBUG ((DEBUG_INFO, "Ax88179: Discarded malformed bulk-in transfer of %Lu bytes, %ld so far\n",
+              (UINT64) LengthInBytes, NicDevice->RxOverflowCnt));
       Status = EFI_NOT_READY;
     }
   } else {
@@ -1040,3 +1053,69 @@ done:
 no_pkt:
    return Status;
 }
+
+/**
+  Load the next received aggregate for packet parsing.
+
+  When the receive ring is empty, it is refilled with back-to-back bulk-in
+  transfers until the device has no more data or the ring is full, so the
+  device RX FIFO is drained ahead of the packets being consumed. A short
+  aggregate does not end the refill, the device also completes a transfer
+  early when its bulk-in timer expires while more frames are arriving.
+
+  @param [in] NicDevice        Pointer to the NIC_DEVICE structure
+
+  @retval EFI_SUCCESS          PktCnt, CurPktHdrOff and CurPktOff describe a new aggregate
+  @retval EFI_NOT_READY        No data received
+
+**/
+EFI_STATUS
+Ax88179BulkIn(
+  IN NIC_DEVICE *NicDevice
+)
+{
+  UINT8       *Buffer;
+  UINTN       Length;
+  UINT8       Slot;
+  UINT16      TmpPktCnt;
+  UINT16      TmpLen;
+  EFI_STATUS  Status;
+
+  if (NicDevice->RxRingCount == 0) {
+    while (NicDevice->RxRingCount < AX88179_RX_RING_SIZE) {
+      Slot = (NicDevice->RxRingHead + NicDevice->RxRingCount) % AX88179_RX_RING_SIZE;
+      Buffer = AX88179_RX_RING_BUFFER (NicDevice, Slot);
+      Status = Ax88179BulkInTransfer (NicDevice, Buffer, &Length);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+      NicDevice->RxRingLen[Slot] = Length;
+      NicDevice->RxRingCount++;
+    }
+
+    if (NicDevice->RxRingCount == 0) {
+      return EFI_NOT_READY;
+    }
+  }
+
+  //
+  //  The ring is only refilled once the current aggregate has been
+  //  consumed, so the slot can be released right away
+  //
+  Slot = NicDevice->RxRingHead;
+  Buffer = AX88179_RX_RING_BUFFER (NicDevice, Slot);
+  Length = NicDevice->RxRingLen[Slot];
+  NicDevice->RxRingHead = (Slot + 1) % AX88179_RX_RING_SIZE;
+  NicDevice->RxRingCount--;
+
+  TmpPktCnt = *((UINT16 *) (Buffer + Length - 4));
+  TmpLen = *((UINT16 *) (Buffer + Length - 2));
+
+  NicDevice->PktCnt = TmpPktCnt;
+  NicDevice->CurPktHdrOff = Buffer + TmpLen;
+  NicDevice->CurPktOff = Buffer;
+  *((UINT16 *) (Buffer + Length - 4)) = 0;
+  *((UINT16 *) (Buffer + Length - 2)) = 0;
+
+  return EFI_SUCCESS;
+}
@@ -71,6 +71,7 @@
 
 #define AX88179_BULKIN_SIZE_INK     2
 #define AX88179_MAX_BULKIN_SIZE    (1024 * AX88179_BULKIN_SIZE_INK)
+#define AX88179_RX_RING_SIZE       4
 #define AX88179_MAX_PKT_SIZE  2048
 
 #define HC_DEBUG        0
@@ -274,11 +275,18 @@ typedef struct {
   UINTN                     PollCount;          ///<  Number of times the autonegotiation status was polled
   UINTN                     SkipRXCnt;
 
-  UINT8                     *BulkInbuf;
+  UINT8                     *BulkInbuf;         ///<  Receive ring, AX88179_RX_RING_SIZE bulk-in buffers
+  UINTN                     RxRingLen[AX88179_RX_RING_SIZE];  ///<  Received length per ring buffer
+  UINT8                     RxRingHead;         ///<  Next filled ring buffer to parse
+  UINT8                     RxRingCount;        ///<  Number of filled ring buffers
   UINT16                    PktCnt;
   UINT8                     *CurPktHdrOff;
   UINT8                     *CurPktOff;
 
+  UINT64                    RxGoodCnt;          ///<  Frames handed to the caller
+  UINT64                    RxDropCnt;          ///<  Frames dropped (error flags, bad length or marker)
+  UINT64                    RxOverflowCnt;      ///<  Bulk-in transfers discarded as overflowing or malformed
+
   TX_PACKET                 *TxTest;
 
   INT8                      MulticastHash[8];
@@ -298,6 +306,9 @@ typedef struct {
 
 #define DEV_FROM_SIMPLE_NETWORK(a)  CR (a, NIC_DEVICE, SimpleNetwork, DEV_SIGNATURE)  ///< Locate NIC_DEVICE from Simple Network Protocol
 
+#define AX88179_RX_RING_BUFFER(NicDevice, Slot) \
+  ((NicDevice)->BulkInbuf + (UINTN)(Slot) * AX88179_MAX_BULKIN_SIZE)  ///< Locate a receive ring buffer
+
 //------------------------------------------------------------------------------
 // Simple Network Protocol
 //------------------------------------------------------------------------------
@@ -603,11 +603,13 @@ SN_Receive (
             Type = (UINT16)((Type >> 8) | (Type << 8));
             *Protocol = Type;
           }
+          NicDevice->RxGoodCnt++;
           NicDevice->PktCnt--;
           NicDevice->CurPktHdrOff += 4;
           NicDevice->CurPktOff += (CurrentPktLen + 2 + 7) & 0xfff8;
           Status = EFI_SUCCESS;
         } else {
+          NicDevice->RxDropCnt++;
           NicDevice->PktCnt = 0;
           Status = EFI_NOT_READY;
         }
@@ -968,6 +970,11 @@ SN_Setup (
   NicDevice->Grub_f = FALSE;
   NicDevice->FirstRst = TRUE;
   NicDevice->PktCnt = 0;
+  NicDevice->RxRingHead = 0;
+  NicDevice->RxRingCount = 0;
+  NicDevice->RxGoodCnt = 0;
+  NicDevice->RxDropCnt = 0;
+  NicDevice->RxOverflowCnt = 0;
   NicDevice->SkipRXCnt = 0;
   NicDevice->UsbMaxPktSize = 512;
   NicDevice->SetZeroLen = TRUE;
@@ -990,7 +997,7 @@ SN_Setup (
             PXE_HWADDR_LEN_ETHER);
 
   Status = gBS->AllocatePool (EfiBootServicesData,
-                               AX88179_MAX_BULKIN_SIZE,
+                               AX88179_MAX_BULKIN_SIZE * AX88179_RX_RING_SIZE,
                                (VOID **) &NicDevice->BulkInbuf);
 
   if (EFI_ERROR (Status)) {
@@ -1217,20 +1224,43 @@ SN_Statistics (
   EFI_STATUS              Status;
   EFI_TPL                 TplPrevious;
   EFI_SIMPLE_NETWORK_MODE *Mode;
+  NIC_DEVICE              *NicDevice;
+  EFI_NETWORK_STATISTICS  Statistics;
 
   TplPrevious = gBS->RaiseTPL(TPL_CALLBACK);
   Mode = SimpleNetwork->Mode;
 
   if (EfiSimpleNetworkInitialized == Mode->State) {
-    if ((StatisticsSize != NULL) && (*StatisticsSize == 0)) {
-      Status = EFI_BUFFER_TOO_SMALL;
-      goto EXIT;
+    NicDevice = DEV_FROM_SIMPLE_NETWORK (SimpleNetwork);
+    Status = EFI_SUCCESS;
+
+    if (StatisticsSize != NULL) {
+      //
+      //  Only the receive counters are collected, others read as unsupported
+      //
+      SetMem (&Statistics, sizeof (Statistics), 0xff);
+      Statistics.RxTotalFrames = NicDevice->RxGoodCnt + NicDevice->RxDropCnt;
+      Statistics.RxGoodFrames = NicDevice->RxGoodCnt;
+      Statistics.RxDroppedFrames = NicDevice->RxDropCnt;
+
+      if ((StatisticsTable == NULL) || (*StatisticsSize < sizeof (Statistics))) {
+        if (StatisticsTable != NULL) {
+          CopyMem (StatisticsTable, &Statistics, *StatisticsSize);
+        }
+        Status = EFI_BUFFER_TOO_SMALL;
+      } else {
+        CopyMem (StatisticsTable, &Statistics, sizeof (Statistics));
+      }
+      *StatisticsSize = sizeof (Statistics);
     }
 
-    if(Reset) {
-      Status = EFI_SUCCESS;
-    } else {
-      Status = EFI_SUCCESS;
+    DEBUG ((DEBUG_VERBOSE, "Ax88179: Rx good %ld, dropped %ld, overflowed transfers %ld\n",
+            NicDevice->RxGoodCnt, NicDevice->RxDropCnt, NicDevice->RxOverflowCnt));
+
+    if (Reset) {
+      NicDevice->RxGoodCnt = 0;
+      NicDevice->RxDropCnt = 0;
+      NicDevice->RxOverflowCnt = 0;
     }
   } else {
     if (EfiSimpleNetworkStarted == Mode->State) {
@@ -1240,8 +1270,6 @@ SN_Statistics (
     }
   }
 
-  Status = EFI_UNSUPPORTED;
-EXIT:
   gBS->RestoreTPL(TplPrevious);
   return Status;
 }
@@ -369,6 +369,8 @@ Returns:
     return Status;
   }
 
+  FreeAtapiBusMaster (AtapiScsiPrivate);
+
   //
   // Restore original PCI attributes
   //
@@ -442,6 +444,10 @@ Returns:
 
   InitAtapiIoPortRegisters(AtapiScsiPrivate, IdeRegsBaseAddr);
 
+  if (FeaturePcdGet (PcdSupportAtapiBusMasterDma)) {
+    InitAtapiBusMaster (AtapiScsiPrivate);
+  }
+
   //
   // Initialize the LatestTargetId to MAX_TARGET_ID.
   //
@@ -449,6 +455,10 @@ Returns:
   AtapiScsiPrivate->LatestLun       = 0;
 
   Status = InstallScsiPassThruProtocols (&Controller, AtapiScsiPrivate);
+  if (EFI_ERROR (Status)) {
+    FreeAtapiBusMaster (AtapiScsiPrivate);
+    gBS->FreePool (AtapiScsiPrivate);
+  }
 
   return Status;
 }
@@ -790,65 +800,11 @@ Returns:
                           to reset the SCSI channel.
 --*/
 {
-  UINT8                     DeviceControlValue;
   ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate;
-  UINT8                     Index;
-  BOOLEAN                   ResetFlag;
 
   AtapiScsiPrivate = ATAPI_SCSI_PASS_THRU_DEV_FROM_THIS (This);
-  ResetFlag = FALSE;
-
-  //
-  // Reset both Primary channel and Secondary channel.
-  // so, the IoPort pointer must point to the right I/O Register group
-  //
-  for (Index = 0; Index < 2; Index++) {
-    //
-    // Reset
-    //
-    AtapiScsiPrivate->IoPort  = &AtapiScsiPrivate->AtapiIoPortRegisters[Index];
-
-    DeviceControlValue        = 0;
-    //
-    // set SRST bit to initiate soft reset
-    //
-    DeviceControlValue |= SRST;
-    //
-    // disable Interrupt
-    //
-    DeviceControlValue |= BIT1;
-    WritePortB (
-      AtapiScsiPrivate->PciIo,
-      AtapiScsiPrivate->IoPort->Alt.DeviceControl,
-      DeviceControlValue
-      );
-
-    //
-    // Wait 10us
-    //
-    gBS->Stall (10);
-
-    //
-    // Clear SRST bit
-    // 0xfb:1111,1011
-    //
-    DeviceControlValue &= 0xfb;
-
-    WritePortB (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Alt.DeviceControl, DeviceControlValue);
-
-    //
-    // slave device needs at most 31s to clear BSY
-    //
-    if (StatusWaitForBSYClear (AtapiScsiPrivate, 31000000) != EFI_TIMEOUT) {
-      ResetFlag = TRUE;
-    }
-  }
-
-  if (ResetFlag) {
-    return EFI_SUCCESS;
-  }
 
-  return EFI_TIMEOUT;
+  return AtapiPassThruResetChannels (AtapiScsiPrivate);
 }
 
 EFI_STATUS
@@ -887,6 +843,7 @@ Returns:
   ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate;
   UINT8                     Command;
   UINT8                     DeviceSelect;
+  UINT8                     ResetMask;
 
   AtapiScsiPrivate = ATAPI_SCSI_PASS_THRU_DEV_FROM_THIS (This);
 
@@ -924,18 +881,18 @@ Returns:
 
   //
   // BSY clear is the only status return to the host by the device
-  // when reset is complete.
-  // slave device needs at most 31s to clear BSY
+  // when reset is complete. Then poll until the device status is stable
+  // rather than stalling for a fixed time.
   //
-  if (EFI_ERROR (StatusWaitForBSYClear (AtapiScsiPrivate, 31000000))) {
+  WaitForChannelsReady (
+    AtapiScsiPrivate,
+    (UINT8) (1 << (Target / 2)),
+    &ResetMask
+    );
+  if (ResetMask == 0) {
     return EFI_TIMEOUT;
   }
 
-  //
-  // stall 5 seconds to make the device status stable
-  //
-  gBS->Stall (5000000);
-
   return EFI_SUCCESS;
 }
 
@@ -1304,65 +1261,11 @@ Returns:
                           to reset the SCSI channel.
 --*/
 {
-  UINT8                         DeviceControlValue;
-  UINT8                         Index;
   ATAPI_SCSI_PASS_THRU_DEV      *AtapiScsiPrivate;
-  BOOLEAN                       ResetFlag;
 
   AtapiScsiPrivate = ATAPI_EXT_SCSI_PASS_THRU_DEV_FROM_THIS (This);
-  ResetFlag = FALSE;
-  //
-  // Reset both Primary channel and Secondary channel.
-  // so, the IoPort pointer must point to the right I/O Register group
-  // And if there is a channel reset successfully, return EFI_SUCCESS.
-  //
-  for (Index = 0; Index < 2; Index++) {
-    //
-    // Reset
-    //
-    AtapiScsiPrivate->IoPort  = &AtapiScsiPrivate->AtapiIoPortRegisters[Index];
-
-    DeviceControlValue        = 0;
-    //
-    // set SRST bit to initiate soft reset
-    //
-    DeviceControlValue |= SRST;
-    //
-    // disable Interrupt
-    //
-    DeviceControlValue |= BIT1;
-    WritePortB (
-      AtapiScsiPrivate->PciIo,
-      AtapiScsiPrivate->IoPort->Alt.DeviceControl,
-      DeviceControlValue
-      );
-
-    //
-    // Wait 10us
-    //
-    gBS->Stall (10);
-
-    //
-    // Clear SRST bit
-    // 0xfb:1111,1011
-    //
-    DeviceControlValue &= 0xfb;
-
-    WritePortB (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Alt.DeviceControl, DeviceControlValue);
-
-    //
-    // slave device needs at most 31s to clear BSY
-    //
-    if (StatusWaitForBSYClear (AtapiScsiPrivate, 31000000) != EFI_TIMEOUT) {
-      ResetFlag = TRUE;
-    }
-  }
 
-  if (ResetFlag) {
-    return EFI_SUCCESS;
-  }
-
-  return EFI_TIMEOUT;
+  return AtapiPassThruResetChannels (AtapiScsiPrivate);
 }
 
 EFI_STATUS
@@ -1401,6 +1304,7 @@ Returns:
   UINT8                         Command;
   UINT8                         DeviceSelect;
   UINT8                         TargetId;
+  UINT8                         ResetMask;
   ATAPI_SCSI_PASS_THRU_DEV      *AtapiScsiPrivate;
 
   AtapiScsiPrivate = ATAPI_EXT_SCSI_PASS_THRU_DEV_FROM_THIS (This);
@@ -1440,18 +1344,18 @@ Returns:
 
   //
   // BSY clear is the only status return to the host by the device
-  // when reset is complete.
-  // slave device needs at most 31s to clear BSY
+  // when reset is complete. Then poll until the device status is stable
+  // rather than stalling for a fixed time.
   //
-  if (EFI_ERROR (StatusWaitForBSYClear (AtapiScsiPrivate, 31000000))) {
+  WaitForChannelsReady (
+    AtapiScsiPrivate,
+    (UINT8) (1 << (TargetId / 2)),
+    &ResetMask
+    );
+  if (ResetMask == 0) {
     return EFI_TIMEOUT;
   }
 
-  //
-  // stall 5 seconds to make the device status stable
-  //
-  gBS->Stall (5000000);
-
   return EFI_SUCCESS;
 }
 
@@ -1675,188 +1579,642 @@ Returns:
 
 }
 
-
-EFI_STATUS
-CheckSCSIRequestPacket (
-  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET      *Packet
+VOID
+InitAtapiBusMaster (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
   )
 /*++
 
 Routine Description:
 
-  Checks the parameters in the SCSI Request Packet to make sure
-  they are valid for a SCSI Pass Thru request.
+  Locate the Bus Master IDE registers through BAR4 and set up the PRD
+  tables. Leaves BusMasterBaseAddr zero, so that every transfer uses PIO,
+  when the controller or the platform can not do bus master DMA.
 
 Arguments:
 
-  Packet         -  The pointer of EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
 
 Returns:
 
-  EFI_STATUS
+  None
 
 --*/
 {
-  if (Packet == NULL) {
-    return EFI_INVALID_PARAMETER;
+  EFI_STATUS            Status;
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  PCI_TYPE00            PciData;
+  UINT64                Attributes;
+  UINT16                BusMasterBaseAddr;
+  VOID                  *PrdTable;
+  UINTN                 Bytes;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  VOID                  *Mapping;
+
+  PciIo = AtapiScsiPrivate->PciIo;
+
+  Status = PciIo->Pci.Read (
+                        PciIo,
+                        EfiPciIoWidthUint8,
+                        0,
+                        sizeof (PciData),
+                        &PciData
+                        );
+  if (EFI_ERROR (Status)) {
+    return;
   }
 
-  if (!ValidCdbLength (Packet->CdbLength)) {
-    return EFI_INVALID_PARAMETER;
+  //
+  // The Bus Master IDE registers live in an I/O BAR4
+  //
+  if (((PciData.Hdr.ClassCode[0] & IDE_BUS_MASTER_CAPABLE) == 0) ||
+      ((PciData.Device.Bar[4] & BIT0) == 0)) {
+    return;
   }
 
-  if (Packet->Cdb == NULL) {
-    return EFI_INVALID_PARAMETER;
+  BusMasterBaseAddr = (UINT16) (PciData.Device.Bar[4] & 0x0000fff0);
+  if (BusMasterBaseAddr == 0) {
+    return;
+  }
+
+  Status = PciIo->Attributes (
+                    PciIo,
+                    EfiPciIoAttributeOperationGet,
+                    0,
+                    &Attributes
+                    );
+  if (EFI_ERROR (Status) || ((Attributes & EFI_PCI_IO_ATTRIBUTE_BUS_MASTER) == 0)) {
+    return;
   }
 
   //
-  // Checks whether the request command is supported.
+  // One page holds the PRD tables of both channels. Without the dual address
+  // cycle attribute it is allocated below 4GB, and being page aligned it can
+  // not cross a 64K boundary.
   //
-  if (!IsCommandValid (Packet)) {
-    return EFI_UNSUPPORTED;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    ATAPI_PRD_TABLE_PAGES,
+                    &PrdTable,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return;
   }
 
-  return EFI_SUCCESS;
+  Bytes  = EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    PrdTable,
+                    &Bytes,
+                    &DeviceAddress,
+                    &Mapping
+                    );
+  if (EFI_ERROR (Status)) {
+    PciIo->FreeBuffer (PciIo, ATAPI_PRD_TABLE_PAGES, PrdTable);
+    return;
+  }
+
+  if ((Bytes != EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES)) ||
+      ((DeviceAddress + Bytes) > BIT32)) {
+    PciIo->Unmap (PciIo, Mapping);
+    PciIo->FreeBuffer (PciIo, ATAPI_PRD_TABLE_PAGES, PrdTable);
+    return;
+  }
+
+  ZeroMem (PrdTable, EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES));
+
+  AtapiScsiPrivate->PrdTable                        = PrdTable;
+  AtapiScsiPrivate->PrdTableDeviceAddr              = DeviceAddress;
+  AtapiScsiPrivate->PrdTableMapping                 = Mapping;
+  AtapiScsiPrivate->BusMasterBaseAddr[IdePrimary]   = BusMasterBaseAddr;
+  AtapiScsiPrivate->BusMasterBaseAddr[IdeSecondary] = (UINT16) (BusMasterBaseAddr + BMIDE_SECONDARY_OFFSET);
+
+  InitAtapiDeviceDma (AtapiScsiPrivate);
 }
 
-BOOLEAN
-IsCommandValid (
-  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET   *Packet
+VOID
+InitAtapiDeviceDma (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
   )
 /*++
 
 Routine Description:
 
-  Checks the requested SCSI command:
-  Is it supported by this driver?
-  Is the Data transfer direction reasonable?
+  Identify the PACKET device at every position of the channels that have
+  bus master DMA, and enable DMA for the devices whose IDENTIFY PACKET
+  DEVICE data reports it.
+
+  With the IDE Controller Init protocol, the transfer modes come from
+  CalculateMode() and the controller timing is programmed by SetTiming().
+  Without it, the controller timing is left to the platform, so DMA is
+  only used when the Bus Master IDE Status register reports the device as
+  DMA capable, in the DMA mode already selected in the device. The mode is
+  then set in the device with SET FEATURES.
 
 Arguments:
 
-  Packet         -  The pointer of EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
 
 Returns:
 
-  EFI_STATUS
+  None
 
 --*/
 {
-  UINT8 Index;
-  UINT8 *OpCode;
-  UINT8 ArrayLen;
+  EFI_STATUS                        Status;
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  EFI_IDE_CONTROLLER_INIT_PROTOCOL  *IdeInit;
+  EFI_ATA_COLLECTIVE_MODE           *SupportedModes;
+  EFI_IDENTIFY_DATA                 IdentifyData;
+  UINT16                            *IdentifyWords;
+  UINTN                             Channel;
+  UINT32                            Target;
+  UINT8                             BusMasterStatus;
+  UINT8                             PioMode;
+  UINT8                             DmaMode;
+  UINT16                            Modes;
+
+  PciIo         = AtapiScsiPrivate->PciIo;
+  IdentifyWords = (UINT16 *) &IdentifyData;
+
+  Status = gBS->HandleProtocol (
+                  AtapiScsiPrivate->Handle,
+                  &gEfiIdeControllerInitProtocolGuid,
+                  (VOID **) &IdeInit
+                  );
+  if (EFI_ERROR (Status)) {
+    IdeInit = NULL;
+  }
 
-  OpCode = (UINT8 *) (Packet->Cdb);
-  ArrayLen = (UINT8) (ARRAY_SIZE (gSupportedATAPICommands));
+  for (Target = 0; Target < MAX_TARGET_ID; Target++) {
+    AtapiScsiPrivate->DmaDisabled[Target] = TRUE;
+  }
 
-  for (Index = 0; (Index < ArrayLen) && (CompareMem (&gSupportedATAPICommands[Index], &gEndTable, sizeof (SCSI_COMMAND_SET)) != 0); Index++) {
+  for (Channel = 0; Channel < ATAPI_MAX_CHANNEL; Channel++) {
+    if (AtapiScsiPrivate->BusMasterBaseAddr[Channel] == 0) {
+      continue;
+    }
 
-    if (*OpCode == gSupportedATAPICommands[Index].OpCode) {
-      //
-      // Check whether the requested Command is supported by this driver
-      //
-      if (Packet->DataDirection == DataIn) {
+    AtapiScsiPrivate->IoPort = &AtapiScsiPrivate->AtapiIoPortRegisters[Channel];
+    BusMasterStatus = ReadPortB (
+                        PciIo,
+                        (UINT16) (AtapiScsiPrivate->BusMasterBaseAddr[Channel] + BMIS_OFFSET)
+                        );
+
+    for (Target = 0; Target < 2; Target++) {
+      Status = AtapiIdentifyPacketDevice (AtapiScsiPrivate, Target, &IdentifyData);
+      if (EFI_ERROR (Status) ||
+          ((IdentifyWords[ATAPI_ID_CAPABILITIES] & ATAPI_ID_CAPABILITIES_DMA) == 0)) {
+        continue;
+      }
+
+      PioMode        = 0;
+      DmaMode        = 0;
+      SupportedModes = NULL;
+      if (IdeInit != NULL) {
+        IdeInit->SubmitData (IdeInit, (UINT8) Channel, (UINT8) Target, &IdentifyData);
+        Status = IdeInit->CalculateMode (IdeInit, (UINT8) Channel, (UINT8) Target, &SupportedModes);
+        if (EFI_ERROR (Status)) {
+          continue;
+        }
+
+        if (SupportedModes->PioMode.Valid) {
+          PioMode = (UINT8) (ATA_TRANSFER_MODE_PIO_FLOW | SupportedModes->PioMode.Mode);
+        }
+        if (SupportedModes->UdmaMode.Valid) {
+          DmaMode = (UINT8) (ATA_TRANSFER_MODE_UDMA | SupportedModes->UdmaMode.Mode);
+        } else if (SupportedModes->MultiWordDmaMode.Valid) {
+          DmaMode = (UINT8) (ATA_TRANSFER_MODE_MWDMA | SupportedModes->MultiWordDmaMode.Mode);
+        }
+      } else if ((BusMasterStatus & ((Target == 0) ? BMIS_DRIVE0_DMA_CAPABLE : BMIS_DRIVE1_DMA_CAPABLE)) != 0) {
         //
-        // Check whether the requested data direction conforms to
-        // what it should be.
+        // Keep the mode the platform selected, bits 15:8 of the mode words
         //
-        if (gSupportedATAPICommands[Index].Direction == DataOut) {
-          return FALSE;
+        Modes = 0;
+        if ((IdentifyWords[ATAPI_ID_FIELD_VALIDITY] & ATAPI_ID_FIELD_VALIDITY_UDMA) != 0) {
+          Modes = (UINT16) ((IdentifyWords[ATAPI_ID_UDMA_MODES] >> 8) & 0x7F);
+        }
+        if (Modes != 0) {
+          DmaMode = (UINT8) (ATA_TRANSFER_MODE_UDMA | HighBitSet32 (Modes));
+        } else {
+          Modes = (UINT16) ((IdentifyWords[ATAPI_ID_MWDMA_MODES] >> 8) & 0x07);
+          if (Modes != 0) {
+            DmaMode = (UINT8) (ATA_TRANSFER_MODE_MWDMA | HighBitSet32 (Modes));
+          }
         }
       }
 
-      if (Packet->DataDirection == DataOut) {
-        //
-        // Check whether the requested data direction conforms to
-        // what it should be.
-        //
-        if (gSupportedATAPICommands[Index].Direction == DataIn) {
-          return FALSE;
+      if (DmaMode != 0) {
+        Status = EFI_SUCCESS;
+        if (PioMode != 0) {
+          Status = AtapiSetTransferMode (AtapiScsiPrivate, Target, PioMode);
+        }
+        if (!EFI_ERROR (Status)) {
+          Status = AtapiSetTransferMode (AtapiScsiPrivate, Target, DmaMode);
+        }
+        if (!EFI_ERROR (Status)) {
+          if (SupportedModes != NULL) {
+            IdeInit->SetTiming (IdeInit, (UINT8) Channel, (UINT8) Target, SupportedModes);
+          }
+          AtapiScsiPrivate->DmaDisabled[Channel * 2 + Target] = FALSE;
         }
       }
 
-      return TRUE;
+      if (SupportedModes != NULL) {
+        gBS->FreePool (SupportedModes);
+      }
+
+      DEBUG ((
+        EFI_D_INFO,
+        "InitAtapiDeviceDma()-- Target %d : transfer mode 0x%x, DMA %a\n",
+        Channel * 2 + Target,
+        DmaMode,
+        AtapiScsiPrivate->DmaDisabled[Channel * 2 + Target] ? "disabled" : "enabled"
+        ));
     }
   }
 
-  return FALSE;
+  AtapiScsiPrivate->IoPort = NULL;
 }
 
 EFI_STATUS
-SubmitBlockingIoCommand (
-  ATAPI_SCSI_PASS_THRU_DEV                  *AtapiScsiPrivate,
-  UINT32                                    Target,
-  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet
+AtapiIdentifyPacketDevice (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  EFI_IDENTIFY_DATA           *IdentifyData
   )
 /*++
 
 Routine Description:
 
-  Performs blocking I/O request.
+  Send IDENTIFY PACKET DEVICE to a device on the current channel.
 
 Arguments:
 
   AtapiScsiPrivate:   Private data structure for the specified channel.
-  Target:             The Target ID of the ATAPI device to send the SCSI
-                      Request Packet. To ATAPI devices attached on an IDE
-                      Channel, Target ID 0 indicates Master device;Target
-                      ID 1 indicates Slave device.
-  Packet:             The SCSI Request Packet to send to the ATAPI device
-                      specified by Target.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  IdentifyData:       Receives the 256 words of IDENTIFY PACKET DEVICE data.
 
-  Returns:            EFI_STATUS
+Returns:
+
+  EFI_SUCCESS         - A PACKET device returned its identify data.
+  EFI_NOT_FOUND       - There is no PACKET device at this position.
+  Others              - The command failed.
 
 --*/
 {
-  UINT8       PacketCommand[12];
-  UINT64      TimeoutInMicroSeconds;
-  EFI_STATUS  PacketCommandStatus;
+  EFI_STATUS  Status;
+  UINT8       StatusRegister;
+  UINT16      *IdentifyWords;
 
-  //
-  // Fill ATAPI Command Packet according to CDB
-  //
-  ZeroMem (&PacketCommand, 12);
-  CopyMem (&PacketCommand, Packet->Cdb, Packet->CdbLength);
+  Status = StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-  //
-  // Timeout is 100ns unit, convert it to 1000ns (1us) unit.
-  //
-  TimeoutInMicroSeconds = DivU64x32 (Packet->Timeout, (UINT32) 10);
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Head,
+    (UINT8) ((Target << 4) | DEFAULT_CMD)
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
+    DEFAULT_CTL
+    );
 
   //
-  // Submit ATAPI Command Packet
+  // A floating bus or an empty device position
   //
-  PacketCommandStatus = AtapiPacketCommand (
-                          AtapiScsiPrivate,
-                          Target,
-                          PacketCommand,
-                          Packet->DataBuffer,
-                          &(Packet->TransferLength),
-                          (DATA_DIRECTION) Packet->DataDirection,
-                          TimeoutInMicroSeconds
-                          );
-  if (!EFI_ERROR (PacketCommandStatus) || (Packet->SenseData == NULL)) {
-    Packet->SenseDataLength = 0;
-    return PacketCommandStatus;
+  StatusRegister = ReadPortB (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Reg.Status);
+  if ((StatusRegister == 0xFF) || (StatusRegister == 0x7F)) {
+    return EFI_NOT_FOUND;
   }
 
-  //
-  // Return SenseData if PacketCommandStatus matches
-  // the following return codes.
-  //
-  if ((PacketCommandStatus ==  EFI_BAD_BUFFER_SIZE) ||
-      (PacketCommandStatus == EFI_DEVICE_ERROR) ||
-      (PacketCommandStatus == EFI_TIMEOUT)) {
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Reg.Command,
+    ATA_CMD_IDENTIFY_PACKET_DEVICE
+    );
 
-    //
-    // avoid submit request sense command continuously.
-    //
-    if (PacketCommand[0] == OP_REQUEST_SENSE) {
-      Packet->SenseDataLength = 0;
-      return PacketCommandStatus;
-    }
+  Status = StatusDRQReady (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return (Status == EFI_ABORTED) ? EFI_NOT_FOUND : Status;
+  }
 
-    RequestSenseCommand (
-      AtapiScsiPrivate,
+  IdentifyWords = (UINT16 *) IdentifyData;
+  ReadPortWMultiple (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Data,
+    sizeof (EFI_IDENTIFY_DATA) / sizeof (UINT16),
+    IdentifyWords
+    );
+
+  Status = StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((IdentifyWords[ATAPI_ID_GENERAL_CONFIG] & ATAPI_ID_PACKET_DEVICE_MASK) != ATAPI_ID_PACKET_DEVICE) {
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+AtapiSetTransferMode (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  UINT8                       TransferMode
+  )
+/*++
+
+Routine Description:
+
+  Select a transfer mode in a device on the current channel with the SET
+  FEATURES command.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  TransferMode:       Transfer mode type in bits 7:3, mode number in
+                      bits 2:0.
+
+Returns:
+
+  EFI_SUCCESS         - The device accepted the transfer mode.
+  EFI_DEVICE_ERROR    - The device rejected the transfer mode.
+  EFI_TIMEOUT         - The device did not complete the command.
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINT8       StatusRegister;
+
+  Status = StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Head,
+    (UINT8) ((Target << 4) | DEFAULT_CMD)
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Reg1.Feature,
+    ATA_SUB_CMD_SET_TRANSFER_MODE
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->SectorCount,
+    TransferMode
+    );
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Reg.Command,
+    ATA_CMD_SET_FEATURES
+    );
+
+  Status = StatusWaitForBSYClear (AtapiScsiPrivate, ATAPI_IDENTIFY_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  StatusRegister = ReadPortB (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Reg.Status);
+  if ((StatusRegister & (ERR | DWF)) != 0) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+VOID
+FreeAtapiBusMaster (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Release the PRD tables set up by InitAtapiBusMaster().
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+
+  if (AtapiScsiPrivate->PrdTable == NULL) {
+    return;
+  }
+
+  PciIo = AtapiScsiPrivate->PciIo;
+  PciIo->Unmap (PciIo, AtapiScsiPrivate->PrdTableMapping);
+  PciIo->FreeBuffer (PciIo, ATAPI_PRD_TABLE_PAGES, AtapiScsiPrivate->PrdTable);
+
+  AtapiScsiPrivate->PrdTable                        = NULL;
+  AtapiScsiPrivate->BusMasterBaseAddr[IdePrimary]   = 0;
+  AtapiScsiPrivate->BusMasterBaseAddr[IdeSecondary] = 0;
+}
+
+
+EFI_STATUS
+CheckSCSIRequestPacket (
+  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET      *Packet
+  )
+/*++
+
+Routine Description:
+
+  Checks the parameters in the SCSI Request Packet to make sure
+  they are valid for a SCSI Pass Thru request.
+
+Arguments:
+
+  Packet         -  The pointer of EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+{
+  if (Packet == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!ValidCdbLength (Packet->CdbLength)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Packet->Cdb == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Checks whether the request command is supported.
+  //
+  if (!IsCommandValid (Packet)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+BOOLEAN
+IsCommandValid (
+  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET   *Packet
+  )
+/*++
+
+Routine Description:
+
+  Checks the requested SCSI command:
+  Is it supported by this driver?
+  Is the Data transfer direction reasonable?
+
+Arguments:
+
+  Packet         -  The pointer of EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+{
+  UINT8 Index;
+  UINT8 *OpCode;
+  UINT8 ArrayLen;
+
+  OpCode = (UINT8 *) (Packet->Cdb);
+  ArrayLen = (UINT8) (ARRAY_SIZE (gSupportedATAPICommands));
+
+  for (Index = 0; (Index < ArrayLen) && (CompareMem (&gSupportedATAPICommands[Index], &gEndTable, sizeof (SCSI_COMMAND_SET)) != 0); Index++) {
+
+    if (*OpCode == gSupportedATAPICommands[Index].OpCode) {
+      //
+      // Check whether the requested Command is supported by this driver
+      //
+      if (Packet->DataDirection == DataIn) {
+        //
+        // Check whether the requested data direction conforms to
+        // what it should be.
+        //
+        if (gSupportedATAPICommands[Index].Direction == DataOut) {
+          return FALSE;
+        }
+      }
+
+      if (Packet->DataDirection == DataOut) {
+        //
+        // Check whether the requested data direction conforms to
+        // what it should be.
+        //
+        if (gSupportedATAPICommands[Index].Direction == DataIn) {
+          return FALSE;
+        }
+      }
+
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+EFI_STATUS
+SubmitBlockingIoCommand (
+  ATAPI_SCSI_PASS_THRU_DEV                  *AtapiScsiPrivate,
+  UINT32                                    Target,
+  EFI_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet
+  )
+/*++
+
+Routine Description:
+
+  Performs blocking I/O request.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             The Target ID of the ATAPI device to send the SCSI
+                      Request Packet. To ATAPI devices attached on an IDE
+                      Channel, Target ID 0 indicates Master device;Target
+                      ID 1 indicates Slave device.
+  Packet:             The SCSI Request Packet to send to the ATAPI device
+                      specified by Target.
+
+  Returns:            EFI_STATUS
+
+--*/
+{
+  UINT8       PacketCommand[12];
+  UINT64      TimeoutInMicroSeconds;
+  EFI_STATUS  PacketCommandStatus;
+
+  //
+  // Fill ATAPI Command Packet according to CDB
+  //
+  ZeroMem (&PacketCommand, 12);
+  CopyMem (&PacketCommand, Packet->Cdb, Packet->CdbLength);
+
+  //
+  // Timeout is 100ns unit, convert it to 1000ns (1us) unit.
+  //
+  TimeoutInMicroSeconds = DivU64x32 (Packet->Timeout, (UINT32) 10);
+
+  //
+  // Submit ATAPI Command Packet
+  //
+  PacketCommandStatus = AtapiPacketCommand (
+                          AtapiScsiPrivate,
+                          Target,
+                          PacketCommand,
+                          Packet->DataBuffer,
+                          &(Packet->TransferLength),
+                          (DATA_DIRECTION) Packet->DataDirection,
+                          TimeoutInMicroSeconds
+                          );
+  if (!EFI_ERROR (PacketCommandStatus) || (Packet->SenseData == NULL)) {
+    Packet->SenseDataLength = 0;
+    return PacketCommandStatus;
+  }
+
+  //
+  // Return SenseData if PacketCommandStatus matches
+  // the following return codes.
+  //
+  if ((PacketCommandStatus ==  EFI_BAD_BUFFER_SIZE) ||
+      (PacketCommandStatus == EFI_DEVICE_ERROR) ||
+      (PacketCommandStatus == EFI_TIMEOUT)) {
+
+    //
+    // avoid submit request sense command continuously.
+    //
+    if (PacketCommand[0] == OP_REQUEST_SENSE) {
+      Packet->SenseDataLength = 0;
+      return PacketCommandStatus;
+    }
+
+    RequestSenseCommand (
+      AtapiScsiPrivate,
       Target,
       Packet->Timeout,
       Packet->SenseData,
@@ -2170,7 +2528,96 @@ Returns:
 
 --*/
 {
+  UINTN       Channel;
+  EFI_STATUS  Status;
+
+  //
+  // Read type commands move their data with bus master DMA when the
+  // channel supports it. EFI_UNSUPPORTED means nothing was transferred
+  // and the command is sent again with PIO.
+  //
+  Channel = (UINTN) (AtapiScsiPrivate->IoPort - AtapiScsiPrivate->AtapiIoPortRegisters);
+  if ((Direction == DataIn) &&
+      ((PacketCommand[0] == OP_READ_10) || (PacketCommand[0] == OP_READ_12)) &&
+      (AtapiScsiPrivate->BusMasterBaseAddr[Channel] != 0) &&
+      !AtapiScsiPrivate->DmaDisabled[Channel * 2 + Target]) {
+    Status = AtapiPassThruDmaRead (
+               AtapiScsiPrivate,
+               Target,
+               PacketCommand,
+               Buffer,
+               ByteCount,
+               TimeoutInMicroSeconds
+               );
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
+  //
+  // No OVL; No DMA (by setting feature register)
+  //
+  Status = AtapiIssuePacketCommand (
+             AtapiScsiPrivate,
+             Target,
+             PacketCommand,
+             0x00,
+             TimeoutInMicroSeconds
+             );
+  if (EFI_ERROR (Status)) {
+    if (Status == EFI_ABORTED) {
+      Status = EFI_DEVICE_ERROR;
+    }
+
+    *ByteCount = 0;
+    return Status;
+  }
+
+  //
+  // call AtapiPassThruPioReadWriteData() function to get
+  // requested transfer data form device.
+  //
+  return AtapiPassThruPioReadWriteData (
+          AtapiScsiPrivate,
+          Buffer,
+          ByteCount,
+          Direction,
+          TimeoutInMicroSeconds
+          );
+}
+
+EFI_STATUS
+AtapiIssuePacketCommand (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  UINT8                       *PacketCommand,
+  UINT8                       Feature,
+  UINT64                      TimeoutInMicroSeconds
+  )
+/*++
+
+Routine Description:
+
+  Selects the device, issues the PACKET command and sends the command
+  packet. The data phase is left to the caller.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  PacketCommand:      Points to the ATAPI command packet.
+  Feature:            Value for the Feature Register, DMA selects a DMA
+                      data transfer.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, for each wait.
+
+Returns:
+
+  EFI_STATUS
 
+--*/
+{
   UINT16      *CommandIndex;
   UINT8       Count;
   EFI_STATUS  Status;
@@ -2200,22 +2647,14 @@ Returns:
   // Before write to all the following registers, BSY DRQ must be 0.
   //
   Status =  StatusDRQClear(AtapiScsiPrivate,  TimeoutInMicroSeconds);
-
   if (EFI_ERROR (Status)) {
-    if (Status == EFI_ABORTED) {
-      Status = EFI_DEVICE_ERROR;
-    }
-    *ByteCount = 0;
     return Status;
   }
 
-  //
-  // No OVL; No DMA (by setting feature register)
-  //
   WritePortB (
     AtapiScsiPrivate->PciIo,
     AtapiScsiPrivate->IoPort->Reg1.Feature,
-    0x00
+    Feature
     );
 
   //
@@ -2233,60 +2672,291 @@ Returns:
     (UINT8) (MAX_ATAPI_BYTE_COUNT >> 8)
     );
 
-  //
-  //  DEFAULT_CTL:0x0a (0000,1010)
-  //  Disable interrupt
-  //
-  WritePortB (
-    AtapiScsiPrivate->PciIo,
-    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
-    DEFAULT_CTL
-    );
+  //
+  //  DEFAULT_CTL:0x0a (0000,1010)
+  //  Disable interrupt. A DMA transfer keeps it enabled, the end of the
+  //  command is then seen in the Bus Master IDE Status register.
+  //
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Alt.DeviceControl,
+    (UINT8) (((Feature & DMA) != 0) ? (DEFAULT_CTL & ~IEN_L) : DEFAULT_CTL)
+    );
+
+  //
+  // Send Packet command to inform device
+  // that the following data bytes are command packet.
+  //
+  WritePortB (
+    AtapiScsiPrivate->PciIo,
+    AtapiScsiPrivate->IoPort->Reg.Command,
+    PACKET_CMD
+    );
+
+  //
+  // Before data transfer, BSY should be 0 and DRQ should be 1.
+  // if they are not in specified time frame,
+  // retrieve Sense Key from Error Register before return.
+  //
+  Status = StatusDRQReady (AtapiScsiPrivate, TimeoutInMicroSeconds);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Send out command packet
+  //
+  CommandIndex = (UINT16 *) PacketCommand;
+  for (Count = 0; Count < 6; Count++, CommandIndex++) {
+    WritePortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, *CommandIndex);
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+EFI_STATUS
+AtapiPassThruDmaRead (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  UINT8                       *PacketCommand,
+  VOID                        *Buffer,
+  UINT32                      *ByteCount,
+  UINT64                      TimeoutInMicroSeconds
+  )
+/*++
+
+Routine Description:
+
+  Submits a read type ATAPI command packet and moves its data with bus
+  master DMA.
+
+  A device that rejects the DMA transfer, or a bus master error, disables
+  DMA for the target so that later commands go straight to PIO.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  PacketCommand:      Points to the ATAPI command packet.
+  Buffer:             Points to the transferred data.
+  ByteCount:          When input,indicates the buffer size; when output,
+                      indicates the actually transferred data size.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, to use for the
+                      execution of this ATAPI command.
+
+Returns:
+
+  EFI_UNSUPPORTED     - DMA could not be used for this request and nothing
+                        was transferred; the caller should fall back to PIO.
+  Others              - The status of the command.
+
+--*/
+{
+  EFI_STATUS            Status;
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  UINTN                 Channel;
+  UINTN                 DmaTarget;
+  UINT16                BusMasterBaseAddr;
+  ATAPI_PRD             *PrdTable;
+  UINTN                 PrdIndex;
+  UINTN                 MappedBytes;
+  EFI_PHYSICAL_ADDRESS  DeviceAddress;
+  VOID                  *Mapping;
+  UINT32                RegionBase;
+  UINT32                RegionLength;
+  UINT32                Remaining;
+  UINT8                 BusMasterStatus;
+  UINT8                 ErrorRegister;
+  UINT64                Delay;
+
+  PciIo             = AtapiScsiPrivate->PciIo;
+  Channel           = (UINTN) (AtapiScsiPrivate->IoPort - AtapiScsiPrivate->AtapiIoPortRegisters);
+  DmaTarget         = Channel * 2 + Target;
+  BusMasterBaseAddr = AtapiScsiPrivate->BusMasterBaseAddr[Channel];
+  PrdTable          = AtapiScsiPrivate->PrdTable + Channel * ATAPI_PRD_CHANNEL_ENTRIES;
+
+  //
+  // PRD regions are word aligned and a whole number of words long.
+  //
+  if ((Buffer == NULL) || (*ByteCount == 0) ||
+      ((*ByteCount & BIT0) != 0) || (((UINTN) Buffer & BIT0) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  MappedBytes = *ByteCount;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterWrite,
+                    Buffer,
+                    &MappedBytes,
+                    &DeviceAddress,
+                    &Mapping
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((MappedBytes != *ByteCount) ||
+      ((DeviceAddress + MappedBytes) > BIT32) ||
+      ((DeviceAddress & BIT0) != 0)) {
+    PciIo->Unmap (PciIo, Mapping);
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Split the buffer into regions that do not cross a 64K boundary.
+  //
+  RegionBase = (UINT32) DeviceAddress;
+  Remaining  = *ByteCount;
+  for (PrdIndex = 0; Remaining != 0; PrdIndex++) {
+    if (PrdIndex == ATAPI_PRD_CHANNEL_ENTRIES) {
+      PciIo->Unmap (PciIo, Mapping);
+      return EFI_UNSUPPORTED;
+    }
+
+    RegionLength = ATAPI_PRD_MAX_REGION - (RegionBase & (ATAPI_PRD_MAX_REGION - 1));
+    if (RegionLength > Remaining) {
+      RegionLength = Remaining;
+    }
+
+    PrdTable[PrdIndex].RegionBaseAddr = RegionBase;
+    PrdTable[PrdIndex].ByteCount      = (UINT16) RegionLength;
+    PrdTable[PrdIndex].EndOfTable     = 0;
+
+    RegionBase += RegionLength;
+    Remaining  -= RegionLength;
+  }
+
+  PrdTable[PrdIndex - 1].EndOfTable = PRD_EOT;
+
+  //
+  // Stop the engine, clear the interrupt and error bits, point it at the
+  // PRD table and set the direction to device-to-memory.
+  //
+  WritePortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIC_OFFSET), 0);
+  BusMasterStatus = ReadPortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIS_OFFSET));
+  WritePortB (
+    PciIo,
+    (UINT16) (BusMasterBaseAddr + BMIS_OFFSET),
+    (UINT8) (BusMasterStatus | BMIS_INTERRUPT | BMIS_ERROR)
+    );
+  WritePortDW (
+    PciIo,
+    (UINT16) (BusMasterBaseAddr + BMIDTP_OFFSET),
+    (UINT32) (AtapiScsiPrivate->PrdTableDeviceAddr + Channel * ATAPI_PRD_CHANNEL_ENTRIES * sizeof (ATAPI_PRD))
+    );
+  WritePortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIC_OFFSET), BMIC_NREAD);
+  MemoryFence ();
+
+  Status = AtapiIssuePacketCommand (
+             AtapiScsiPrivate,
+             Target,
+             PacketCommand,
+             DMA,
+             TimeoutInMicroSeconds
+             );
+  if (EFI_ERROR (Status)) {
+    WritePortB (PciIo, AtapiScsiPrivate->IoPort->Alt.DeviceControl, DEFAULT_CTL);
+    PciIo->Unmap (PciIo, Mapping);
+    if (Status == EFI_ABORTED) {
+      //
+      // The device does not accept a DMA data transfer
+      //
+      AtapiScsiPrivate->DmaDisabled[DmaTarget] = TRUE;
+      return EFI_UNSUPPORTED;
+    }
+
+    *ByteCount = 0;
+    return Status;
+  }
+
+  WritePortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIC_OFFSET), BMIC_NREAD | BMIC_START);
+
+  //
+  // The interrupt bit is set once the device has ended the command and the
+  // controller has flushed the data to memory.
+  //
+  if (TimeoutInMicroSeconds == 0) {
+    Delay = 2;
+  } else {
+    Delay = DivU64x32 (TimeoutInMicroSeconds, (UINT32) 30) + 1;
+  }
+
+  do {
+    BusMasterStatus = ReadPortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIS_OFFSET));
+    if ((BusMasterStatus & (BMIS_INTERRUPT | BMIS_ERROR)) != 0) {
+      break;
+    }
+
+    //
+    // Stall for 30 us
+    //
+    gBS->Stall (30);
+    //
+    // Loop infinitely if not meeting expected condition
+    //
+    if (TimeoutInMicroSeconds == 0) {
+      Delay = 2;
+    }
+
+    Delay--;
+  } while (Delay);
 
-  //
-  // Send Packet command to inform device
-  // that the following data bytes are command packet.
-  //
+  WritePortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIC_OFFSET), BMIC_NREAD);
   WritePortB (
-    AtapiScsiPrivate->PciIo,
-    AtapiScsiPrivate->IoPort->Reg.Command,
-    PACKET_CMD
+    PciIo,
+    (UINT16) (BusMasterBaseAddr + BMIS_OFFSET),
+    (UINT8) (ReadPortB (PciIo, (UINT16) (BusMasterBaseAddr + BMIS_OFFSET)) | BMIS_INTERRUPT | BMIS_ERROR)
     );
+  WritePortB (PciIo, AtapiScsiPrivate->IoPort->Alt.DeviceControl, DEFAULT_CTL);
+  PciIo->Unmap (PciIo, Mapping);
+
+  if (Delay == 0) {
+    DEBUG ((EFI_D_BLKIO, "AtapiPassThruDmaRead()-- Target %d : DMA timeout, use PIO\n", DmaTarget));
+    AtapiScsiPrivate->DmaDisabled[DmaTarget] = TRUE;
+    *ByteCount = 0;
+
+    //
+    // The device may still be in the middle of the command with BSY or DRQ
+    // set, reset it so that the next command can be issued.
+    //
+    AtapiPassThruResetChannels (AtapiScsiPrivate);
+    return EFI_TIMEOUT;
+  }
 
   //
-  // Before data transfer, BSY should be 0 and DRQ should be 1.
-  // if they are not in specified time frame,
-  // retrieve Sense Key from Error Register before return.
+  // Reading the Status Register also clears the device interrupt.
   //
-  Status = StatusDRQReady (AtapiScsiPrivate, TimeoutInMicroSeconds);
+  if (EFI_ERROR (StatusWaitForBSYClear (AtapiScsiPrivate, TimeoutInMicroSeconds))) {
+    *ByteCount = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((BusMasterStatus & BMIS_ERROR) != 0) {
+    DEBUG ((EFI_D_BLKIO, "AtapiPassThruDmaRead()-- Target %d : bus master error, use PIO\n", DmaTarget));
+    AtapiScsiPrivate->DmaDisabled[DmaTarget] = TRUE;
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = AtapiPassThruCheckErrorStatus (AtapiScsiPrivate);
   if (EFI_ERROR (Status)) {
-    if (Status == EFI_ABORTED) {
-      Status = EFI_DEVICE_ERROR;
+    //
+    // An abort without a sense key is the device refusing the DMA transfer
+    // rather than the command failing.
+    //
+    ErrorRegister = ReadPortB (PciIo, AtapiScsiPrivate->IoPort->Reg1.Error);
+    if (((ErrorRegister & ABRT_ERR) != 0) && ((ErrorRegister & SENSE_KEY_ERR) == 0)) {
+      AtapiScsiPrivate->DmaDisabled[DmaTarget] = TRUE;
+      return EFI_UNSUPPORTED;
     }
 
     *ByteCount = 0;
-    return Status;
-  }
-
-  //
-  // Send out command packet
-  //
-  CommandIndex = (UINT16 *) PacketCommand;
-  for (Count = 0; Count < 6; Count++, CommandIndex++) {
-    WritePortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, *CommandIndex);
   }
 
-  //
-  // call AtapiPassThruPioReadWriteData() function to get
-  // requested transfer data form device.
-  //
-  return AtapiPassThruPioReadWriteData (
-          AtapiScsiPrivate,
-          Buffer,
-          ByteCount,
-          Direction,
-          TimeoutInMicroSeconds
-          );
+  return Status;
 }
 
 EFI_STATUS
@@ -2327,7 +2997,6 @@ Arguments:
 
 --*/
 {
-  UINT32      Index;
   UINT32      RequiredWordCount;
   UINT32      ActualWordCount;
   UINT32      WordCount;
@@ -2385,20 +3054,17 @@ Arguments:
 
     //
     // perform a series data In/Out.
+    // The whole DRQ block is moved with one string I/O access.
     //
-    for (Index = 0; (Index < WordCount) && (ActualWordCount < RequiredWordCount); Index++, ActualWordCount++) {
-
-      if (Direction == DataIn) {
-
-        *ptrBuffer = ReadPortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data);
-      } else {
-
-        WritePortW (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, *ptrBuffer);
-      }
-
-      ptrBuffer++;
-
+    WordCount = MIN (WordCount, RequiredWordCount - ActualWordCount);
+    if (Direction == DataIn) {
+      ReadPortWMultiple (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, WordCount, ptrBuffer);
+    } else {
+      WritePortWMultiple (AtapiScsiPrivate->PciIo, AtapiScsiPrivate->IoPort->Data, WordCount, ptrBuffer);
     }
+
+    ptrBuffer       += WordCount;
+    ActualWordCount += WordCount;
   }
   //
   // After data transfer is completed, normally, DRQ bit should clear.
@@ -2558,6 +3224,112 @@ Returns:
               );
 }
 
+VOID
+WritePortDW (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINT32                Data
+  )
+/*++
+
+Routine Description:
+
+  Write one dword to a specified I/O port.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Data       - The data to write
+
+Returns:
+
+   NONE
+
+--*/
+{
+  PciIo->Io.Write (
+              PciIo,
+              EfiPciIoWidthUint32,
+              EFI_PCI_IO_PASS_THROUGH_BAR,
+              (UINT64) Port,
+              1,
+              &Data
+              );
+}
+
+VOID
+ReadPortWMultiple (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINTN                 Count,
+  OUT UINT16                *Buffer
+  )
+/*++
+
+Routine Description:
+
+  Read Count words from a specified I/O port with one string I/O access.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Count      - Number of words to read
+  Buffer     - Receives the words read out
+
+Returns:
+
+   NONE
+
+--*/
+{
+  PciIo->Io.Read (
+              PciIo,
+              EfiPciIoWidthFifoUint16,
+              EFI_PCI_IO_PASS_THROUGH_BAR,
+              (UINT64) Port,
+              Count,
+              Buffer
+              );
+}
+
+VOID
+WritePortWMultiple (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINTN                 Count,
+  IN  UINT16                *Buffer
+  )
+/*++
+
+Routine Description:
+
+  Write Count words to a specified I/O port with one string I/O access.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Count      - Number of words to write
+  Buffer     - The words to write
+
+Returns:
+
+   NONE
+
+--*/
+{
+  PciIo->Io.Write (
+              PciIo,
+              EfiPciIoWidthFifoUint16,
+              EFI_PCI_IO_PASS_THROUGH_BAR,
+              (UINT64) Port,
+              Count,
+              Buffer
+              );
+}
+
 EFI_STATUS
 StatusDRQClear (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate,
@@ -3183,6 +3955,228 @@ Returns:
   return EFI_SUCCESS;
 }
 
+EFI_STATUS
+WaitForChannelsReady (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT8                       ChannelMask,
+  UINT8                       *ResetMask
+  )
+/*++
+
+Routine Description:
+
+  Poll the selected device on every channel in ChannelMask until it is ready
+  after a reset. All channels are polled in the same loop, so their reset
+  times overlap instead of adding up.
+
+  A channel is reset once BSY clears, which must happen within
+  ATAPI_RESET_BSY_TIMEOUT. It is ready once BSY and DRQ are clear and DRDY
+  is set, with the same status read ATAPI_READY_STABLE_COUNT times in a row.
+  A PACKET device leaves DRDY clear after a reset, so DRDY is not required
+  when the Cylinder registers hold the ATAPI signature. A channel that has
+  not become ready ATAPI_RESET_READY_TIMEOUT after clearing BSY is given up
+  on. A Status Register reading 0xFF means nothing is attached, and so does
+  a reading of 0x00 or 0x7F once BSY is clear if neither the ATA nor the
+  ATAPI signature is present.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+  ChannelMask                 - Bit N set polls AtapiIoPortRegisters[N]
+  ResetMask                   - Returns the channels on which BSY cleared
+
+Returns:
+
+  EFI_SUCCESS                 - Every channel with a device became ready.
+  EFI_TIMEOUT                 - At least one channel did not become ready.
+
+--*/
+{
+  IDE_BASE_REGISTERS  *IoPort;
+  UINT8               Pending;
+  UINT8               Index;
+  UINT8               Bit;
+  UINT8               StatusRegister;
+  UINT8               CylinderLsb;
+  UINT8               CylinderMsb;
+  BOOLEAN             AtaDevice;
+  UINT8               LastStatus[ATAPI_MAX_CHANNEL];
+  UINT8               StableCount[ATAPI_MAX_CHANNEL];
+  BOOLEAN             PacketDevice[ATAPI_MAX_CHANNEL];
+  UINT64              BsyClearTime[ATAPI_MAX_CHANNEL];
+  UINT64              Elapsed;
+  EFI_STATUS          Status;
+
+  Status     = EFI_SUCCESS;
+  Pending    = (UINT8) (ChannelMask & ((1 << ATAPI_MAX_CHANNEL) - 1));
+  Elapsed    = 0;
+  *ResetMask = 0;
+  ZeroMem (LastStatus, sizeof (LastStatus));
+  ZeroMem (StableCount, sizeof (StableCount));
+  ZeroMem (PacketDevice, sizeof (PacketDevice));
+  ZeroMem (BsyClearTime, sizeof (BsyClearTime));
+
+  while (Pending != 0) {
+    for (Index = 0; Index < ATAPI_MAX_CHANNEL; Index++) {
+      Bit = (UINT8) (1 << Index);
+      if ((Pending & Bit) == 0) {
+        continue;
+      }
+
+      IoPort         = &AtapiScsiPrivate->AtapiIoPortRegisters[Index];
+      StatusRegister = ReadPortB (AtapiScsiPrivate->PciIo, IoPort->Reg.Status);
+
+      if ((*ResetMask & Bit) == 0) {
+        if (StatusRegister == 0xFF) {
+          //
+          // Floating bus, no device on this channel
+          //
+          Pending &= (UINT8) ~Bit;
+          continue;
+        }
+
+        if ((StatusRegister & BSY) != 0) {
+          if (Elapsed >= ATAPI_RESET_BSY_TIMEOUT) {
+            Status   = EFI_TIMEOUT;
+            Pending &= (UINT8) ~Bit;
+          }
+          continue;
+        }
+
+        //
+        // BSY cleared: the reset is done and the signature is valid
+        //
+        *ResetMask          |= Bit;
+        BsyClearTime[Index]  = Elapsed;
+        CylinderLsb          = ReadPortB (AtapiScsiPrivate->PciIo, IoPort->CylinderLsb);
+        CylinderMsb          = ReadPortB (AtapiScsiPrivate->PciIo, IoPort->CylinderMsb);
+        PacketDevice[Index]  = (BOOLEAN) (
+                                 (CylinderLsb == ATAPI_SIGNATURE_CYLINDER_LSB) &&
+                                 (CylinderMsb == ATAPI_SIGNATURE_CYLINDER_MSB)
+                                 );
+        AtaDevice            = (BOOLEAN) (
+                                 (CylinderLsb == 0) && (CylinderMsb == 0) &&
+                                 (ReadPortB (AtapiScsiPrivate->PciIo, IoPort->SectorCount) == ATA_SIGNATURE_SECTOR_COUNT) &&
+                                 (ReadPortB (AtapiScsiPrivate->PciIo, IoPort->SectorNumber) == ATA_SIGNATURE_SECTOR_NUMBER)
+                                 );
+
+        //
+        // An empty device position reads 0x00 or 0x7F and never sets DRDY
+        //
+        if (((StatusRegister == 0x00) || (StatusRegister == 0x7F)) &&
+            !PacketDevice[Index] && !AtaDevice) {
+          Pending &= (UINT8) ~Bit;
+          continue;
+        }
+      }
+
+      if (((StatusRegister & (BSY | DRQ)) == 0) &&
+          (PacketDevice[Index] || ((StatusRegister & DRDY) != 0))) {
+        if ((StableCount[Index] != 0) && (StatusRegister == LastStatus[Index])) {
+          StableCount[Index]++;
+        } else {
+          StableCount[Index] = 1;
+        }
+
+        LastStatus[Index] = StatusRegister;
+        if (StableCount[Index] >= ATAPI_READY_STABLE_COUNT) {
+          Pending &= (UINT8) ~Bit;
+          continue;
+        }
+      } else {
+        StableCount[Index] = 0;
+      }
+
+      if ((Elapsed - BsyClearTime[Index]) >= ATAPI_RESET_READY_TIMEOUT) {
+        Status   = EFI_TIMEOUT;
+        Pending &= (UINT8) ~Bit;
+      }
+    }
+
+    if (Pending == 0) {
+      break;
+    }
+
+    gBS->Stall (ATAPI_RESET_POLL_INTERVAL);
+    Elapsed += ATAPI_RESET_POLL_INTERVAL;
+  }
+
+  return Status;
+}
+
+EFI_STATUS
+AtapiPassThruResetChannels (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Soft reset both the Primary channel and the Secondary channel and wait
+  for the devices on them to become ready.
+
+  SRST is pulsed on both channels first and both are then polled together,
+  so the worst case is one channel's reset time rather than the sum.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  EFI_SUCCESS                 - At least one channel was reset.
+  EFI_TIMEOUT                 - No channel cleared BSY.
+
+--*/
+{
+  UINT8   DeviceControlValue;
+  UINT8   Index;
+  UINT8   ResetMask;
+
+  //
+  // set SRST bit to initiate soft reset, with Interrupt disabled
+  //
+  DeviceControlValue = SRST | IEN_L;
+  for (Index = 0; Index < ATAPI_MAX_CHANNEL; Index++) {
+    WritePortB (
+      AtapiScsiPrivate->PciIo,
+      AtapiScsiPrivate->AtapiIoPortRegisters[Index].Alt.DeviceControl,
+      DeviceControlValue
+      );
+  }
+
+  //
+  // Wait 10us
+  //
+  gBS->Stall (10);
+
+  //
+  // Clear SRST bit
+  //
+  DeviceControlValue &= (UINT8) ~SRST;
+  for (Index = 0; Index < ATAPI_MAX_CHANNEL; Index++) {
+    WritePortB (
+      AtapiScsiPrivate->PciIo,
+      AtapiScsiPrivate->AtapiIoPortRegisters[Index].Alt.DeviceControl,
+      DeviceControlValue
+      );
+  }
+
+  //
+  // If there is a channel reset successfully, return EFI_SUCCESS.
+  //
+  WaitForChannelsReady (
+    AtapiScsiPrivate,
+    (UINT8) ((1 << ATAPI_MAX_CHANNEL) - 1),
+    &ResetMask
+    );
+  if (ResetMask != 0) {
+    return EFI_SUCCESS;
+  }
+
+  return EFI_TIMEOUT;
+}
+
 EFI_STATUS
 AtapiPassThruCheckErrorStatus (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate
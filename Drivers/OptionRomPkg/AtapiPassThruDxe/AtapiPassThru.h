@@ -17,6 +17,7 @@
 #include <Protocol/ScsiPassThruExt.h>
 #include <Protocol/PciIo.h>
 #include <Protocol/DriverSupportedEfiVersion.h>
+#include <Protocol/IdeControllerInit.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -68,10 +69,45 @@ typedef enum {
 #define IDE_PRIMARY_PROGRAMMABLE_INDICATOR    BIT1
 #define IDE_SECONDARY_OPERATING_MODE          BIT2
 #define IDE_SECONDARY_PROGRAMMABLE_INDICATOR  BIT3
+#define IDE_BUS_MASTER_CAPABLE                BIT7
 
 
 #define ATAPI_MAX_CHANNEL 2
 
+//
+// Bus Master IDE registers. BAR4 holds the base of the Primary channel's
+// set, the Secondary channel's set follows at BMIDE_SECONDARY_OFFSET.
+//
+#define BMIC_OFFSET             0x00  ///< Bus Master IDE Command
+#define BMIS_OFFSET             0x02  ///< Bus Master IDE Status
+#define BMIDTP_OFFSET           0x04  ///< Bus Master IDE Descriptor Table Pointer
+#define BMIDE_SECONDARY_OFFSET  0x08
+
+#define BMIC_START      BIT0
+#define BMIC_NREAD      BIT3  ///< bus master writes system memory, device to host
+#define BMIS_ACTIVE     BIT0
+#define BMIS_ERROR      BIT1
+#define BMIS_INTERRUPT  BIT2
+#define BMIS_DRIVE0_DMA_CAPABLE  BIT5  ///< set by the platform once the device 0 timing is programmed
+#define BMIS_DRIVE1_DMA_CAPABLE  BIT6  ///< set by the platform once the device 1 timing is programmed
+
+///
+/// Physical Region Descriptor. A region must not cross a 64K boundary and
+/// a ByteCount of 0 means 64K.
+///
+#pragma pack(1)
+typedef struct {
+  UINT32  RegionBaseAddr;
+  UINT16  ByteCount;
+  UINT16  EndOfTable;
+} ATAPI_PRD;
+#pragma pack()
+
+#define PRD_EOT                   BIT15
+#define ATAPI_PRD_MAX_REGION      0x10000
+#define ATAPI_PRD_TABLE_PAGES     1
+#define ATAPI_PRD_CHANNEL_ENTRIES (EFI_PAGES_TO_SIZE (ATAPI_PRD_TABLE_PAGES) / sizeof (ATAPI_PRD) / ATAPI_MAX_CHANNEL)
+
 ///
 /// IDE registers set
 ///
@@ -104,6 +140,17 @@ typedef struct {
   IDE_BASE_REGISTERS               AtapiIoPortRegisters[2];
   UINT32                           LatestTargetId;
   UINT64                           LatestLun;
+  //
+  // Bus master DMA. BusMasterBaseAddr is 0 for a channel without it.
+  // DmaDisabled is cleared only for a target that reported DMA support and
+  // accepted a DMA transfer mode, and set again when it fails a DMA transfer
+  // so that later commands go straight to PIO.
+  //
+  UINT16                           BusMasterBaseAddr[ATAPI_MAX_CHANNEL];
+  ATAPI_PRD                        *PrdTable;
+  EFI_PHYSICAL_ADDRESS             PrdTableDeviceAddr;
+  VOID                             *PrdTableMapping;
+  BOOLEAN                          DmaDisabled[MAX_TARGET_ID];
 } ATAPI_SCSI_PASS_THRU_DEV;
 
 //
@@ -176,7 +223,57 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gAtapiScsiPassThruDriverSuppor
 //
 // ATA Command
 //
-#define ATAPI_SOFT_RESET_CMD  0x08
+#define ATAPI_SOFT_RESET_CMD            0x08
+#define ATA_CMD_IDENTIFY_PACKET_DEVICE  0xA1
+#define ATA_CMD_SET_FEATURES            0xEF
+
+//
+// SET FEATURES subcommand and transfer mode types
+//
+#define ATA_SUB_CMD_SET_TRANSFER_MODE   0x03
+#define ATA_TRANSFER_MODE_PIO_FLOW      0x08
+#define ATA_TRANSFER_MODE_MWDMA         0x20
+#define ATA_TRANSFER_MODE_UDMA          0x40
+
+//
+// IDENTIFY PACKET DEVICE words
+//
+#define ATAPI_ID_GENERAL_CONFIG         0
+#define ATAPI_ID_PACKET_DEVICE_MASK     (BIT15 | BIT14)
+#define ATAPI_ID_PACKET_DEVICE          BIT15
+#define ATAPI_ID_CAPABILITIES           49
+#define ATAPI_ID_CAPABILITIES_DMA       BIT8
+#define ATAPI_ID_FIELD_VALIDITY         53
+#define ATAPI_ID_FIELD_VALIDITY_UDMA    BIT2
+#define ATAPI_ID_MWDMA_MODES            63
+#define ATAPI_ID_UDMA_MODES             88
+
+//
+// A PACKET device answers IDENTIFY PACKET DEVICE and SET FEATURES without
+// touching the medium
+//
+#define ATAPI_IDENTIFY_TIMEOUT          100000
+
+//
+// Reset completion polling
+//
+#define ATAPI_RESET_BSY_TIMEOUT     31000000  ///< slave device needs at most 31s to clear BSY
+#define ATAPI_RESET_READY_TIMEOUT   5000000   ///< upper bound for the status to settle once BSY is clear
+#define ATAPI_RESET_POLL_INTERVAL   30
+#define ATAPI_READY_STABLE_COUNT    2         ///< identical ready status reads needed to call a device stable
+
+//
+// Signature left in the Cylinder registers by a PACKET device after a reset
+//
+#define ATAPI_SIGNATURE_CYLINDER_LSB  0x14
+#define ATAPI_SIGNATURE_CYLINDER_MSB  0xEB
+
+//
+// Signature left in the Sector Count and Sector Number registers by an ATA device
+// after a reset, its Cylinder registers are 0
+//
+#define ATA_SIGNATURE_SECTOR_COUNT    0x01
+#define ATA_SIGNATURE_SECTOR_NUMBER   0x01
 
 typedef enum {
   DataIn  = 0,
@@ -1176,6 +1273,76 @@ Returns:
 --*/
 ;
 
+EFI_STATUS
+AtapiIssuePacketCommand (
+  ATAPI_SCSI_PASS_THRU_DEV                  *AtapiScsiPrivate,
+  UINT32                                    Target,
+  UINT8                                     *PacketCommand,
+  UINT8                                     Feature,
+  UINT64                                    TimeOutInMicroSeconds
+  )
+/*++
+
+Routine Description:
+
+  Selects the device, issues the PACKET command and sends the command
+  packet. The data phase is left to the caller.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  PacketCommand:      Points to the ATAPI command packet.
+  Feature:            Value for the Feature Register, DMA selects a DMA
+                      data transfer.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, for each wait.
+
+Returns:
+
+  EFI_STATUS
+
+--*/
+;
+
+EFI_STATUS
+AtapiPassThruDmaRead (
+  ATAPI_SCSI_PASS_THRU_DEV                  *AtapiScsiPrivate,
+  UINT32                                    Target,
+  UINT8                                     *PacketCommand,
+  VOID                                      *Buffer,
+  UINT32                                    *ByteCount,
+  UINT64                                    TimeOutInMicroSeconds
+  )
+/*++
+
+Routine Description:
+
+  Submits a read type ATAPI command packet and moves its data with bus
+  master DMA.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  PacketCommand:      Points to the ATAPI command packet.
+  Buffer:             Points to the transferred data.
+  ByteCount:          When input,indicates the buffer size; when output,
+                      indicates the actually transferred data size.
+  TimeoutInMicroSeconds:
+                      The timeout, in micro second units, to use for the
+                      execution of this ATAPI command.
+
+Returns:
+
+  EFI_UNSUPPORTED     - DMA could not be used for this request and nothing
+                        was transferred; the caller should fall back to PIO.
+  Others              - The status of the command.
+
+--*/
+;
 
 UINT8
 ReadPortB (
@@ -1276,6 +1443,85 @@ Returns:
 --*/
 ;
 
+VOID
+WritePortDW (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINT32                Data
+  )
+/*++
+
+Routine Description:
+
+  Write one dword to a specified I/O port.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Data       - The data to write
+
+Returns:
+
+  NONE
+
+--*/
+;
+
+VOID
+ReadPortWMultiple (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINTN                 Count,
+  OUT UINT16                *Buffer
+  )
+/*++
+
+Routine Description:
+
+  Read Count words from a specified I/O port with one string I/O access.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Count      - Number of words to read
+  Buffer     - Receives the words read out
+
+Returns:
+
+  NONE
+
+--*/
+;
+
+VOID
+WritePortWMultiple (
+  IN  EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN  UINT16                Port,
+  IN  UINTN                 Count,
+  IN  UINT16                *Buffer
+  )
+/*++
+
+Routine Description:
+
+  Write Count words to a specified I/O port with one string I/O access.
+
+Arguments:
+
+  PciIo      - The pointer of EFI_PCI_IO_PROTOCOL
+  Port       - IO port
+  Count      - Number of words to write
+  Buffer     - The words to write
+
+Returns:
+
+  NONE
+
+--*/
+;
+
 EFI_STATUS
 StatusDRQClear (
   ATAPI_SCSI_PASS_THRU_DEV        *AtapiScsiPrivate,
@@ -1487,6 +1733,57 @@ Returns:
 --*/
 ;
 
+EFI_STATUS
+WaitForChannelsReady (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT8                       ChannelMask,
+  UINT8                       *ResetMask
+  )
+/*++
+
+Routine Description:
+
+  Poll the selected device on every channel in ChannelMask until it is ready
+  after a reset. All channels are polled in the same loop, so their reset
+  times overlap instead of adding up.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+  ChannelMask                 - Bit N set polls AtapiIoPortRegisters[N]
+  ResetMask                   - Returns the channels on which BSY cleared
+
+Returns:
+
+  EFI_SUCCESS                 - Every channel with a device became ready.
+  EFI_TIMEOUT                 - At least one channel did not become ready.
+
+--*/
+;
+
+EFI_STATUS
+AtapiPassThruResetChannels (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Soft reset both the Primary channel and the Secondary channel and wait
+  for the devices on them to become ready.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  EFI_SUCCESS                 - At least one channel was reset.
+  EFI_TIMEOUT                 - No channel cleared BSY.
+
+--*/
+;
+
 EFI_STATUS
 AtapiPassThruPioReadWriteData (
   ATAPI_SCSI_PASS_THRU_DEV  *AtapiScsiPrivate,
@@ -1596,6 +1893,138 @@ Returns:
 --*/  
 ;
 
+VOID
+InitAtapiBusMaster (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Locate the Bus Master IDE registers through BAR4 and set up the PRD
+  tables. Leaves BusMasterBaseAddr zero, so that every transfer uses PIO,
+  when the controller or the platform can not do bus master DMA.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  None
+
+--*/
+;
+
+VOID
+InitAtapiDeviceDma (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Identify the PACKET device at every position of the channels that have
+  bus master DMA, and enable DMA for the devices whose IDENTIFY PACKET
+  DEVICE data reports it.
+
+  With the IDE Controller Init protocol, the transfer modes come from
+  CalculateMode() and the controller timing is programmed by SetTiming().
+  Without it, the controller timing is left to the platform, so DMA is
+  only used when the Bus Master IDE Status register reports the device as
+  DMA capable, in the DMA mode already selected in the device. The mode is
+  then set in the device with SET FEATURES.
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  None
+
+--*/
+;
+
+EFI_STATUS
+AtapiIdentifyPacketDevice (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  EFI_IDENTIFY_DATA           *IdentifyData
+  )
+/*++
+
+Routine Description:
+
+  Send IDENTIFY PACKET DEVICE to a device on the current channel.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  IdentifyData:       Receives the 256 words of IDENTIFY PACKET DEVICE data.
+
+Returns:
+
+  EFI_SUCCESS         - A PACKET device returned its identify data.
+  EFI_NOT_FOUND       - There is no PACKET device at this position.
+  Others              - The command failed.
+
+--*/
+;
+
+EFI_STATUS
+AtapiSetTransferMode (
+  ATAPI_SCSI_PASS_THRU_DEV    *AtapiScsiPrivate,
+  UINT32                      Target,
+  UINT8                       TransferMode
+  )
+/*++
+
+Routine Description:
+
+  Select a transfer mode in a device on the current channel with the SET
+  FEATURES command.
+
+Arguments:
+
+  AtapiScsiPrivate:   Private data structure for the specified channel.
+  Target:             Target ID 0 indicates Master device;Target ID 1
+                      indicates Slave device.
+  TransferMode:       Transfer mode type in bits 7:3, mode number in
+                      bits 2:0.
+
+Returns:
+
+  EFI_SUCCESS         - The device accepted the transfer mode.
+  EFI_DEVICE_ERROR    - The device rejected the transfer mode.
+  EFI_TIMEOUT         - The device did not complete the command.
+
+--*/
+;
+
+VOID
+FreeAtapiBusMaster (
+  IN  ATAPI_SCSI_PASS_THRU_DEV     *AtapiScsiPrivate
+  )
+/*++
+
+Routine Description:
+
+  Release the PRD tables set up by InitAtapiBusMaster().
+
+Arguments:
+
+  AtapiScsiPrivate            - The pointer of ATAPI_SCSI_PASS_THRU_DEV
+
+Returns:
+
+  None
+
+--*/
+;
+
 /**
   Installs Scsi Pass Thru and/or Ext Scsi Pass Thru 
   protocols based on feature flags. 
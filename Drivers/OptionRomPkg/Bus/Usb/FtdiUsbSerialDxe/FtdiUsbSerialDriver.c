@@ -203,6 +203,160 @@ SetStatusInternal (
   return EFI_SUCCESS;
 }
 
+/**
+  Stores received data in the receive ring.
+
+  Data that does not fit in the ring is dropped and counted in
+  SoftwareOverruns.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+  @param  Data[in]             The received data
+  @param  Length[in]           The number of bytes in Data
+
+**/
+VOID
+EFIAPI
+StoreReceivedData (
+  IN USB_SER_DEV  *UsbSerialDevice,
+  IN UINT8        *Data,
+  IN UINTN        Length
+  )
+{
+  UINTN  Free;
+  UINTN  Offset;
+  UINTN  Chunk;
+
+  Free = SW_FIFO_DEPTH - (UINT32) (UsbSerialDevice->DataBufferTail - UsbSerialDevice->DataBufferHead);
+  if (Length > Free) {
+    UsbSerialDevice->SoftwareOverruns += (UINT32) (Length - Free);
+    Length = Free;
+  }
+
+  Offset = UsbSerialDevice->DataBufferTail & SW_FIFO_MASK;
+  Chunk  = MIN (Length, SW_FIFO_DEPTH - Offset);
+  CopyMem (&UsbSerialDevice->DataBuffer[Offset], Data, Chunk);
+  CopyMem (UsbSerialDevice->DataBuffer, Data + Chunk, Length - Chunk);
+  UsbSerialDevice->DataBufferTail += (UINT32) Length;
+}
+
+/**
+  Removes data from the receive ring.
+
+  @param  UsbSerialDevice[in]  Handle to the Usb Serial Device
+  @param  Buffer[out]          The buffer to return the data into
+  @param  BufferSize[in]       The size of Buffer
+
+  @return The number of bytes returned in Buffer
+
+**/
+UINTN
+EFIAPI
+RemoveReceivedData (
+  IN  USB_SER_DEV  *UsbSerialDevice,
+  OUT UINT8        *Buffer,
+  IN  UINTN        BufferSize
+  )
+{
+  UINTN  Length;
+  UINTN  Offset;
+  UINTN  Chunk;
+
+  Length = MIN (BufferSize, (UINT32) (UsbSerialDevice->DataBufferTail - UsbSerialDevice->DataBufferHead));
+  Offset = UsbSerialDevice->DataBufferHead & SW_FIFO_MASK;
+  Chunk  = MIN (Length, SW_FIFO_DEPTH - Offset);
+  CopyMem (Buffer, &UsbSerialDevice->DataBuffer[Offset], Chunk);
+  CopyMem (Buffer + Chunk, UsbSerialDevice->DataBuffer, Length - Chunk);
+  UsbSerialDevice->DataBufferHead += (UINT32) Length;
+
+  return Length;
+}
+
+/**
+  Reads one bulk transfer from the Usb Serial Device into the receive ring.
+
+  Each packet of the transfer starts with the modem and line status bytes.
+  The modem status updates the status values, a line status overrun is
+  counted in HardwareOverruns, and NUL characters are not stored.
+
+  @param  UsbSerialDevice[in]        Handle to the USB device to read
+  @param  TransferLength[out]        The length of the bulk transfer, status
+                                     bytes included
+
+  @retval EFI_SUCCESS                The data was read.
+  @retval EFI_DEVICE_ERROR           The device reported an error.
+  @retval EFI_TIMEOUT                The data read was stopped due to a timeout.
+
+**/
+EFI_STATUS
+EFIAPI
+ReceiveDataFromUsb (
+  IN  USB_SER_DEV  *UsbSerialDevice,
+  OUT UINTN        *TransferLength
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *ReadBuffer;
+  UINT8       *Packet;
+  UINTN       PacketSize;
+  UINTN       PacketLength;
+  UINTN       Offset;
+  UINTN       Index;
+  UINTN       RunStart;
+
+  ReadBuffer      = &(UsbSerialDevice->ReadBuffer[0]);
+  *TransferLength = sizeof (UsbSerialDevice->ReadBuffer);
+
+  Status = UsbSerialDataTransfer (
+             UsbSerialDevice,
+             EfiUsbDataIn,
+             ReadBuffer,
+             TransferLength,
+             FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
+             );
+  if (EFI_ERROR (Status)) {
+    *TransferLength = 0;
+    if (Status == EFI_TIMEOUT) {
+      return EFI_TIMEOUT;
+    } else {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  PacketSize = UsbSerialDevice->InEndpointDescriptor.MaxPacketSize;
+  if (PacketSize <= FTDI_STATUS_SIZE) {
+    PacketSize = *TransferLength;
+  }
+
+  for (Offset = 0; Offset + FTDI_STATUS_SIZE <= *TransferLength; Offset += PacketSize) {
+    Packet       = &ReadBuffer[Offset];
+    PacketLength = MIN (PacketSize, *TransferLength - Offset);
+
+    SetStatusInternal (UsbSerialDevice, Packet);
+    if ((Packet[1] & FTDI_LSR_OVERRUN) != 0) {
+      UsbSerialDevice->HardwareOverruns++;
+    }
+
+    //
+    // Store the data after the status bytes in runs, skipping nulls
+    //
+    Index = FTDI_STATUS_SIZE;
+    while (Index < PacketLength) {
+      if (Packet[Index] == 0x00) {
+        Index++;
+        continue;
+      }
+
+      RunStart = Index;
+      while ((Index < PacketLength) && (Packet[Index] != 0x00)) {
+        Index++;
+      }
+      StoreReceivedData (UsbSerialDevice, &Packet[RunStart], Index - RunStart);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Initiates a read operation on the Usb Serial Device.
 
@@ -228,14 +382,8 @@ ReadDataFromUsb (
   )
 {
   EFI_STATUS  Status;
-  UINTN       ReadBufferSize;
-  UINT8       *ReadBuffer;
-  UINTN       Index;
+  UINTN       TransferLength;
   EFI_TPL     Tpl;
-  UINT8       StatusBuffer[2]; // buffer to store the status bytes
-
-  ReadBufferSize = 512;
-  ReadBuffer     = &(UsbSerialDevice->ReadBuffer[0]);
 
   if (UsbSerialDevice->Shutdown) {
     return EFI_DEVICE_ERROR;
@@ -243,71 +391,152 @@ ReadDataFromUsb (
 
   Tpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-  Status = UsbSerialDataTransfer (
-             UsbSerialDevice,
-             EfiUsbDataIn,
-             ReadBuffer,
-             &ReadBufferSize,
-             FTDI_TIMEOUT*2  //Padded because timers won't be exactly aligned
-             );
+  Status = ReceiveDataFromUsb (UsbSerialDevice, &TransferLength);
   if (EFI_ERROR (Status)) {
     gBS->RestoreTPL (Tpl);
-    if (Status == EFI_TIMEOUT) {
-      return EFI_TIMEOUT;
-    } else {
-      return EFI_DEVICE_ERROR;
-    }
+    return Status;
   }
 
   //
-  // Store the status bytes in the status buffer
+  // Read characters out of the buffer to satisfy caller's request.
+  // Return actual number of bytes returned.
   //
-  for (Index = 0; Index < 2; Index++) {//only the first 2 bytes are status bytes
-    StatusBuffer[Index] = ReadBuffer[Index];
+  *BufferSize = RemoveReceivedData (UsbSerialDevice, Buffer, *BufferSize);
+  gBS->RestoreTPL (Tpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Sends data to the Usb Serial Device.
+
+  The timeout allows for shifting BufferSize characters out at the current
+  baud rate, on top of FTDI_TIMEOUT.
+
+  @param  UsbSerialDevice[in]        Handle to the USB device to write
+  @param  BufferSize[in, out]        On input, the size of the Buffer. On output,
+                                     the amount of data actually written.
+  @param  Buffer[in]                 The buffer of data to write
+
+  @retval EFI_SUCCESS                The data was written.
+  @retval EFI_DEVICE_ERROR           The device reported an error.
+  @retval EFI_TIMEOUT                The data write was stopped due to a timeout.
+
+**/
+EFI_STATUS
+EFIAPI
+WriteDataToUsb (
+  IN USB_SER_DEV  *UsbSerialDevice,
+  IN OUT UINTN    *BufferSize,
+  IN VOID         *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      BaudRate;
+  UINT32      Timeout;
+
+  BaudRate = UsbSerialDevice->LastSettings.BaudRate;
+  if (BaudRate == 0) {
+    BaudRate = 115200;
   }
+
   //
-  // update the statusvalue field of the usbserialdevice
+  // 10 bits per character: start bit, 8 data bits, stop bit
   //
-  Status = SetStatusInternal (UsbSerialDevice, StatusBuffer);
-  if (Status != EFI_SUCCESS) {
+  Timeout = FTDI_TIMEOUT + (UINT32) DivU64x32 (MultU64x32 (*BufferSize, 10 * 1000), (UINT32) BaudRate);
+
+  Status = UsbSerialDataTransfer (
+             UsbSerialDevice,
+             EfiUsbDataOut,
+             Buffer,
+             BufferSize,
+             Timeout
+             );
+  if (EFI_ERROR (Status) && (Status != EFI_TIMEOUT)) {
+    return EFI_DEVICE_ERROR;
   }
+  return Status;
+}
 
-  //
-  // Store the read data in the read buffer, start at 2 to ignore status bytes
-  //
-  for (Index = 2; Index < ReadBufferSize; Index++) {
-    if (((UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH) == UsbSerialDevice->DataBufferHead) {
-      break;
-    }
-    if (ReadBuffer[Index] == 0x00) {
-      //
-      // This is null, do not add
-      //
-    } else {
-      UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferTail] = ReadBuffer[Index];
-      UsbSerialDevice->DataBufferTail = (UsbSerialDevice->DataBufferTail + 1) % SW_FIFO_DEPTH;
-    }
+/**
+  Sends the output collected by WriteSerialIo().
+
+  Whatever the device did not accept stays in the write buffer for the next
+  flush.
+
+  @param  UsbSerialDevice[in]        Handle to the USB device to write
+
+  @retval EFI_SUCCESS                The write buffer is empty.
+  @retval EFI_DEVICE_ERROR           The device reported an error.
+  @retval EFI_TIMEOUT                The data write was stopped due to a timeout.
+
+**/
+EFI_STATUS
+EFIAPI
+FlushWriteBuffer (
+  IN USB_SER_DEV  *UsbSerialDevice
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+
+  if (UsbSerialDevice->WriteBufferLength == 0) {
+    return EFI_SUCCESS;
   }
 
-  //
-  // Read characters out of the buffer to satisfy caller's request.
-  //
-  for (Index = 0; Index < *BufferSize; Index++) {
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      break;
-    }
-    //
-    // Still have characters in the buffer to return
-    //
-    ((UINT8 *)Buffer)[Index]        = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
-    UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
+  if (UsbSerialDevice->Shutdown) {
+    UsbSerialDevice->WriteBufferLength = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  Length = UsbSerialDevice->WriteBufferLength;
+  Status = WriteDataToUsb (UsbSerialDevice, &Length, UsbSerialDevice->WriteBuffer);
+  if (Length > UsbSerialDevice->WriteBufferLength) {
+    Length = UsbSerialDevice->WriteBufferLength;
   }
+
+  UsbSerialDevice->WriteBufferLength -= Length;
+  CopyMem (
+    UsbSerialDevice->WriteBuffer,
+    UsbSerialDevice->WriteBuffer + Length,
+    UsbSerialDevice->WriteBufferLength
+    );
+
+  return Status;
+}
+
+/**
+  Sends the output collected by WriteSerialIo(). Armed by WriteSerialIo() when
+  the write buffer stops being empty, and signaled before ExitBootServices()
+  so that no buffered output is lost.
+
+  @param  Event[in]
+  @param  Context[in]....The current instance of the USB serial device
+
+**/
+VOID
+EFIAPI
+UsbSerialDriverFlushOutput (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  USB_SER_DEV  *UsbSerialDevice;
+  EFI_TPL      Tpl;
+
+  UsbSerialDevice = (USB_SER_DEV*)Context;
+
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+  FlushWriteBuffer (UsbSerialDevice);
+
   //
-  // Return actual number of bytes returned.
+  // Retry whatever the device did not accept
   //
-  *BufferSize = Index;
+  if ((Event == UsbSerialDevice->WriteFlushEvent) &&
+      (UsbSerialDevice->WriteBufferLength != 0)) {
+    gBS->SetTimer (Event, TimerRelative, FTDI_WRITE_FLUSH_DELAY);
+  }
+
   gBS->RestoreTPL (Tpl);
-  return EFI_SUCCESS;
 }
 
 /**
@@ -365,6 +594,9 @@ SetInitialStatus (
   attempts to read data in from the device periodically, stores any read data
   and updates the control attributes.
 
+  The polling period drops to FTDI_POLL_PERIOD_MIN while data is moving and
+  backs off towards FTDI_POLL_PERIOD_MAX while the line is idle.
+
   @param  Event[in]
   @param  Context[in]....The current instance of the USB serial device
 
@@ -376,36 +608,84 @@ UsbSerialDriverCheckInput (
   IN  VOID       *Context
   )
 {
-  UINTN        BufferSize;
   USB_SER_DEV  *UsbSerialDevice;
+  EFI_STATUS   Status;
+  EFI_TPL      Tpl;
+  UINTN        TransferLength;
+  UINTN        Reads;
+  UINT32       Tail;
+  BOOLEAN      Active;
+  UINT64       PollingPeriod;
+  UINT32       Overruns;
 
   UsbSerialDevice = (USB_SER_DEV*)Context;
 
+  if (UsbSerialDevice->Shutdown) {
+    return;
+  }
+
+  Tpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Active = FALSE;
+
+  //
+  // Keep reading while the device returns full transfers. Data is left in
+  // the device when the ring can not take a whole transfer, so that flow
+  // control can hold the sender off.
+  //
+  Tail = UsbSerialDevice->DataBufferTail;
+  for (Reads = 0; Reads < FTDI_MAX_DRAIN_READS; Reads++) {
+    if ((SW_FIFO_DEPTH - (UINT32) (UsbSerialDevice->DataBufferTail - UsbSerialDevice->DataBufferHead)) <
+        sizeof (UsbSerialDevice->ReadBuffer)) {
+      break;
+    }
+
+    Status = ReceiveDataFromUsb (UsbSerialDevice, &TransferLength);
+    if (EFI_ERROR (Status) || (TransferLength < sizeof (UsbSerialDevice->ReadBuffer))) {
+      break;
+    }
+  }
+
+  if (UsbSerialDevice->DataBufferTail != Tail) {
+    Active = TRUE;
+  }
+
   if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
     //
-    // Data buffer is empty, try to read from device
+    // Data buffer still has no data, set the EFI_SERIAL_INPUT_BUFFER_EMPTY
+    // flag
     //
-    BufferSize = 0;
-    ReadDataFromUsb (UsbSerialDevice, &BufferSize, NULL);
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      //
-      // Data buffer still has no data, set the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
-    } else {
-      //
-      // Read has returned some data, clear the EFI_SERIAL_INPUT_BUFFER_EMPTY
-      // flag
-      //
-      UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
-    }
+    UsbSerialDevice->ControlBits |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
   } else {
     //
-    // Data buffer has data, no read attempt required
+    // Data buffer has data, clear the EFI_SERIAL_INPUT_BUFFER_EMPTY flag
     //
     UsbSerialDevice->ControlBits &= ~(EFI_SERIAL_INPUT_BUFFER_EMPTY);
   }
+
+  if (Active) {
+    PollingPeriod = FTDI_POLL_PERIOD_MIN;
+  } else {
+    PollingPeriod = MIN (MultU64x32 (UsbSerialDevice->PollingPeriod, 2), FTDI_POLL_PERIOD_MAX);
+  }
+
+  if (PollingPeriod != UsbSerialDevice->PollingPeriod) {
+    UsbSerialDevice->PollingPeriod = PollingPeriod;
+    gBS->SetTimer (Event, TimerPeriodic, PollingPeriod);
+  }
+
+  Overruns = UsbSerialDevice->SoftwareOverruns + UsbSerialDevice->HardwareOverruns;
+  if (Overruns != UsbSerialDevice->ReportedOverruns) {
+    UsbSerialDevice->ReportedOverruns = Overruns;
+    DEBUG ((
+      EFI_D_WARN,
+      "FtdiUsbSerial: receive overrun, %d bytes dropped by the driver, %d overruns reported by the device\n",
+      UsbSerialDevice->SoftwareOverruns,
+      UsbSerialDevice->HardwareOverruns
+      ));
+  }
+
+  gBS->RestoreTPL (Tpl);
 }
 
 /**
@@ -859,6 +1139,11 @@ SetAttributesInternal (
     return  EFI_INVALID_PARAMETER;
   }
 
+  //
+  // send pending output before the line settings change
+  //
+  FlushWriteBuffer (UsbSerialDevice);
+
   //
   // set data bits, parity and stop bits
   //
@@ -1108,6 +1393,53 @@ StatusError:
   }
 }
 
+/**
+  Internal function that performs a Usb Control Transfer to set the latency
+  timer of the Usb Serial Device, the time the device holds a bulk in transfer
+  waiting for data before it returns the status bytes alone.
+
+  @param  UsbIo[in]                  Usb Io Protocol instance pointer
+  @param  Latency[in]                The latency timer value in ms
+
+  @retval EFI_SUCCESS                The latency timer was set on the Usb
+                                     Serial Device
+  @retval EFI_DEVICE_ERROR           The device is not functioning correctly
+
+**/
+EFI_STATUS
+EFIAPI
+SetLatencyTimerInternal (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                Latency
+  )
+{
+  EFI_STATUS              Status;
+  EFI_USB_DEVICE_REQUEST  DevReq;
+  UINT32                  ReturnValue;
+  UINT8                   ConfigurationValue;
+
+  DevReq.Request     = FTDI_COMMAND_SET_LATENCY_TIMER;
+  DevReq.RequestType = USB_REQ_TYPE_VENDOR;
+  DevReq.Value       = Latency;
+  DevReq.Index       = FTDI_PORT_IDENTIFIER;
+  DevReq.Length      = 0; // indicates that there is no data phase in this request
+
+  Status = UsbIo->UsbControlTransfer (
+                    UsbIo,
+                    &DevReq,
+                    EfiUsbDataOut,
+                    WDR_TIMEOUT,
+                    &ConfigurationValue,
+                    1,
+                    &ReturnValue
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
 /**
   Internal function that performs a Usb Control Transfer to set the Dtr value on
   the Usb Serial Device.
@@ -1344,11 +1676,12 @@ GetControlBitsInternal (
     *Control |= EFI_SERIAL_HARDWARE_FLOW_CONTROL_ENABLE;
   }
   //
-  // check if the buffer is empty since only one is being used if it is empty
-  // set both the receive and transmit buffers to empty
+  // check if the receive ring and the write buffer are empty
   //
-  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
+  if (UsbSerialDevice->WriteBufferLength == 0) {
     *Control |= EFI_SERIAL_OUTPUT_BUFFER_EMPTY;
+  }
+  if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
     *Control |= EFI_SERIAL_INPUT_BUFFER_EMPTY;
   }
   //
@@ -1384,6 +1717,11 @@ ResetInternal (
   UINT8                   ConfigurationValue;
   UINT32                  ReturnValue;
 
+  //
+  // Output not sent yet is purged along with the device's TX FIFO
+  //
+  UsbSerialDevice->WriteBufferLength = 0;
+
   DevReq.Request     = FTDI_COMMAND_RESET_PORT;
   DevReq.RequestType = USB_REQ_TYPE_VENDOR;
   DevReq.Value       = RESET_PORT_PURGE_RX;
@@ -1991,9 +2329,38 @@ UsbSerialDriverBindingStart (
     FALSE
     );
 
+  //
+  // Shorten the latency timer so that idle polls return quickly. The device
+  // still works with the default latency, only the polls take longer.
+  //
+  Status = SetLatencyTimerInternal (UsbSerialDevice->UsbIo, FTDI_LATENCY_TIMER);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_WARN, "FtdiUsbSerial: failed to set the latency timer - %r\n", Status));
+  }
+
   Status = SetInitialStatus (UsbSerialDevice);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Create the events that send buffered output, after a short delay and
+  // before ExitBootServices()
+  //
+  gBS->CreateEvent (
+         EVT_TIMER | EVT_NOTIFY_SIGNAL,
+         TPL_CALLBACK,
+         UsbSerialDriverFlushOutput,
+         UsbSerialDevice,
+         &(UsbSerialDevice->WriteFlushEvent)
+         );
+  gBS->CreateEventEx (
+         EVT_NOTIFY_SIGNAL,
+         TPL_CALLBACK,
+         UsbSerialDriverFlushOutput,
+         UsbSerialDevice,
+         &gEfiEventBeforeExitBootServicesGuid,
+         &(UsbSerialDevice->ExitBootServicesEvent)
+         );
+
   //
   // Create a polling loop to check for input
   //
@@ -2006,13 +2373,14 @@ UsbSerialDriverBindingStart (
          &(UsbSerialDevice->PollingLoop)
          );
   //
-  // add code to set trigger time based on baud rate
-  // setting to 0.5s for now
+  // Start at the idle period, UsbSerialDriverCheckInput() adapts it to the
+  // traffic
   //
+  UsbSerialDevice->PollingPeriod = FTDI_POLL_PERIOD_MAX;
   gBS->SetTimer (
          UsbSerialDevice->PollingLoop,
          TimerPeriodic,
-         EFI_TIMER_PERIOD_MILLISECONDS (500)
+         UsbSerialDevice->PollingPeriod
          );
 
   //
@@ -2101,6 +2469,9 @@ ErrorExit:
     goto ErrorExit1;
   }
 
+  gBS->CloseEvent (UsbSerialDevice->PollingLoop);
+  gBS->CloseEvent (UsbSerialDevice->WriteFlushEvent);
+  gBS->CloseEvent (UsbSerialDevice->ExitBootServicesEvent);
   FreePool (UsbSerialDevice->DataBuffer);
   FreePool (UsbSerialDevice);
 
@@ -2212,12 +2583,15 @@ UsbSerialDriverBindingStop (
         if (UsbSerialDevice->DevicePath != NULL) {
           gBS->FreePool (UsbSerialDevice->DevicePath);
         }
+        FlushWriteBuffer (UsbSerialDevice);
         gBS->SetTimer (
                UsbSerialDevice->PollingLoop,
                TimerCancel,
                0
                );
         gBS->CloseEvent (UsbSerialDevice->PollingLoop);
+        gBS->CloseEvent (UsbSerialDevice->WriteFlushEvent);
+        gBS->CloseEvent (UsbSerialDevice->ExitBootServicesEvent);
         UsbSerialDevice->Shutdown = TRUE;
         FreeUnicodeStringTable (UsbSerialDevice->ControllerNameTable);
         FreePool (UsbSerialDevice->DataBuffer);
@@ -2465,6 +2839,7 @@ ReadSerialIo (
   UINTN        RemainingCallerBufferSize;
   USB_SER_DEV  *UsbSerialDevice;
   EFI_STATUS   Status;
+  EFI_TPL      Tpl;
 
 
   if (*BufferSize == 0) {
@@ -2481,17 +2856,9 @@ ReadSerialIo (
   //
   // Clear out any data that we already have in our internal buffer
   //
-  for (Index = 0; Index < *BufferSize; Index++) {
-    if (UsbSerialDevice->DataBufferHead == UsbSerialDevice->DataBufferTail) {
-      break;
-    }
-
-    //
-    // Still have characters in the buffer to return
-    //
-    ((UINT8 *)Buffer)[Index] = UsbSerialDevice->DataBuffer[UsbSerialDevice->DataBufferHead];
-    UsbSerialDevice->DataBufferHead = (UsbSerialDevice->DataBufferHead + 1) % SW_FIFO_DEPTH;
-  }
+  Tpl   = gBS->RaiseTPL (TPL_NOTIFY);
+  Index = RemoveReceivedData (UsbSerialDevice, Buffer, *BufferSize);
+  gBS->RestoreTPL (Tpl);
 
   //
   // If we haven't filled the caller's buffer using data that we already had on
@@ -2559,22 +2926,43 @@ WriteSerialIo (
 
   Tpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-  Status = UsbSerialDataTransfer (
-             UsbSerialDevice,
-             EfiUsbDataOut,
-             Buffer,
-             BufferSize,
-             FTDI_TIMEOUT
-             );
+  if (*BufferSize < FTDI_WRITE_BUFFER_SIZE) {
+    //
+    // Console output comes a few characters at a time. Collect it and send
+    // it as one transfer from UsbSerialDriverFlushOutput().
+    //
+    Status = EFI_SUCCESS;
+    if ((UsbSerialDevice->WriteBufferLength + *BufferSize) > FTDI_WRITE_BUFFER_SIZE) {
+      Status = FlushWriteBuffer (UsbSerialDevice);
+    }
 
-  gBS->RestoreTPL (Tpl);
-  if (EFI_ERROR (Status)) {
-    if (Status == EFI_TIMEOUT){
-      return Status;
+    if ((UsbSerialDevice->WriteBufferLength + *BufferSize) <= FTDI_WRITE_BUFFER_SIZE) {
+      CopyMem (
+        UsbSerialDevice->WriteBuffer + UsbSerialDevice->WriteBufferLength,
+        Buffer,
+        *BufferSize
+        );
+      if ((UsbSerialDevice->WriteBufferLength == 0) && (*BufferSize != 0)) {
+        gBS->SetTimer (
+               UsbSerialDevice->WriteFlushEvent,
+               TimerRelative,
+               FTDI_WRITE_FLUSH_DELAY
+               );
+      }
+      UsbSerialDevice->WriteBufferLength += *BufferSize;
+      Status = EFI_SUCCESS;
     } else {
-      return EFI_DEVICE_ERROR;
+      *BufferSize = 0;
+    }
+  } else {
+    Status = FlushWriteBuffer (UsbSerialDevice);
+    if (EFI_ERROR (Status)) {
+      *BufferSize = 0;
+    } else {
+      Status = WriteDataToUsb (UsbSerialDevice, BufferSize, Buffer);
     }
   }
 
-  return EFI_SUCCESS;
+  gBS->RestoreTPL (Tpl);
+  return Status;
 }
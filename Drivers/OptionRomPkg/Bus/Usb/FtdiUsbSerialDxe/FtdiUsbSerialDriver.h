@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DevicePathLib.h>
+#include <Library/BaseLib.h>
 
 #include <Protocol/DevicePath.h>
 #include <Protocol/UsbIo.h>
@@ -156,6 +157,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define FTDI_TIMEOUT       16
 
+//
+// FTDI latency timer in ms. The device holds a bulk in transfer this long
+// waiting for data before it returns the status bytes alone, the default of
+// 16 ms would stall every idle poll.
+//
+#define FTDI_LATENCY_TIMER 2
+
 //
 // FTDI FIFO depth
 //
@@ -167,10 +175,40 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FTDI_ENDPOINT_ADDRESS_IN   0x81 //the endpoint address for the in enpoint generated by the device
 #define FTDI_ENDPOINT_ADDRESS_OUT  0x02 //the endpoint address for the out endpoint generated by the device
 
+//
+// Receive ring size. It must be a power of two: the head and tail indices
+// run freely and are masked with SW_FIFO_MASK.
+//
+#define SW_FIFO_DEPTH 4096
+#define SW_FIFO_MASK  (SW_FIFO_DEPTH - 1)
+
 //
 // Max buffer size for USB transfers
 //
-#define SW_FIFO_DEPTH 1024
+#define FTDI_READ_BUFFER_SIZE   512
+#define FTDI_WRITE_BUFFER_SIZE  512 // writes shorter than this are coalesced
+
+//
+// Every bulk in packet starts with two status bytes, the modem status and
+// the line status
+//
+#define FTDI_STATUS_SIZE        2
+#define FTDI_LSR_OVERRUN        BIT1
+
+//
+// Input polling. The period drops to the minimum while data is moving and
+// doubles on every idle poll up to the maximum. Up to FTDI_MAX_DRAIN_READS
+// full transfers are read per poll.
+//
+#define FTDI_POLL_PERIOD_MIN    EFI_TIMER_PERIOD_MILLISECONDS (1)
+#define FTDI_POLL_PERIOD_MAX    EFI_TIMER_PERIOD_MILLISECONDS (500)
+#define FTDI_MAX_DRAIN_READS    4
+
+//
+// Output collected by WriteSerialIo() is sent this long after the first
+// byte was buffered, independently of the input polling.
+//
+#define FTDI_WRITE_FLUSH_DELAY  EFI_TIMER_PERIOD_MILLISECONDS (1)
 
 //
 // struct to define a usb device as a vendor and product id pair
@@ -240,11 +278,19 @@ typedef struct {
   EFI_SERIAL_IO_PROTOCOL        SerialIo;
   BOOLEAN                       Shutdown;
   EFI_EVENT                     PollingLoop;
+  EFI_EVENT                     WriteFlushEvent;
+  EFI_EVENT                     ExitBootServicesEvent;
   UINT32                        ControlBits;
   PREVIOUS_ATTRIBUTES           LastSettings;
   CONTROL_BITS                  ControlValues;
   STATUS_BITS                   StatusValues;
-  UINT8                         ReadBuffer[512];
+  UINT8                         ReadBuffer[FTDI_READ_BUFFER_SIZE];
+  UINT8                         WriteBuffer[FTDI_WRITE_BUFFER_SIZE];
+  UINTN                         WriteBufferLength;
+  UINT64                        PollingPeriod;
+  UINT32                        SoftwareOverruns; // bytes dropped, receive ring full
+  UINT32                        HardwareOverruns; // packets flagging a device overrun
+  UINT32                        ReportedOverruns;
 } USB_SER_DEV;
 
 #define USB_SER_DEV_FROM_THIS(a) \
@@ -20,6 +20,7 @@
 #include <Library/BaseLib.h>
 #include <Library/HobLib.h>
 #include <Library/TimerLib.h>
+#include <Library/CacheMaintenanceLib.h>
 #include <Guid/SpiFlashInfoGuid.h>
 #include "RegsSpi.h"
 
@@ -31,6 +32,12 @@
 #define WAIT_TIME    6000000    ///< Wait Time = 6 seconds = 6000000 microseconds
 #define WAIT_PERIOD  10         ///< Wait Period = 10 microseconds
 
+///
+/// Largest BIOS region decoded right below 4GB, reads of a larger BIOS region
+/// go through the hardware sequencing cycles.
+///
+#define SPI_BIOS_MMIO_MAX_SIZE  SIZE_16MB
+
 ///
 /// Flash cycle Type
 ///
@@ -71,6 +78,8 @@ typedef struct {
   UINT8         NumberOfComponents;
   UINT16        Flags;
   UINT32        Component1StartAddr;
+  UINT32        BiosRegionSize;
+  UINTN         BiosMmioBase;       ///< 0 if the BIOS region is not memory mapped
 } SPI_INSTANCE;
 
 /**
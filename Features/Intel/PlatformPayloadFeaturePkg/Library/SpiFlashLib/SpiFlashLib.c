@@ -31,6 +31,51 @@ GetSpiInstance (
   return mSpiInstance;
 }
 
+/**
+  Check that the SPI controller decodes the top BiosRegionSize bytes below 4GB
+  to the flash.
+
+  The BIOS Decode Enable register splits the top 16MB into 4MB blocks. In the
+  upper 8MB each bit of 15:8 enables a 512KB range in both 4MB blocks, in the
+  lower 8MB each bit of 3:0 enables a 1MB range in both 4MB blocks.
+
+  @param[in] PchSpiBase           PCI config space base of the SPI controller.
+  @param[in] BiosRegionSize       Size of the BIOS region, at most 16MB.
+
+  @retval TRUE                    The whole BIOS region is decoded.
+  @retval FALSE                   Some part of the BIOS region is not decoded.
+**/
+STATIC
+BOOLEAN
+SpiIsBiosRegionDecoded (
+  IN UINT32  PchSpiBase,
+  IN UINT32  BiosRegionSize
+  )
+{
+  UINT16  BiosDecode;
+  UINT32  Offset;
+  UINT32  Bit;
+
+  BiosDecode = MmioRead16 (PchSpiBase + R_SPI_BDE);
+
+  //
+  // Offset is relative to 4GB minus 16MB
+  //
+  for (Offset = (SIZE_16MB - BiosRegionSize) & ~(SIZE_512KB - 1); Offset < SIZE_16MB; Offset += SIZE_512KB) {
+    if (Offset >= SIZE_8MB) {
+      Bit = 8 + ((Offset % SIZE_4MB) / SIZE_512KB);
+    } else {
+      Bit = (Offset % SIZE_4MB) / SIZE_1MB;
+    }
+
+    if ((BiosDecode & (1 << Bit)) == 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Initialize an SPI library.
 
@@ -147,6 +192,22 @@ SpiConstructor (
   //
   SpiInstance->StrapBaseAddress &= B_SPI_FDBAR_FPSBA;
 
+  //
+  // The BIOS region ends at 4GB in the memory map, reads of the BIOS region can
+  // be served from there instead of 64 bytes per hardware sequencing cycle.
+  // Only use the window if the SPI controller decodes all of it.
+  //
+  SpiInstance->BiosMmioBase = 0;
+  if (!EFI_ERROR (SpiGetRegionAddress (FlashRegionBios, NULL, &SpiInstance->BiosRegionSize)) &&
+      (SpiInstance->BiosRegionSize != 0) &&
+      (SpiInstance->BiosRegionSize <= SPI_BIOS_MMIO_MAX_SIZE) &&
+      SpiIsBiosRegionDecoded (SpiInstance->PchSpiBase, SpiInstance->BiosRegionSize))
+  {
+    SpiInstance->BiosMmioBase = (UINTN)(SIZE_4GB - SpiInstance->BiosRegionSize);
+  }
+
+  DEBUG ((DEBUG_INFO, "BIOS region size 0x%x, memory mapped at 0x%lx\n", SpiInstance->BiosRegionSize, (UINT64)SpiInstance->BiosMmioBase));
+
   return EFI_SUCCESS;
 }
 
@@ -172,7 +233,19 @@ SpiFlashRead (
   OUT    UINT8              *Buffer
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS    Status;
+  SPI_INSTANCE  *SpiInstance;
+
+  //
+  // Read the BIOS region straight from its memory mapped window when it is decoded
+  //
+  SpiInstance = GetSpiInstance ();
+  if ((FlashRegionType == FlashRegionBios) && (SpiInstance != NULL) && (SpiInstance->BiosMmioBase != 0) &&
+      (Address < SpiInstance->BiosRegionSize) && (ByteCount <= SpiInstance->BiosRegionSize - Address))
+  {
+    CopyMem (Buffer, (VOID *)(SpiInstance->BiosMmioBase + Address), ByteCount);
+    return EFI_SUCCESS;
+  }
 
   Status = SendSpiCmd (FlashRegionType, FlashCycleRead, Address, ByteCount, Buffer);
   return Status;
@@ -436,6 +509,7 @@ SendSpiCmd (
   UINT8         BiosCtlSave;
   SPI_INSTANCE  *SpiInstance;
   UINT32        Data32;
+  UINT32        TotalByteCount;
 
   SpiInstance = GetSpiInstance ();
   if (SpiInstance == NULL) {
@@ -443,6 +517,7 @@ SendSpiCmd (
   }
 
   Status                        = EFI_SUCCESS;
+  TotalByteCount                = ByteCount;
   SpiBaseAddress                = SpiInstance->PchSpiBase;
   ScSpiBar0                     = AcquireSpiBar0 (SpiBaseAddress);
   BiosCtlSave                   = 0;
@@ -753,6 +828,18 @@ SendSpiCmdEnd:
   if ((FlashCycleType == FlashCycleWrite) || (FlashCycleType == FlashCycleErase)) {
     EnableBiosWriteProtect (SpiBaseAddress, mSpiInstance->Flags & FLAGS_SPI_DISABLE_SMM_WRITE_PROTECT);
     SetSpiBiosControlRegister (SpiBaseAddress, BiosCtlSave);
+
+    //
+    // Drop the stale lines of the memory mapped BIOS region so later reads see the new content
+    //
+    if ((FlashRegionType == FlashRegionBios) && (SpiInstance->BiosMmioBase != 0) &&
+        (Address < SpiInstance->BiosRegionSize))
+    {
+      WriteBackInvalidateDataCacheRange (
+        (VOID *)(SpiInstance->BiosMmioBase + Address),
+        MIN (TotalByteCount, SpiInstance->BiosRegionSize - Address)
+        );
+    }
   }
 
   ReleaseSpiBar0 (SpiBaseAddress);
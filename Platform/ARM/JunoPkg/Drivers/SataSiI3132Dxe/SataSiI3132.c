@@ -43,8 +43,8 @@ SataSiI3132PortConstructor (
 {
   EFI_STATUS            Status;
   SATA_SI3132_PORT      *Port;
-  VOID                  *HostPRB;
-  EFI_PHYSICAL_ADDRESS  PhysAddrHostPRB;
+  VOID                  *HostCommand;
+  EFI_PHYSICAL_ADDRESS  PhysAddrHostCommand;
   VOID                  *PciAllocMappingPRB;
   UINTN                 NumberOfBytes;
 
@@ -55,28 +55,31 @@ SataSiI3132PortConstructor (
   Port->Instance = SataSiI3132Instance;
   InitializeListHead (&(Port->Devices));
 
-  NumberOfBytes = sizeof (SATA_SI3132_PRB);
+  // One PRB (and its SGTs) per command slot
+  NumberOfBytes = sizeof (SATA_SI3132_COMMAND) * SATA_SII3132_MAXSLOT;
   Status = SataSiI3132Instance->PciIo->AllocateBuffer (
              SataSiI3132Instance->PciIo, AllocateAnyPages, EfiBootServicesData,
-             EFI_SIZE_TO_PAGES (NumberOfBytes), &HostPRB, 0
+             EFI_SIZE_TO_PAGES (NumberOfBytes), &HostCommand, 0
              );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
   // Check the alignment of the PCI Buffer
-  ASSERT (((UINTN)HostPRB & (0x1000 - 1)) == 0);
+  ASSERT (((UINTN)HostCommand & (0x1000 - 1)) == 0);
   Status = SataSiI3132Instance->PciIo->Map (
-             SataSiI3132Instance->PciIo, EfiPciIoOperationBusMasterCommonBuffer, HostPRB,
-             &NumberOfBytes, &PhysAddrHostPRB, &PciAllocMappingPRB
+             SataSiI3132Instance->PciIo, EfiPciIoOperationBusMasterCommonBuffer, HostCommand,
+             &NumberOfBytes, &PhysAddrHostCommand, &PciAllocMappingPRB
              );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  Port->HostPRB            = HostPRB;
-  Port->PhysAddrHostPRB    = PhysAddrHostPRB;
-  Port->PciAllocMappingPRB = PciAllocMappingPRB;
+  Port->HostCommand         = HostCommand;
+  Port->PhysAddrHostCommand = PhysAddrHostCommand;
+  Port->PciAllocMappingPRB  = PciAllocMappingPRB;
+  Port->SlotsInUse          = 0;
+  Port->ActiveSlots         = 0;
 
   return Status;
 }
@@ -90,6 +93,7 @@ SataSiI3132Constructor (
 {
   SATA_SI3132_INSTANCE    *Instance;
   EFI_ATA_PASS_THRU_MODE  *AtaPassThruMode;
+  EFI_STATUS              Status;
 
   if (SataSiI3132Instance == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -107,6 +111,21 @@ SataSiI3132Constructor (
   AtaPassThruMode->Attributes = EFI_ATA_PASS_THRU_ATTRIBUTES_PHYSICAL | EFI_ATA_PASS_THRU_ATTRIBUTES_LOGICAL;
   AtaPassThruMode->IoAlign = 0x1000;
 
+  // Non-blocking commands are completed by a periodic timer polling the slots
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  SiI3132OnTimer,
+                  Instance,
+                  &Instance->TimerEvent
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (Instance->TimerEvent, TimerPeriodic, SATA_SII3132_POLL_PERIOD);
+    if (!EFI_ERROR (Status)) {
+      AtaPassThruMode->Attributes |= EFI_ATA_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
+    }
+  }
+
   // Initialize SiI3132 ports
   SataSiI3132PortConstructor (Instance, 0);
   SataSiI3132PortConstructor (Instance, 1);
@@ -70,7 +70,24 @@
 #define SII3132_PORT_INT_CMDERR                 (1 << 1)
 #define SII3132_PORT_INT_PORTRDY                (1 << 2)
 
+// Raw command completion and error status bits of the interrupt status register
+#define SII3132_PORT_INT_CMD_STATUS             ((SII3132_PORT_INT_CMDCOMPL | SII3132_PORT_INT_CMDERR) << 16)
+
+#define SII3132_PORT_SLOTSTATUS_ATTENTION       0x80000000
+
+// Each command slot has 0x80 bytes of port LRAM, the received FIS is at 0x08
+#define SII3132_PORT_SLOT_SIZE                  0x80
+#define SII3132_PORT_SLOT_FIS                   0x08
+
 #define SATA_SII3132_MAXPORT    2
+#define SATA_SII3132_MAXSLOT    31
+
+// Data SGEs per command, and the SGTs needed to chain them after the PRB
+#define SATA_SII3132_MAXSGE     16
+#define SATA_SII3132_MAXSGT     5
+
+// Period of the timer polling the non-blocking commands (in 100ns units)
+#define SATA_SII3132_POLL_PERIOD    10000
 
 #define PRB_CTRL_ATA            0x0
 #define PRB_CTRL_PROT_OVERRIDE  0x1
@@ -117,6 +134,28 @@ typedef struct _SATA_SI3132_PRB {
     SATA_SI3132_SGE     Sge[2];
 } SATA_SI3132_PRB;
 
+typedef struct _SATA_SI3132_SGT {
+    SATA_SI3132_SGE     Sge[4];
+} SATA_SI3132_SGT;
+
+// Host memory of a command slot: the PRB and the SGTs its SGE list links to
+typedef struct _SATA_SI3132_COMMAND {
+    SATA_SI3132_PRB     Prb;
+    SATA_SI3132_SGT     Sgt[SATA_SII3132_MAXSGT];
+} SATA_SI3132_COMMAND;
+
+// Software state of a command slot
+typedef struct _SATA_SI3132_TASK {
+    EFI_ATA_PASS_THRU_COMMAND_PACKET    *Packet;
+    EFI_EVENT                           Event;      // NULL for blocking commands
+    UINT16                              PortMultiplierPort;
+    UINT64                              Timeout;    // 0 if none
+    UINTN                               MapCount;
+    VOID*                               Mapping[SATA_SII3132_MAXSGE];
+    BOOLEAN                             Done;
+    EFI_STATUS                          Status;
+} SATA_SI3132_TASK;
+
 typedef struct _SATA_SI3132_DEVICE {
     LIST_ENTRY                  Link; // This attribute must be the first entry of this structure (to avoid pointer computation)
     UINTN                       Index;
@@ -132,9 +171,13 @@ typedef struct _SATA_SI3132_PORT {
     //TODO: Support Port multiplier
     LIST_ENTRY                      Devices;
 
-    SATA_SI3132_PRB*                HostPRB;
-    EFI_PHYSICAL_ADDRESS            PhysAddrHostPRB;
+    SATA_SI3132_COMMAND*            HostCommand;    // One per slot
+    EFI_PHYSICAL_ADDRESS            PhysAddrHostCommand;
     VOID*                           PciAllocMappingPRB;
+
+    UINT32                          SlotsInUse;     // Allocated slots
+    UINT32                          ActiveSlots;    // Slots issued to the controller and not completed
+    SATA_SI3132_TASK                Tasks[SATA_SII3132_MAXSLOT];
 } SATA_SI3132_PORT;
 
 typedef struct _SATA_SI3132_INSTANCE {
@@ -145,6 +188,8 @@ typedef struct _SATA_SI3132_INSTANCE {
     EFI_ATA_PASS_THRU_PROTOCOL  AtaPassThruProtocol;
 
     EFI_PCI_IO_PROTOCOL         *PciIo;
+
+    EFI_EVENT                   TimerEvent;   // Polls the non-blocking commands
 } SATA_SI3132_INSTANCE;
 
 #define SATA_SII3132_SIGNATURE              SIGNATURE_32('s', 'i', '3', '2')
@@ -184,6 +229,13 @@ SataSiI3132ComponentNameGetControllerName (
 
 EFI_STATUS SiI3132HwResetPort (SATA_SI3132_PORT *Port);
 
+VOID
+EFIAPI
+SiI3132OnTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /*
  * Driver Binding Protocol Functions
  */
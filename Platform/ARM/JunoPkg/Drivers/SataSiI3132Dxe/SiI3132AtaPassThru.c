@@ -46,6 +46,297 @@ GetSataDevice (
   return NULL;
 }
 
+/**
+  Map a data buffer for the controller and describe it in the SGE list of a command slot.
+
+  PciIo->Map() can return a mapping that covers only part of the buffer (e.g. when it has to
+  bounce it), so the buffer is mapped piece by piece and each piece gets its own SGE. The PRB
+  holds the first SGE, the following ones are chained through the SGTs of the slot.
+
+**/
+STATIC
+EFI_STATUS
+SiI3132MapDataBuffer (
+  IN EFI_PCI_IO_PROTOCOL            *PciIo,
+  IN SATA_SI3132_COMMAND            *Command,
+  IN EFI_PHYSICAL_ADDRESS           PhysAddrCommand,
+  IN SATA_SI3132_TASK               *Task,
+  IN EFI_PCI_IO_PROTOCOL_OPERATION  Operation,
+  IN VOID                           *Buffer,
+  IN UINTN                          Length
+  )
+{
+  EFI_PHYSICAL_ADDRESS    PhysAddr[SATA_SII3132_MAXSGE];
+  UINTN                   Size[SATA_SII3132_MAXSGE];
+  EFI_PHYSICAL_ADDRESS    PhysAddrSgt;
+  SATA_SI3132_SGE         *Sge;
+  UINTN                   Entries;
+  UINTN                   SgtIndex;
+  UINTN                   Offset;
+  UINTN                   Index;
+  EFI_STATUS              Status;
+
+  Offset = 0;
+  while (Offset < Length) {
+    if (Task->MapCount == SATA_SII3132_MAXSGE) {
+      Status = EFI_BAD_BUFFER_SIZE;
+      goto UnmapBuffer;
+    }
+
+    Index = Task->MapCount;
+    Size[Index] = Length - Offset;
+    Status = PciIo->Map (
+               PciIo, Operation, (UINT8*)Buffer + Offset,
+               &Size[Index], &PhysAddr[Index], &Task->Mapping[Index]
+               );
+    if (EFI_ERROR (Status)) {
+      goto UnmapBuffer;
+    }
+    Task->MapCount++;
+    Offset += Size[Index];
+  }
+
+  // The last entry of a table links to the next SGT when more than one segment is left
+  Sge      = Command->Prb.Sge;
+  Entries  = 2;
+  SgtIndex = 0;
+  for (Index = 0; Index < Task->MapCount; Index++) {
+    if ((Entries == 1) && ((Task->MapCount - Index) > 1)) {
+      ASSERT (SgtIndex < SATA_SII3132_MAXSGT);
+      PhysAddrSgt = PhysAddrCommand + sizeof (SATA_SI3132_PRB) + (SgtIndex * sizeof (SATA_SI3132_SGT));
+      Sge->DataAddressLow  = (UINT32)PhysAddrSgt;
+      Sge->DataAddressHigh = (UINT32)(PhysAddrSgt >> 32);
+      Sge->Attributes      = SGE_LNK;
+
+      Sge     = Command->Sgt[SgtIndex].Sge;
+      Entries = 4;
+      SgtIndex++;
+    }
+
+    Sge->DataAddressLow  = (UINT32)PhysAddr[Index];
+    Sge->DataAddressHigh = (UINT32)(PhysAddr[Index] >> 32);
+    Sge->DataCount       = (UINT32)Size[Index];
+    Sge->Attributes      = 0;
+    Sge++;
+    Entries--;
+  }
+  (Sge - 1)->Attributes = SGE_TRM;
+
+  return EFI_SUCCESS;
+
+UnmapBuffer:
+  for (Index = 0; Index < Task->MapCount; Index++) {
+    PciIo->Unmap (PciIo, Task->Mapping[Index]);
+  }
+  Task->MapCount = 0;
+  return Status;
+}
+
+/**
+  Complete the command of a slot: fill its status block and release its data mappings.
+
+  The slot of a non-blocking command is released and its event signaled. The slot of a
+  blocking command is released by the caller waiting on it.
+
+  Must be called at TPL_NOTIFY.
+
+**/
+STATIC
+VOID
+SiI3132CompleteSlot (
+  IN SATA_SI3132_PORT   *SataPort,
+  IN UINTN              Slot,
+  IN EFI_STATUS         CommandStatus
+  )
+{
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  SATA_SI3132_TASK                  *Task;
+  SATA_SI3132_DEVICE                *SataDevice;
+  ATA_IDENTIFY_DATA                 *IdentifyData;
+  UINTN                             Index;
+  EFI_STATUS                        Status;
+
+  PciIo  = SataPort->Instance->PciIo;
+  Task   = &SataPort->Tasks[Slot];
+  Packet = Task->Packet;
+
+  // Fill Packet Ata Status Block from the FIS received in the slot
+  Status = PciIo->Mem.Read (PciIo, EfiPciIoWidthUint32, 1, // Bar 1
+      SataPort->RegBase + (Slot * SII3132_PORT_SLOT_SIZE) + SII3132_PORT_SLOT_FIS,
+      sizeof (EFI_ATA_STATUS_BLOCK) / 4,
+      Packet->Asb);
+  ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (CommandStatus)) {
+    Packet->Asb->AtaStatus |= ATA_STSREG_ERR;
+  }
+
+  for (Index = 0; Index < Task->MapCount; Index++) {
+    Status = PciIo->Unmap (PciIo, Task->Mapping[Index]);
+    ASSERT (!EFI_ERROR (Status));
+  }
+  Task->MapCount = 0;
+
+  // If the command was ATA_CMD_IDENTIFY_DRIVE then we need to update the BlockSize
+  if (!EFI_ERROR (CommandStatus) && (Packet->Acb->AtaCommand == ATA_CMD_IDENTIFY_DRIVE)) {
+    IdentifyData = (ATA_IDENTIFY_DATA*)Packet->InDataBuffer;
+
+    // Get the corresponding Block Device
+    SataDevice = GetSataDevice (SataPort->Instance, SataPort->Index, Task->PortMultiplierPort);
+    ASSERT (SataDevice != NULL);
+
+    // Check logical block size
+    if ((IdentifyData->phy_logic_sector_support & BIT12) != 0) {
+      SataDevice->BlockSize = (UINT32) (((IdentifyData->logic_sector_size_hi << 16) |
+                                          IdentifyData->logic_sector_size_lo) * sizeof (UINT16));
+    } else {
+      SataDevice->BlockSize = 0x200;
+    }
+  }
+
+  Task->Status = CommandStatus;
+  Task->Done   = TRUE;
+  SataPort->ActiveSlots &= ~(1U << Slot);
+
+  if (Task->Event != NULL) {
+    SataPort->SlotsInUse &= ~(1U << Slot);
+    gBS->SignalEvent (Task->Event);
+  }
+}
+
+/**
+  Fail all the commands pending on a port and reinitialize the port so it accepts new ones.
+
+  Must be called at TPL_NOTIFY.
+
+**/
+STATIC
+VOID
+SiI3132RecoverPort (
+  IN SATA_SI3132_PORT   *SataPort,
+  IN EFI_STATUS         CommandStatus
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  UINT32                Value32, Error;
+  UINTN                 Slot;
+  UINTN                 Timeout;
+
+  PciIo = SataPort->Instance->PciIo;
+
+  SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_CMDERROR_REG, &Error);
+  DEBUG ((EFI_D_ERROR, "SiI3132RecoverPort(%d) %r (SiI3132 Err:0x%X)\n", SataPort->Index, CommandStatus, Error));
+
+  for (Slot = 0; Slot < SATA_SII3132_MAXSLOT; Slot++) {
+    if ((SataPort->ActiveSlots & (1U << Slot)) != 0) {
+      SiI3132CompleteSlot (SataPort, Slot, CommandStatus);
+    }
+  }
+
+  // Port Initialize aborts the commands left in the slots
+  SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CONTROLSET_REG, SII3132_PORT_CONTROL_INT);
+
+  SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_STATUS_REG, &Value32);
+  Timeout = 1000;
+  while ((Timeout > 0) &&
+         (((Value32 & SII3132_PORT_CONTROL_INT) != 0) || ((Value32 & SII3132_PORT_STATUS_PORTREADY) == 0))) {
+    gBS->Stall (1);
+    Timeout--;
+    SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_STATUS_REG, &Value32);
+  }
+  if (Timeout == 0) {
+    DEBUG ((EFI_D_ERROR, "SiI3132RecoverPort(%d) Port Not Ready\n", SataPort->Index));
+  }
+
+  // Clear IRQ
+  SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, SII3132_PORT_INT_CMD_STATUS);
+}
+
+/**
+  Complete the commands whose slot has been released by the controller, and recover the port
+  if the controller reports an error.
+
+  Must be called at TPL_NOTIFY.
+
+**/
+STATIC
+VOID
+SiI3132PollPort (
+  IN SATA_SI3132_PORT   *SataPort
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  UINT32                SlotStatus;
+  UINTN                 Slot;
+
+  PciIo = SataPort->Instance->PciIo;
+
+  // Clear Command Complete, the slot status tells which commands are done
+  SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, SII3132_PORT_INT_CMDCOMPL << 16);
+  SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_SLOTSTATUS_REG, &SlotStatus);
+
+  for (Slot = 0; Slot < SATA_SII3132_MAXSLOT; Slot++) {
+    if (((SataPort->ActiveSlots & (1U << Slot)) != 0) && ((SlotStatus & (1U << Slot)) == 0)) {
+      SiI3132CompleteSlot (SataPort, Slot, EFI_SUCCESS);
+    }
+  }
+
+  if ((SlotStatus & SII3132_PORT_SLOTSTATUS_ATTENTION) != 0) {
+    SiI3132RecoverPort (SataPort, EFI_DEVICE_ERROR);
+  }
+}
+
+/**
+  Periodic timer completing the non-blocking commands.
+
+  Like the blocking path, the command timeout is counted in microseconds.
+
+**/
+VOID
+EFIAPI
+SiI3132OnTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  SATA_SI3132_INSTANCE  *SataSiI3132Instance;
+  SATA_SI3132_PORT      *SataPort;
+  SATA_SI3132_TASK      *Task;
+  UINTN                 Index;
+  UINTN                 Slot;
+  BOOLEAN               TimedOut;
+
+  SataSiI3132Instance = (SATA_SI3132_INSTANCE*)Context;
+
+  for (Index = 0; Index < SATA_SII3132_MAXPORT; Index++) {
+    SataPort = &SataSiI3132Instance->Ports[Index];
+    if (SataPort->ActiveSlots == 0) {
+      continue;
+    }
+
+    SiI3132PollPort (SataPort);
+
+    TimedOut = FALSE;
+    for (Slot = 0; Slot < SATA_SII3132_MAXSLOT; Slot++) {
+      Task = &SataPort->Tasks[Slot];
+      if (((SataPort->ActiveSlots & (1U << Slot)) == 0) ||
+          (Task->Event == NULL) || (Task->Timeout == 0)) {
+        continue;
+      }
+
+      if (Task->Timeout <= (SATA_SII3132_POLL_PERIOD / 10)) {
+        TimedOut = TRUE;
+      } else {
+        Task->Timeout -= SATA_SII3132_POLL_PERIOD / 10;
+      }
+    }
+
+    if (TimedOut) {
+      SiI3132RecoverPort (SataPort, EFI_TIMEOUT);
+    }
+  }
+}
+
 EFI_STATUS
 EFIAPI
 SiI3132AtaPassThruCommand (
@@ -56,22 +347,53 @@ SiI3132AtaPassThruCommand (
   IN     EFI_EVENT                        Event OPTIONAL
   )
 {
-  SATA_SI3132_DEVICE      *SataDevice;
-  EFI_PHYSICAL_ADDRESS    PhysInDataBuffer;
-  UINTN                   InDataBufferLength = 0;
-  EFI_PHYSICAL_ADDRESS    PhysOutDataBuffer;
-  UINTN                   OutDataBufferLength;
-  CONST UINTN             EmptySlot = 0;
-  UINTN                   Control = PRB_CTRL_ATA;
-  UINTN                   Protocol = 0;
-  UINT32                  Value32, Error, Timeout = 0;
-  CONST UINT32            IrqMask = (SII3132_PORT_INT_CMDCOMPL | SII3132_PORT_INT_CMDERR) << 16;
-  EFI_STATUS              Status;
-  VOID*                   PciAllocMapping = NULL;
-  EFI_PCI_IO_PROTOCOL     *PciIo;
+  SATA_SI3132_DEVICE            *SataDevice;
+  SATA_SI3132_COMMAND           *Command;
+  SATA_SI3132_TASK              *Task;
+  EFI_PHYSICAL_ADDRESS          PhysAddrCommand;
+  VOID                          *DataBuffer = NULL;
+  UINTN                         DataBufferLength = 0;
+  EFI_PCI_IO_PROTOCOL_OPERATION Operation = EfiPciIoOperationBusMasterRead;
+  UINTN                         Slot;
+  UINTN                         Control = PRB_CTRL_ATA;
+  UINTN                         Protocol = 0;
+  UINT64                        Timeout;
+  BOOLEAN                       Done;
+  EFI_TPL                       OldTpl;
+  EFI_STATUS                    Status;
+  EFI_PCI_IO_PROTOCOL           *PciIo;
 
   PciIo = SataSiI3132Instance->PciIo;
-  ZeroMem (SataPort->HostPRB, sizeof (SATA_SI3132_PRB));
+
+  // Without the polling timer, non-blocking requests are performed as blocking ones
+  if ((SataSiI3132Instance->AtaPassThruProtocol.Mode->Attributes & EFI_ATA_PASS_THRU_ATTRIBUTES_NONBLOCKIO) == 0) {
+    Event = NULL;
+  }
+
+  // Find a free command slot
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Slot = 0; Slot < SATA_SII3132_MAXSLOT; Slot++) {
+    if ((SataPort->SlotsInUse & (1U << Slot)) == 0) {
+      SataPort->SlotsInUse |= (1U << Slot);
+      break;
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  if (Slot == SATA_SII3132_MAXSLOT) {
+    return EFI_NOT_READY;
+  }
+
+  Command         = &SataPort->HostCommand[Slot];
+  PhysAddrCommand = SataPort->PhysAddrHostCommand + (Slot * sizeof (SATA_SI3132_COMMAND));
+  Task            = &SataPort->Tasks[Slot];
+
+  ZeroMem (Command, sizeof (SATA_SI3132_COMMAND));
+  ZeroMem (Task, sizeof (SATA_SI3132_TASK));
+  Task->Packet             = Packet;
+  Task->Event              = Event;
+  Task->PortMultiplierPort = PortMultiplierPort;
+  Task->Timeout            = Packet->Timeout;
 
   // Construct Si3132 PRB
   switch (Packet->Protocol) {
@@ -83,7 +405,7 @@ SiI3132AtaPassThruCommand (
     Control = PRB_CTRL_SRST;
 
     if (FeaturePcdGet (PcdSataSiI3132FeaturePMPSupport)) {
-        SataPort->HostPRB->Fis.Control = 0x0F;
+        Command->Prb.Fis.Control = 0x0F;
     }
     break;
   case EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA:
@@ -96,74 +418,32 @@ SiI3132AtaPassThruCommand (
     // Fixup the size for block transfer. Following UEFI Specification, 'InTransferLength' should
     // be in number of bytes. But for most data transfer commands, the value is in number of blocks
     if (Packet->Acb->AtaCommand == ATA_CMD_IDENTIFY_DRIVE) {
-      InDataBufferLength = Packet->InTransferLength;
+      DataBufferLength = Packet->InTransferLength;
     } else {
       SataDevice = GetSataDevice (SataSiI3132Instance, SataPort->Index, PortMultiplierPort);
       if (!SataDevice || (SataDevice->BlockSize == 0)) {
-        return EFI_INVALID_PARAMETER;
+        Status = EFI_INVALID_PARAMETER;
+        goto ReleaseSlot;
       }
 
-      InDataBufferLength = Packet->InTransferLength * SataDevice->BlockSize;
-    }
-
-    Status = PciIo->Map (
-               PciIo, EfiPciIoOperationBusMasterWrite,
-               Packet->InDataBuffer, &InDataBufferLength, &PhysInDataBuffer, &PciAllocMapping
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    // Construct SGEs (32-bit system)
-    SataPort->HostPRB->Sge[0].DataAddressLow = (UINT32)PhysInDataBuffer;
-    SataPort->HostPRB->Sge[0].DataAddressHigh = (UINT32)(PhysInDataBuffer >> 32);
-    SataPort->HostPRB->Sge[0].Attributes = SGE_TRM; // Only one SGE
-    SataPort->HostPRB->Sge[0].DataCount = InDataBufferLength;
-
-    // Copy the Ata Command Block
-    CopyMem (&SataPort->HostPRB->Fis, Packet->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
-
-    // Fixup the FIS
-    SataPort->HostPRB->Fis.FisType = 0x27; // Register - Host to Device FIS
-    SataPort->HostPRB->Fis.Control = 1 << 7; // Is a command
-    if (FeaturePcdGet (PcdSataSiI3132FeaturePMPSupport)) {
-      SataPort->HostPRB->Fis.Control |= PortMultiplierPort & 0xFF;
+      DataBufferLength = Packet->InTransferLength * SataDevice->BlockSize;
     }
+    DataBuffer = Packet->InDataBuffer;
+    Operation  = EfiPciIoOperationBusMasterWrite;
     break;
   case EFI_ATA_PASS_THRU_PROTOCOL_UDMA_DATA_OUT:
   case EFI_ATA_PASS_THRU_PROTOCOL_PIO_DATA_OUT:
     SataDevice = GetSataDevice (SataSiI3132Instance, SataPort->Index, PortMultiplierPort);
     if (!SataDevice || (SataDevice->BlockSize == 0)) {
-      return EFI_INVALID_PARAMETER;
+      Status = EFI_INVALID_PARAMETER;
+      goto ReleaseSlot;
     }
 
     // Fixup the size for block transfer. Following UEFI Specification, 'InTransferLength' should
     // be in number of bytes. But for most data transfer commands, the value is in number of blocks
-    OutDataBufferLength = Packet->OutTransferLength * SataDevice->BlockSize;
-
-    Status = PciIo->Map (
-               PciIo, EfiPciIoOperationBusMasterRead,
-               Packet->OutDataBuffer, &OutDataBufferLength, &PhysOutDataBuffer, &PciAllocMapping
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
-
-    // Construct SGEs (32-bit system)
-    SataPort->HostPRB->Sge[0].DataAddressLow  = (UINT32)PhysOutDataBuffer;
-    SataPort->HostPRB->Sge[0].DataAddressHigh = (UINT32)(PhysOutDataBuffer >> 32);
-    SataPort->HostPRB->Sge[0].Attributes      = SGE_TRM; // Only one SGE
-    SataPort->HostPRB->Sge[0].DataCount       = OutDataBufferLength;
-
-    // Copy the Ata Command Block
-    CopyMem (&SataPort->HostPRB->Fis, Packet->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
-
-    // Fixup the FIS
-    SataPort->HostPRB->Fis.FisType = 0x27; // Register - Host to Device FIS
-    SataPort->HostPRB->Fis.Control = 1 << 7; // Is a command
-    if (FeaturePcdGet (PcdSataSiI3132FeaturePMPSupport)) {
-      SataPort->HostPRB->Fis.Control |= PortMultiplierPort & 0xFF;
-    }
+    DataBufferLength = Packet->OutTransferLength * SataDevice->BlockSize;
+    DataBuffer       = Packet->OutDataBuffer;
+    Operation        = EfiPciIoOperationBusMasterRead;
     break;
   case EFI_ATA_PASS_THRU_PROTOCOL_DMA:
     ASSERT (0); //TODO: Implement me!
@@ -178,7 +458,25 @@ SiI3132AtaPassThruCommand (
     ASSERT (0); //TODO: Implement me!
     break;
   case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
-    ASSERT (0); //TODO: Implement me!
+    // Native Command Queuing (READ/WRITE FPDMA QUEUED), the transfer length is in blocks
+    SataDevice = GetSataDevice (SataSiI3132Instance, SataPort->Index, PortMultiplierPort);
+    if (!SataDevice || (SataDevice->BlockSize == 0)) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ReleaseSlot;
+    }
+
+    if (Packet->InTransferLength != 0) {
+      DataBufferLength = Packet->InTransferLength * SataDevice->BlockSize;
+      DataBuffer       = Packet->InDataBuffer;
+      Operation        = EfiPciIoOperationBusMasterWrite;
+      Protocol         = PRB_PROT_NATIVE_QUEUE | PRB_PROT_READ;
+    } else {
+      DataBufferLength = Packet->OutTransferLength * SataDevice->BlockSize;
+      DataBuffer       = Packet->OutDataBuffer;
+      Operation        = EfiPciIoOperationBusMasterRead;
+      Protocol         = PRB_PROT_NATIVE_QUEUE | PRB_PROT_WRITE;
+    }
+    Control = PRB_CTRL_PROT_OVERRIDE;
     break;
   case EFI_ATA_PASS_THRU_PROTOCOL_RETURN_RESPONSE:
     ASSERT (0); //TODO: Implement me!
@@ -188,105 +486,89 @@ SiI3132AtaPassThruCommand (
     break;
   }
 
-  SataPort->HostPRB->Control = Control;
-  SataPort->HostPRB->ProtocolOverride = Protocol;
+  if (DataBuffer != NULL) {
+    if (DataBufferLength != 0) {
+      Status = SiI3132MapDataBuffer (PciIo, Command, PhysAddrCommand, Task, Operation, DataBuffer, DataBufferLength);
+      if (EFI_ERROR (Status)) {
+        goto ReleaseSlot;
+      }
+    }
 
-  // Clear IRQ
-  SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, IrqMask);
+    // Copy the Ata Command Block
+    CopyMem (&Command->Prb.Fis, Packet->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
 
-  if (!FeaturePcdGet (PcdSataSiI3132FeatureDirectCommandIssuing)) {
-    // Indirect Command Issuance
+    // Fixup the FIS
+    Command->Prb.Fis.FisType = 0x27; // Register - Host to Device FIS
+    Command->Prb.Fis.Control = 1 << 7; // Is a command
+    if (FeaturePcdGet (PcdSataSiI3132FeaturePMPSupport)) {
+      Command->Prb.Fis.Control |= PortMultiplierPort & 0xFF;
+    }
+
+    // The queue tag of a FPDMA command is its slot, in the bits 7:3 of the Sector Count
+    if (Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+      Command->Prb.Fis.Fis[8] = (UINT8)(Slot << 3);
+    }
+  }
 
-    //TODO: Find which slot is free (maybe use the Cmd FIFO)
-    //SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_CMDEXECFIFO_REG, &EmptySlot);
+  Command->Prb.Control = Control;
+  Command->Prb.ProtocolOverride = Protocol;
 
-    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDACTIV_REG + (EmptySlot * 8),
-                     (UINT32)(SataPort->PhysAddrHostPRB & 0xFFFFFFFF));
-    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDACTIV_REG + (EmptySlot * 8) + 4,
-                     (UINT32)((SataPort->PhysAddrHostPRB >> 32) & 0xFFFFFFFF));
+  // Issue and mark the slot active atomically, so the polling only sees issued commands
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (!FeaturePcdGet (PcdSataSiI3132FeatureDirectCommandIssuing)) {
+    // Indirect Command Issuance
+    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDACTIV_REG + (Slot * 8),
+                     (UINT32)(PhysAddrCommand & 0xFFFFFFFF));
+    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDACTIV_REG + (Slot * 8) + 4,
+                     (UINT32)((PhysAddrCommand >> 32) & 0xFFFFFFFF));
   } else {
-    // Direct Command Issuance
+    // Direct Command Issuance, the SGTs stay in host memory
     Status = PciIo->Mem.Write (PciIo, EfiPciIoWidthUint32, 1, // Bar 1
-        SataPort->RegBase + (EmptySlot * 0x80),
+        SataPort->RegBase + (Slot * SII3132_PORT_SLOT_SIZE),
         sizeof (SATA_SI3132_PRB) / 4,
-        SataPort->HostPRB);
+        &Command->Prb);
     ASSERT_EFI_ERROR (Status);
 
-    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDEXECFIFO_REG, EmptySlot);
+    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_CMDEXECFIFO_REG, (UINT32)Slot);
   }
+  SataPort->ActiveSlots |= (1U << Slot);
+  gBS->RestoreTPL (OldTpl);
 
-#if 0
-  // Could need to be implemented if we run multiple command in parallel to know which slot has been completed
-  SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_SLOTSTATUS_REG, &Value32);
-  Timeout = Packet->Timeout;
-  while (!Timeout && !Value32) {
-    gBS->Stall (1);
-    SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_SLOTSTATUS_REG, &Value32);
-    Timeout--;
+  // Non-blocking command, completed by SiI3132OnTimer()
+  if (Event != NULL) {
+    return EFI_SUCCESS;
   }
-#else
-  SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, &Value32);
-  if (!Packet->Timeout) {
-    while (!(Value32 & IrqMask)) {
-      gBS->Stall (1);
-      SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, &Value32);
+
+  // Wait for the slot to complete. The timeout is counted in microseconds, 0 waits forever
+  Timeout = Packet->Timeout;
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (!Task->Done) {
+      SiI3132PollPort (SataPort);
     }
-  } else {
-    Timeout = Packet->Timeout;
-    while (Timeout && !(Value32 & IrqMask)) {
-      gBS->Stall (1);
-      SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, &Value32);
-      Timeout--;
+    if (!Task->Done && (Packet->Timeout != 0) && (Timeout == 0)) {
+      DEBUG ((EFI_D_ERROR, "SiI3132AtaPassThru() Err:Timeout\n"));
+      SiI3132RecoverPort (SataPort, EFI_TIMEOUT);
     }
-  }
-#endif
-  // Fill Packet Ata Status Block
-  Status = PciIo->Mem.Read (PciIo, EfiPciIoWidthUint32, 1, // Bar 1
-      SataPort->RegBase + 0x08,
-      sizeof (EFI_ATA_STATUS_BLOCK) / 4,
-      Packet->Asb);
-  ASSERT_EFI_ERROR (Status);
+    Done = Task->Done;
+    gBS->RestoreTPL (OldTpl);
 
-
-  if ((Packet->Timeout != 0) && (Timeout == 0)) {
-    DEBUG ((EFI_D_ERROR, "SiI3132AtaPassThru() Err:Timeout\n"));
-    //ASSERT (0);
-    return EFI_TIMEOUT;
-  } else if (Value32 & (SII3132_PORT_INT_CMDERR << 16)) {
-    SATA_PORT_READ32 (SataPort->RegBase + SII3132_PORT_CMDERROR_REG, &Error);
-    DEBUG ((EFI_D_ERROR, "SiI3132AtaPassThru() CmdErr:0x%X (SiI3132 Err:0x%X)\n", Value32, Error));
-    ASSERT (0);
-    return EFI_DEVICE_ERROR;
-  } else if (Value32 & (SII3132_PORT_INT_CMDCOMPL << 16)) {
-    // Clear Command Complete
-    SATA_PORT_WRITE32 (SataPort->RegBase + SII3132_PORT_INTSTATUS_REG, SII3132_PORT_INT_CMDCOMPL << 16);
-
-    if (PciAllocMapping != NULL) {
-      Status = PciIo->Unmap (PciIo, PciAllocMapping);
-      ASSERT (!EFI_ERROR (Status));
+    if (Done) {
+      break;
     }
-
-    // If the command was ATA_CMD_IDENTIFY_DRIVE then we need to update the BlockSize
-    if (Packet->Acb->AtaCommand == ATA_CMD_IDENTIFY_DRIVE) {
-      ATA_IDENTIFY_DATA *IdentifyData = (ATA_IDENTIFY_DATA*)Packet->InDataBuffer;
-
-      // Get the corresponding Block Device
-      SataDevice = GetSataDevice (SataSiI3132Instance, SataPort->Index, PortMultiplierPort);
-
-      // Check logical block size
-      if ((IdentifyData->phy_logic_sector_support & BIT12) != 0) {
-        ASSERT (SataDevice != NULL);
-        SataDevice->BlockSize = (UINT32) (((IdentifyData->logic_sector_size_hi << 16) |
-                                            IdentifyData->logic_sector_size_lo) * sizeof (UINT16));
-      } else {
-        SataDevice->BlockSize = 0x200;
-      }
+    gBS->Stall (1);
+    if (Timeout != 0) {
+      Timeout--;
     }
-    return EFI_SUCCESS;
-  } else {
-    ASSERT (0);
-    return EFI_DEVICE_ERROR;
   }
+  Status = Task->Status;
+
+ReleaseSlot:
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  SataPort->SlotsInUse &= ~(1U << Slot);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
 }
 
 /**
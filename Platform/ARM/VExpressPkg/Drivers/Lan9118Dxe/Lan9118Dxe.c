@@ -1312,15 +1312,8 @@ SnpReceive (
   LAN9118_DRIVER  *LanDriver;
   UINT32          IntSts;
   UINT32          RxFifoStatus;
-  UINT32          NumPackets;
-  UINT32          RxCfgValue;
   UINT32          PLength; // Packet length
   UINT32          ReadLimit;
-  UINT32          Count;
-  UINT32          Padding;
-  UINT32          *RawData;
-  EFI_MAC_ADDRESS Dst;
-  EFI_MAC_ADDRESS Src;
   UINTN           DroppedFrames;
   EFI_STATUS      Status;
 
@@ -1366,17 +1359,45 @@ SnpReceive (
     Lan9118MmioWrite32 (LAN9118_INT_STS, INSTS_RXE);
   }
 
-  // Count dropped frames
-  DroppedFrames = Lan9118MmioRead32 (LAN9118_RX_DROP);
-  LanDriver->Stats.RxDroppedFrames += DroppedFrames;
+  //
+  // The Rx Status FIFO level and the drop counter are only sampled again
+  // once the frames found at the previous sampling have all been received,
+  // rather than once per frame.
+  //
+  if (LanDriver->RxFramesPending == 0) {
+    // Count dropped frames
+    DroppedFrames = Lan9118MmioRead32 (LAN9118_RX_DROP);
+    LanDriver->Stats.RxDroppedFrames += DroppedFrames;
+
+    LanDriver->RxFramesPending = RxStatusUsedSpace (0, Snp) / 4;
+    if (LanDriver->RxFramesPending == 0) {
+      return EFI_NOT_READY;
+    }
+  }
 
-  NumPackets = RxStatusUsedSpace (0, Snp) / 4;
-  if (!NumPackets) {
-    return EFI_NOT_READY;
+  //
+  // Peek at the Rx Status first: the frame is left in the FIFOs if the
+  // caller's buffer turns out to be too small for it.
+  //
+  RxFifoStatus = Lan9118MmioRead32 (LAN9118_RX_STATUS_PEEK);
+
+  // Get the received packet length, the FIFO pads it to a DWORD boundary
+  PLength = GET_RXSTATUS_PACKET_LENGTH(RxFifoStatus);
+  ReadLimit = (PLength + 3) / 4;
+
+  if ((RxFifoStatus & (RXSTATUS_MII_ERROR | RXSTATUS_RXW_TO | RXSTATUS_FTL |
+                       RXSTATUS_LCOLL | RXSTATUS_LE | RXSTATUS_DB |
+                       RXSTATUS_CRC_ERROR | RXSTATUS_RUNT)) == 0) {
+    // Check buffer size
+    if (*BuffSize < (ReadLimit * 4)) {
+      *BuffSize = ReadLimit * 4;
+      return EFI_BUFFER_TOO_SMALL;
+    }
   }
 
-  // Read Rx Status (only if not empty)
+  // Pop the Rx Status
   RxFifoStatus = Lan9118MmioRead32 (LAN9118_RX_STATUS);
+  LanDriver->RxFramesPending -= 1;
   LanDriver->Stats.RxTotalFrames += 1;
 
   // First check for errors
@@ -1388,6 +1409,7 @@ SnpReceive (
       (RxFifoStatus & RXSTATUS_DB))
   {
     DEBUG ((EFI_D_WARN, "Warning: There was an error on frame reception.\n"));
+    DiscardRxData (ReadLimit);
     return EFI_DEVICE_ERROR;
   }
 
@@ -1396,6 +1418,7 @@ SnpReceive (
     DEBUG ((EFI_D_WARN, "Warning: Crc Error\n"));
     LanDriver->Stats.RxCrcErrorFrames += 1;
     LanDriver->Stats.RxDroppedFrames += 1;
+    DiscardRxData (ReadLimit);
     return EFI_DEVICE_ERROR;
   }
 
@@ -1404,6 +1427,7 @@ SnpReceive (
     DEBUG ((EFI_D_WARN, "Warning: Runt Frame\n"));
     LanDriver->Stats.RxUndersizeFrames += 1;
     LanDriver->Stats.RxDroppedFrames += 1;
+    DiscardRxData (ReadLimit);
     return EFI_DEVICE_ERROR;
   }
 
@@ -1428,35 +1452,8 @@ SnpReceive (
     LanDriver->Stats.RxUnicastFrames += 1;
   }
 
-  // Get the received packet length
-  PLength = GET_RXSTATUS_PACKET_LENGTH(RxFifoStatus);
   LanDriver->Stats.RxTotalBytes += (PLength - 4);
 
-  // If padding is applied, read more DWORDs
-  if (PLength % 4) {
-    Padding = 4 - (PLength % 4);
-    ReadLimit = (PLength + Padding)/4;
-  } else {
-    ReadLimit = PLength/4;
-    Padding = 0;
-  }
-
-  // Check buffer size
-  if (*BuffSize < (PLength + Padding)) {
-    *BuffSize = PLength + Padding;
-    return EFI_BUFFER_TOO_SMALL;
-  }
-
-  // Set the amount of data to be transferred out of FIFO for THIS packet
-  // This can be used to trigger an interrupt, and status can be checked
-  RxCfgValue = Lan9118MmioRead32 (LAN9118_RX_CFG);
-  RxCfgValue &= ~(RXCFG_RX_DMA_CNT_MASK);
-  RxCfgValue |= RXCFG_RX_DMA_CNT (ReadLimit);
-
-  // Set end alignment to 4-bytes
-  RxCfgValue &= ~(RXCFG_RX_END_ALIGN_MASK);
-  Lan9118MmioWrite32 (LAN9118_RX_CFG, RxCfgValue);
-
   // Update buffer size
   *BuffSize = PLength; // -4 bytes may be needed: Received in buffer as
                        // 4 bytes longer than packet actually is, unless
@@ -1465,39 +1462,22 @@ SnpReceive (
   if (HdrSize != NULL)
     *HdrSize = Snp->Mode->MediaHeaderSize;
 
-  // Format the pointer
-  RawData = (UINT32*)Data;
-
-  // Read Rx Packet
-  for (Count = 0; Count < ReadLimit; Count++) {
-    RawData[Count] = Lan9118MmioRead32 (LAN9118_RX_DATA);
-  }
+  // Read Rx Packet straight into the caller's buffer
+  ReadRxData ((UINT32*)Data, ReadLimit);
 
   // Get the destination address
   if (DstAddr != NULL) {
-    Dst.Addr[0] = (RawData[0] & 0xFF);
-    Dst.Addr[1] = (RawData[0] & 0xFF00) >> 8;
-    Dst.Addr[2] = (RawData[0] & 0xFF0000) >> 16;
-    Dst.Addr[3] = (RawData[0] & 0xFF000000) >> 24;
-    Dst.Addr[4] = (RawData[1] & 0xFF);
-    Dst.Addr[5] = (RawData[1] & 0xFF00) >> 8;
-    CopyMem (DstAddr, &Dst, NET_ETHER_ADDR_LEN);
+    CopyMem (DstAddr, Data, NET_ETHER_ADDR_LEN);
   }
 
   // Get the source address
   if (SrcAddr != NULL) {
-    Src.Addr[0] = (RawData[1] & 0xFF0000) >> 16;
-    Src.Addr[1] = (RawData[1] & 0xFF000000) >> 24;
-    Src.Addr[2] = (RawData[2] & 0xFF);
-    Src.Addr[3] = (RawData[2] & 0xFF00) >> 8;
-    Src.Addr[4] = (RawData[2] & 0xFF0000) >> 16;
-    Src.Addr[5] = (RawData[2] & 0xFF000000) >> 24;
-    CopyMem (SrcAddr, &Src, NET_ETHER_ADDR_LEN);
+    CopyMem (SrcAddr, (UINT8*)Data + NET_ETHER_ADDR_LEN, NET_ETHER_ADDR_LEN);
   }
 
   // Get the protocol
   if (Protocol != NULL) {
-    *Protocol = NTOHS (RawData[3] & 0xFFFF);
+    *Protocol = NTOHS (ReadUnaligned16 ((UINT16*)((UINT8*)Data + 2 * NET_ETHER_ADDR_LEN)));
   }
 
   // Check for Rx errors (worst possible error)
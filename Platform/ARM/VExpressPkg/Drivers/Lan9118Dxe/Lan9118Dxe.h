@@ -70,6 +70,9 @@ typedef struct {
   // Saved transmitted buffers so we can notify consumers when packets have been sent.
   UINT16  NextPacketTag;
   VOID    *TxRing[LAN9118_TX_RING_NUM_ENTRIES];
+
+  // Frames known to be in the Rx Status FIFO since it was last sampled.
+  UINT32  RxFramesPending;
 } LAN9118_DRIVER;
 
 #define LAN9118_SIGNATURE                       SIGNATURE_32('l', 'a', 'n', '9')
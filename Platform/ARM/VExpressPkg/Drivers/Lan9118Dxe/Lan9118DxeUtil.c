@@ -770,6 +770,8 @@ StopRx (
     Lan9118MmioWrite32 (LAN9118_RX_CFG, RxCfg);
 
     while (Lan9118MmioRead32 (LAN9118_RX_CFG) & RXCFG_RX_DUMP);
+
+    INSTANCE_FROM_SNP_THIS (Snp)->RxFramesPending = 0;
   }
 
   return EFI_SUCCESS;
@@ -841,8 +843,16 @@ StartRx (
       Lan9118MmioWrite32 (LAN9118_RX_CFG, RxCfg);
 
       while (Lan9118MmioRead32 (LAN9118_RX_CFG) & RXCFG_RX_DUMP);
+
+      INSTANCE_FROM_SNP_THIS (Snp)->RxFramesPending = 0;
     }
 
+    // Frames are read whole by the CPU: 4-byte end alignment, no data
+    // offset and no DMA count.
+    RxCfg = Lan9118MmioRead32 (LAN9118_RX_CFG);
+    RxCfg &= ~(RXCFG_RX_END_ALIGN_MASK | RXCFG_RXDOFF_MASK | RXCFG_RX_DMA_CNT_MASK);
+    Lan9118MmioWrite32 (LAN9118_RX_CFG, RxCfg);
+
     MacCsr |= MACCR_RX_EN;
     IndirectMACWrite32 (INDIRECT_MAC_INDEX_CR, MacCsr);
   }
@@ -918,6 +928,48 @@ RxStatusUsedSpace (
   return UsedSpace << 2; // Value in bytes
 }
 
+/*
+ * Read Count DWORDs of a frame out of the Rx Data FIFO.
+ *
+ * Back-to-back pops of the Rx Data FIFO have no timing restriction, so the
+ * dummy reads are only needed once, after the last pop, before the FIFO
+ * information or status registers are accessed again.
+ */
+VOID
+ReadRxData (
+  OUT UINT32 *Buffer,
+  IN  UINTN  Count
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Buffer[Index] = MmioRead32 (LAN9118_RX_DATA);
+  }
+  WaitDummyReads (LAN9118_RX_DATA_RD_DELAY);
+}
+
+/*
+ * Drop the Count DWORDs of the frame at the head of the Rx Data FIFO, after
+ * its status has been popped. The controller can only fast-forward frames of
+ * at least four DWORDs, shorter ones are read out.
+ */
+VOID
+DiscardRxData (
+  IN  UINTN  Count
+  )
+{
+  if (Count >= 4) {
+    Lan9118MmioWrite32 (LAN9118_RX_DP_CTL, RXDPCTL_RX_FFWD);
+    while (Lan9118MmioRead32 (LAN9118_RX_DP_CTL) & RXDPCTL_RX_FFWD);
+  } else {
+    while (Count--) {
+      MmioRead32 (LAN9118_RX_DATA);
+    }
+    WaitDummyReads (LAN9118_RX_DATA_RD_DELAY);
+  }
+}
+
 
 // Change the allocation of FIFOs
 EFI_STATUS
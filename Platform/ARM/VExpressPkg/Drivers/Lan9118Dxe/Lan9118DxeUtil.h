@@ -252,6 +252,19 @@ RxStatusUsedSpace (
   EFI_SIMPLE_NETWORK_PROTOCOL *Snp
   );
 
+// Read a frame out of the Rx Data FIFO
+VOID
+ReadRxData (
+  OUT UINT32 *Buffer,
+  IN  UINTN  Count
+  );
+
+// Drop a frame from the Rx Data FIFO
+VOID
+DiscardRxData (
+  IN  UINTN  Count
+  );
+
 
 // Flags for FIFO allocation
 #define ALLOC_USE_DEFAULT                 BIT0
@@ -28,6 +28,20 @@ EFI_MMC_HOST_PROTOCOL     *gpMmcHost;
 #define MMCI0_POW2_BLOCKLEN     9
 #define MMCI0_TIMEOUT           1000
 
+// Largest multiple of the block length the data length register can hold
+#define MMCI0_MAX_TRANSFER      ((MCI_DATA_LENGTH_MAX / MMCI0_BLOCKLEN) * MMCI0_BLOCKLEN)
+
+// Whether the card takes a byte address rather than a block address in data commands
+STATIC BOOLEAN mMciByteAddressing;
+
+// CMD18 accepted by MciSendCommand () but only sent by MciReadBlockData (), and its argument
+STATIC BOOLEAN mMciReadPending;
+STATIC UINT32  mMciDataArgument;
+
+// OCR bits of the final ACMD41/CMD1 response
+#define MCI_OCR_POWERUP_DONE    BIT31
+#define MCI_OCR_SECTOR_MODE     BIT30
+
 #define SYS_MCI_CARDIN          BIT0
 #define SYS_MCI_WPROT           BIT1
 
@@ -86,12 +100,13 @@ GetPow2BlockLen (
 
 VOID
 MciPrepareDataPath (
-  IN UINTN TransferDirection
+  IN UINTN TransferDirection,
+  IN UINTN Length
   )
 {
   // Set Data Length & Data Timer
   MmioWrite32 (MCI_DATA_TIMER_REG, 0xFFFFFFF);
-  MmioWrite32 (MCI_DATA_LENGTH_REG, MMCI0_BLOCKLEN);
+  MmioWrite32 (MCI_DATA_LENGTH_REG, Length);
 
 #ifndef USE_STREAM
   //Note: we are using a hardcoded BlockLen (==512). If we decide to use a variable size, we could
@@ -102,9 +117,10 @@ MciPrepareDataPath (
 #endif
 }
 
+// Send a command on the command path, the data path must already be armed
+STATIC
 EFI_STATUS
-MciSendCommand (
-  IN EFI_MMC_HOST_PROTOCOL     *This,
+MciIssueCommand (
   IN MMC_CMD                    MmcCmd,
   IN UINT32                     Argument
   )
@@ -117,29 +133,6 @@ MciSendCommand (
 
   RetVal = EFI_SUCCESS;
 
-  if ((MmcCmd == MMC_CMD17) || (MmcCmd == MMC_CMD11)) {
-    MciPrepareDataPath (MCI_DATACTL_CARD_TO_CONT);
-  } else if ((MmcCmd == MMC_CMD24) || (MmcCmd == MMC_CMD20)) {
-    MciPrepareDataPath (MCI_DATACTL_CONT_TO_CARD);
-  } else if (MmcCmd == MMC_CMD6) {
-    MmioWrite32 (MCI_DATA_TIMER_REG, 0xFFFFFFF);
-    MmioWrite32 (MCI_DATA_LENGTH_REG, 64);
-#ifndef USE_STREAM
-    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | GetPow2BlockLen (64));
-#else
-    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | MCI_DATACTL_STREAM_TRANS);
-#endif
-  } else if (MmcCmd == MMC_ACMD51) {
-    MmioWrite32 (MCI_DATA_TIMER_REG, 0xFFFFFFF);
-    /* SCR register is 8 bytes long. */
-    MmioWrite32 (MCI_DATA_LENGTH_REG, 8);
-#ifndef USE_STREAM
-    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | GetPow2BlockLen (8));
-#else
-    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | MCI_DATACTL_STREAM_TRANS);
-#endif
-  }
-
   // Create Command for PL180
   Cmd = (MMC_GET_INDX (MmcCmd) & INDX_MASK)  | MCI_CPSM_ENABLE;
   if (MmcCmd & MMC_CMD_WAIT_RESPONSE) {
@@ -188,6 +181,56 @@ MciSendCommand (
   return RetVal;
 }
 
+EFI_STATUS
+MciSendCommand (
+  IN EFI_MMC_HOST_PROTOCOL     *This,
+  IN MMC_CMD                    MmcCmd,
+  IN UINT32                     Argument
+  )
+{
+  //
+  // The card starts sending data as soon as it gets CMD18, the read data path
+  // must be armed before. Its length is only known in MciReadBlockData(),
+  // which sends the command.
+  //
+  mMciReadPending = FALSE;
+  if (MmcCmd == MMC_CMD18) {
+    mMciDataArgument = Argument;
+    mMciReadPending  = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The data path of multi-block writes (CMD25) is only armed by
+  // MciWriteBlockData(), once the transfer length is known. The card waits
+  // for the data.
+  //
+  if ((MmcCmd == MMC_CMD17) || (MmcCmd == MMC_CMD11)) {
+    MciPrepareDataPath (MCI_DATACTL_CARD_TO_CONT, MMCI0_BLOCKLEN);
+  } else if ((MmcCmd == MMC_CMD24) || (MmcCmd == MMC_CMD20)) {
+    MciPrepareDataPath (MCI_DATACTL_CONT_TO_CARD, MMCI0_BLOCKLEN);
+  } else if (MmcCmd == MMC_CMD6) {
+    MmioWrite32 (MCI_DATA_TIMER_REG, 0xFFFFFFF);
+    MmioWrite32 (MCI_DATA_LENGTH_REG, 64);
+#ifndef USE_STREAM
+    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | GetPow2BlockLen (64));
+#else
+    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | MCI_DATACTL_STREAM_TRANS);
+#endif
+  } else if (MmcCmd == MMC_ACMD51) {
+    MmioWrite32 (MCI_DATA_TIMER_REG, 0xFFFFFFF);
+    /* SCR register is 8 bytes long. */
+    MmioWrite32 (MCI_DATA_LENGTH_REG, 8);
+#ifndef USE_STREAM
+    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | GetPow2BlockLen (8));
+#else
+    MmioWrite32 (MCI_DATA_CTL_REG, MCI_DATACTL_ENABLE | MCI_DATACTL_CARD_TO_CONT | MCI_DATACTL_STREAM_TRANS);
+#endif
+  }
+
+  return MciIssueCommand (MmcCmd, Argument);
+}
+
 EFI_STATUS
 MciReceiveResponse (
   IN EFI_MMC_HOST_PROTOCOL     *This,
@@ -206,6 +249,14 @@ MciReceiveResponse (
       || (Type == MMC_RESPONSE_TYPE_R7))
   {
     Buffer[0] = MmioRead32 (MCI_RESPONSE3_REG);
+
+    //
+    // The OCR of a powered up card tells whether data commands take a block
+    // or a byte address
+    //
+    if ((Type == MMC_RESPONSE_TYPE_R3) && ((Buffer[0] & MCI_OCR_POWERUP_DONE) != 0)) {
+      mMciByteAddressing = (BOOLEAN)((Buffer[0] & MCI_OCR_SECTOR_MODE) == 0);
+    }
   } else if (Type == MMC_RESPONSE_TYPE_R2) {
     Buffer[0] = MmioRead32 (MCI_RESPONSE0_REG);
     Buffer[1] = MmioRead32 (MCI_RESPONSE1_REG);
@@ -216,194 +267,254 @@ MciReceiveResponse (
   return EFI_SUCCESS;
 }
 
+// Wait for the data path to complete the current transfer
+STATIC
 EFI_STATUS
-MciReadBlockData (
-  IN EFI_MMC_HOST_PROTOCOL     *This,
-  IN EFI_LBA                    Lba,
-  IN UINTN                      Length,
-  IN UINT32*                    Buffer
+MciWaitDataEnd (
+  IN UINT32 DoneMask,
+  IN UINT32 ErrorMask
   )
 {
-  UINTN Loop;
-  UINTN Finish;
-  UINTN Status;
-  EFI_STATUS RetVal;
-  UINTN  DataCtrlReg;
-  EFI_TPL Tpl;
+  UINTN  Timer;
+  UINT32 Status;
 
-  RetVal = EFI_SUCCESS;
+  Timer  = MMCI0_TIMEOUT * 60;
+  Status = MmioRead32 (MCI_STATUS_REG);
+  while (((Status & DoneMask) != DoneMask) && ((Status & ErrorMask) == 0) && Timer) {
+    NanoSecondDelay(10);
+    Status = MmioRead32 (MCI_STATUS_REG);
+    Timer--;
+  }
 
-  // Read data from the RX FIFO
-  Loop   = 0;
-  if (Length < MMCI0_BLOCKLEN) {
-    Finish = Length / 4;
-  } else {
-    Finish = MMCI0_BLOCKLEN / 4;
+  if (Status & ErrorMask) {
+    DEBUG ((EFI_D_ERROR, "MciWaitDataEnd(): Error! Status:0x%x\n", Status));
+    return (Status & MCI_STATUS_CMD_DATATIMEOUT) ? EFI_TIMEOUT : EFI_CRC_ERROR;
   }
 
-  // Raise the TPL at the highest level to disable Interrupts.
-  Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  if (Timer == 0) {
+    DEBUG ((EFI_D_ERROR, "MciWaitDataEnd(): Data End timeout Status:0x%x\n", Status));
+    return EFI_TIMEOUT;
+  }
 
-  do {
+  // Clear Status flags before the data path is armed again
+  MmioWrite32 (MCI_CLEAR_STATUS_REG, MCI_CLR_ALL_STATUS);
+  return EFI_SUCCESS;
+}
+
+// Drain Count words of the RX FIFO, eight at a time while it is half full
+STATIC
+EFI_STATUS
+MciReadFifo (
+  IN UINT32* Buffer,
+  IN UINTN   Count
+  )
+{
+  UINTN  Loop;
+  UINTN  Index;
+  UINT32 Status;
+
+  Loop = 0;
+  while (Loop < Count) {
     // Read the Status flags
     Status = MmioRead32 (MCI_STATUS_REG);
 
     // Do eight reads if possible else a single read
-    if (Status & MCI_STATUS_CMD_RXFIFOHALFFULL) {
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
+    if ((Status & MCI_STATUS_CMD_RXFIFOHALFFULL) && (Count - Loop >= MCI_FIFO_HALF_SIZE)) {
+      for (Index = 0; Index < MCI_FIFO_HALF_SIZE; Index++) {
+        Buffer[Loop++] = MmioRead32 (MCI_FIFO_REG);
+      }
     } else if (Status & MCI_STATUS_CMD_RXDATAAVAILBL) {
-      Buffer[Loop] = MmioRead32(MCI_FIFO_REG);
-      Loop++;
+      Buffer[Loop++] = MmioRead32 (MCI_FIFO_REG);
     } else {
       //Check for error conditions and timeouts
       if (Status & MCI_STATUS_CMD_DATATIMEOUT) {
         DEBUG ((EFI_D_ERROR, "MciReadBlockData(): TIMEOUT! Response:0x%X Status:0x%x\n", MmioRead32 (MCI_RESPONSE0_REG), Status));
-        RetVal = EFI_TIMEOUT;
-        break;
+        return EFI_TIMEOUT;
       } else if (Status & MCI_STATUS_CMD_DATACRCFAIL) {
         DEBUG ((EFI_D_ERROR, "MciReadBlockData(): CRC Error! Response:0x%X Status:0x%x\n", MmioRead32 (MCI_RESPONSE0_REG), Status));
-        RetVal = EFI_CRC_ERROR;
-        break;
+        return EFI_CRC_ERROR;
       } else if (Status & MCI_STATUS_CMD_START_BIT_ERROR) {
         DEBUG ((EFI_D_ERROR, "MciReadBlockData(): Start-bit Error! Response:0x%X Status:0x%x\n", MmioRead32 (MCI_RESPONSE0_REG), Status));
-        RetVal = EFI_NO_RESPONSE;
-        break;
+        return EFI_NO_RESPONSE;
       }
     }
     //clear RX over run flag
     if(Status & MCI_STATUS_CMD_RXOVERRUN) {
       MmioWrite32(MCI_CLEAR_STATUS_REG, MCI_STATUS_CMD_RXOVERRUN);
     }
-  } while ((Loop < Finish));
-
-  // Restore Tpl
-  gBS->RestoreTPL (Tpl);
-
-  // Clear Status flags
-  MmioWrite32 (MCI_CLEAR_STATUS_REG, MCI_CLR_ALL_STATUS);
-
-  //Disable Data path
-  DataCtrlReg = MmioRead32 (MCI_DATA_CTL_REG);
-  MmioWrite32 (MCI_DATA_CTL_REG, (DataCtrlReg & MCI_DATACTL_DISABLE_MASK));
+  }
 
-  return RetVal;
+  return EFI_SUCCESS;
 }
 
+// Fill the TX FIFO with Count words, eight at a time while it is half empty
+STATIC
 EFI_STATUS
-MciWriteBlockData (
-  IN EFI_MMC_HOST_PROTOCOL     *This,
-  IN EFI_LBA                   Lba,
-  IN UINTN                     Length,
-  IN UINT32*                   Buffer
+MciWriteFifo (
+  IN UINT32* Buffer,
+  IN UINTN   Count
   )
 {
-  UINTN Loop;
-  UINTN Finish;
-  UINTN Timer;
-  UINTN Status;
-  EFI_STATUS RetVal;
-  UINTN  DataCtrlReg;
-  EFI_TPL Tpl;
-
-  RetVal = EFI_SUCCESS;
-
-  // Write the data to the TX FIFO
-  Loop   = 0;
-  Finish = MMCI0_BLOCKLEN / 4;
-  Timer  = MMCI0_TIMEOUT * 100;
-
-  // Raise the TPL at the highest level to disable Interrupts.
-  Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  UINTN  Loop;
+  UINTN  Index;
+  UINT32 Status;
 
-  do {
+  Loop = 0;
+  while (Loop < Count) {
     // Read the Status flags
     Status = MmioRead32 (MCI_STATUS_REG);
 
     // Do eight writes if possible else a single write
-    if (Status & MCI_STATUS_CMD_TXFIFOHALFEMPTY) {
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
-      MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-      Loop++;
+    if ((Status & MCI_STATUS_CMD_TXFIFOHALFEMPTY) && (Count - Loop >= MCI_FIFO_HALF_SIZE)) {
+      for (Index = 0; Index < MCI_FIFO_HALF_SIZE; Index++) {
+        MmioWrite32 (MCI_FIFO_REG, Buffer[Loop++]);
+      }
     } else if (!(Status & MCI_STATUS_CMD_TXFIFOFULL)) {
-        MmioWrite32(MCI_FIFO_REG, Buffer[Loop]);
-        Loop++;
+      MmioWrite32 (MCI_FIFO_REG, Buffer[Loop++]);
     } else {
       // Check for error conditions and timeouts
       if (Status & MCI_STATUS_CMD_DATATIMEOUT) {
         DEBUG ((EFI_D_ERROR, "MciWriteBlockData(): TIMEOUT! Response:0x%X Status:0x%x\n", MmioRead32 (MCI_RESPONSE0_REG), Status));
-        RetVal = EFI_TIMEOUT;
-        goto Exit;
+        return EFI_TIMEOUT;
       } else if (Status & MCI_STATUS_CMD_DATACRCFAIL) {
         DEBUG ((EFI_D_ERROR, "MciWriteBlockData(): CRC Error! Response:0x%X Status:0x%x\n", MmioRead32 (MCI_RESPONSE0_REG), Status));
-        RetVal = EFI_CRC_ERROR;
-        goto Exit;
+        return EFI_CRC_ERROR;
       } else if (Status & MCI_STATUS_CMD_TX_UNDERRUN) {
         DEBUG ((EFI_D_ERROR, "MciWriteBlockData(): TX buffer Underrun! Response:0x%X Status:0x%x, Number of bytes written 0x%x\n",MmioRead32(MCI_RESPONSE0_REG),Status, Loop));
-        RetVal = EFI_BUFFER_TOO_SMALL;
         ASSERT(0);
-        goto Exit;
+        return EFI_BUFFER_TOO_SMALL;
       }
     }
-  } while (Loop < Finish);
+  }
 
-  // Restore Tpl
-  gBS->RestoreTPL (Tpl);
+  return EFI_SUCCESS;
+}
 
-  // Wait for FIFO to drain
-  Timer  = MMCI0_TIMEOUT * 60;
-  Status = MmioRead32 (MCI_STATUS_REG);
+EFI_STATUS
+MciReadBlockData (
+  IN EFI_MMC_HOST_PROTOCOL     *This,
+  IN EFI_LBA                    Lba,
+  IN UINTN                      Length,
+  IN UINT32*                    Buffer
+  )
+{
+  UINTN Chunk;
+  EFI_STATUS RetVal;
+  UINTN  DataCtrlReg;
+  EFI_TPL Tpl;
+  UINT64 BlocksDone;
+  UINT32 Argument;
+
+  RetVal = EFI_SUCCESS;
+  BlocksDone = 0;
+
+  //
+  // Read data from the RX FIFO. Multi-block reads longer than the data length
+  // register can hold are split. The PL180 cannot hold off the card, so the
+  // read is stopped with CMD12 at the end of each part and a new CMD18 is
+  // sent for the next one, at the argument MmcDxe gave plus the blocks read
+  // so far.
+  //
+  while ((Length > 0) && !EFI_ERROR (RetVal)) {
+    Chunk = MIN (Length, MMCI0_MAX_TRANSFER);
+
+    // Raise the TPL at the highest level to disable Interrupts.
+    Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+
+    if (mMciReadPending) {
+      if (BlocksDone != 0) {
+        RetVal = MciIssueCommand (MMC_CMD12, 0);
+      }
+      if (!EFI_ERROR (RetVal)) {
+        Argument = mMciDataArgument +
+                   (UINT32)BlocksDone * (mMciByteAddressing ? MMCI0_BLOCKLEN : 1);
+        MciPrepareDataPath (MCI_DATACTL_CARD_TO_CONT, Chunk);
+        RetVal = MciIssueCommand (MMC_CMD18, Argument);
+      }
+    } else if ((MmioRead32 (MCI_DATA_CTL_REG) & MCI_DATACTL_ENABLE) == 0) {
+      MciPrepareDataPath (MCI_DATACTL_CARD_TO_CONT, Chunk);
+    }
+
+    if (!EFI_ERROR (RetVal)) {
+      RetVal = MciReadFifo (Buffer, Chunk / 4);
+    }
+    if (!EFI_ERROR (RetVal)) {
+      RetVal = MciWaitDataEnd (MCI_STATUS_CMD_DATAEND, MCI_STATUS_READ_ERROR & ~MCI_STATUS_CMD_RXOVERRUN);
+    }
+
+    // Disable Data path
+    DataCtrlReg = MmioRead32 (MCI_DATA_CTL_REG);
+    MmioWrite32 (MCI_DATA_CTL_REG, (DataCtrlReg & MCI_DATACTL_DISABLE_MASK));
+
+    // Restore Tpl
+    gBS->RestoreTPL (Tpl);
+
+    Buffer += Chunk / 4;
+    Length -= Chunk;
+    BlocksDone += Chunk / MMCI0_BLOCKLEN;
+  }
+
+  mMciReadPending = FALSE;
+
+  // Clear Status flags
+  MmioWrite32 (MCI_CLEAR_STATUS_REG, MCI_CLR_ALL_STATUS);
+
+  return RetVal;
+}
+
+EFI_STATUS
+MciWriteBlockData (
+  IN EFI_MMC_HOST_PROTOCOL     *This,
+  IN EFI_LBA                   Lba,
+  IN UINTN                     Length,
+  IN UINT32*                   Buffer
+  )
+{
+  UINTN Chunk;
+  EFI_STATUS RetVal;
+  UINTN  DataCtrlReg;
+  EFI_TPL Tpl;
+
+  RetVal = EFI_SUCCESS;
+
+  //
+  // Write the data to the TX FIFO. As for reads, multi-block writes are split
+  // on the size the data length register can hold.
+  //
+  while ((Length > 0) && !EFI_ERROR (RetVal)) {
+    Chunk = MIN (Length, MMCI0_MAX_TRANSFER);
+    if ((MmioRead32 (MCI_DATA_CTL_REG) & MCI_DATACTL_ENABLE) == 0) {
+      MciPrepareDataPath (MCI_DATACTL_CONT_TO_CARD, Chunk);
+    }
+
+    // Raise the TPL at the highest level to disable Interrupts.
+    Tpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+    RetVal = MciWriteFifo (Buffer, Chunk / 4);
+    // Restore Tpl
+    gBS->RestoreTPL (Tpl);
+
+    // Wait for FIFO to drain
+    if (!EFI_ERROR (RetVal)) {
 #ifndef USE_STREAM
-  // Single block
-  while (((Status & MCI_STATUS_TXDONE) != MCI_STATUS_TXDONE) && Timer) {
+      // Block transfer
+      RetVal = MciWaitDataEnd (MCI_STATUS_TXDONE, 0);
 #else
-  // Stream
-  while (((Status & MCI_STATUS_CMD_DATAEND) != MCI_STATUS_CMD_DATAEND) && Timer) {
+      // Stream
+      RetVal = MciWaitDataEnd (MCI_STATUS_CMD_DATAEND, 0);
 #endif
-    NanoSecondDelay(10);
-    Status = MmioRead32 (MCI_STATUS_REG);
-    Timer--;
+    }
+
+    // Disable Data path
+    DataCtrlReg = MmioRead32 (MCI_DATA_CTL_REG);
+    MmioWrite32 (MCI_DATA_CTL_REG, (DataCtrlReg & MCI_DATACTL_DISABLE_MASK));
+
+    Buffer += Chunk / 4;
+    Length -= Chunk;
   }
 
   // Clear Status flags
   MmioWrite32 (MCI_CLEAR_STATUS_REG, MCI_CLR_ALL_STATUS);
 
-  if (Timer == 0) {
-    DEBUG ((EFI_D_ERROR, "MciWriteBlockData(): Data End timeout Number of words written 0x%x\n", Loop));
-    RetVal = EFI_TIMEOUT;
-  }
-
-Exit:
-  // Disable Data path
-  DataCtrlReg = MmioRead32 (MCI_DATA_CTL_REG);
-  MmioWrite32 (MCI_DATA_CTL_REG, (DataCtrlReg & MCI_DATACTL_DISABLE_MASK));
   return RetVal;
 }
 
@@ -499,6 +610,14 @@ MciNotifyState (
   return EFI_SUCCESS;
 }
 
+BOOLEAN
+MciIsMultiBlock (
+  IN EFI_MMC_HOST_PROTOCOL      *This
+  )
+{
+  return TRUE;
+}
+
 EFI_GUID mPL180MciDevicePathGuid = EFI_CALLER_ID_GUID;
 
 EFI_STATUS
@@ -525,7 +644,9 @@ EFI_MMC_HOST_PROTOCOL gMciHost = {
   MciSendCommand,
   MciReceiveResponse,
   MciReadBlockData,
-  MciWriteBlockData
+  MciWriteBlockData,
+  NULL,
+  MciIsMultiBlock
 };
 
 EFI_STATUS
@@ -61,6 +61,10 @@
 #define MCI_PCELL_ID_REG2               (MCI_SYSCTL + 0xFF8)
 #define MCI_PCELL_ID_REG3               (MCI_SYSCTL + 0xFFC)
 
+// The data length register is 16 bits wide, the FIFO is 16 words deep
+#define MCI_DATA_LENGTH_MAX             0xFFFF
+#define MCI_FIFO_HALF_SIZE              8
+
 #define MCI_PERIPH_ID0                  0x80
 #define MCI_PERIPH_ID1                  0x11
 #define MCI_PERIPH_ID2                  0x04
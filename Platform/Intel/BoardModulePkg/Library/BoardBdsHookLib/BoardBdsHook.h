@@ -171,6 +171,39 @@ ConnectSequence (
   );
 
 
+/**
+  Connects the devices recorded by the last boot.
+
+  @retval TRUE   All recorded devices were connected.
+  @retval FALSE  There is no valid record, the configuration changed or a
+                 device could not be connected.
+**/
+BOOLEAN
+ConnectFastBootDevices (
+  VOID
+  );
+
+/**
+  Records the device of the boot option being started, for
+  ConnectFastBootDevices to connect on the next boot.
+**/
+VOID
+RecordFastBootDevices (
+  VOID
+  );
+
+/**
+  Prints device paths.
+  @param Name           The device name.
+  @param DevicePath     The device path to be printed
+**/
+VOID
+EFIAPI
+DumpDevicePath (
+  IN CHAR16           *Name,
+  IN EFI_DEVICE_PATH  *DevicePath
+  );
+
 /**
    Compares boot priorities of two boot options
 
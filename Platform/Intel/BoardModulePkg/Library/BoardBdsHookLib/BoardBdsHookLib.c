@@ -25,6 +25,7 @@
 
 GLOBAL_REMOVE_IF_UNREFERENCED EFI_BOOT_MODE    gBootMode;
 BOOLEAN                                        gPPRequireUIConfirm;
+BOOLEAN                                        mFastBootConnected = FALSE;
 extern UINTN                                   mBootMenuOptionNumber;
 
 
@@ -994,6 +995,9 @@ EnumUsbKeyboard (
   Connect with predeined platform connect sequence,
   the OEM/IBV can customize with their own connect sequence.
 
+  When PcdFastBootEnable is set, only the devices used by the last boot are
+  connected, unless the configuration changed or one of them fails.
+
   @param[in] BootMode          Boot mode of this boot.
 **/
 VOID
@@ -1001,6 +1005,16 @@ ConnectSequence (
   IN EFI_BOOT_MODE         BootMode
   )
 {
+  if (FeaturePcdGet (PcdFastBootEnable) &&
+      (BootMode != BOOT_WITH_DEFAULT_SETTINGS) &&
+      (BootMode != BOOT_WITH_FULL_CONFIGURATION_PLUS_DIAGNOSTICS) &&
+      (BootMode != BOOT_IN_RECOVERY_MODE)) {
+    mFastBootConnected = ConnectFastBootDevices ();
+    if (mFastBootConnected) {
+      return;
+    }
+  }
+
   EfiBootManagerConnectAll ();
 }
 
@@ -1257,6 +1271,10 @@ BdsReadyToBootCallback (
 {
   DEBUG ((DEBUG_INFO, "BdsReadyToBootCallback\n"));
 
+  if (FeaturePcdGet (PcdFastBootEnable)) {
+    RecordFastBootDevices ();
+  }
+
   if (BootCurrentIsInternalShell ()) {
 
     ChangeModeForInternalShell ();
@@ -1364,8 +1382,13 @@ BdsAfterConsoleReadyBeforeBootOptionCallback (
       //
       // PXE boot option may appear after boot option enumeration
       //
+      // With the devices of the last boot connected the configuration is
+      // unchanged, so are the boot options
+      //
 
-      EfiBootManagerRefreshAllBootOption ();
+      if (!mFastBootConnected) {
+        EfiBootManagerRefreshAllBootOption ();
+      }
       DataSize = sizeof (BOOLEAN);
       Status = gRT->GetVariable (
                       IS_FIRST_BOOT_VAR_NAME,
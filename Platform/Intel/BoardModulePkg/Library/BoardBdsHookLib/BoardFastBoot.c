@@ -0,0 +1,268 @@
+/** @file
+  Fast boot support for the BDS hook library.
+
+  A full configuration boot connects every controller in the system. When
+  PcdFastBootEnable is set, the device used by the last boot is recorded
+  together with a fingerprint of the PCI configuration, and the next boot
+  connects only that device as long as the fingerprint still matches.
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BoardBdsHook.h"
+#include <Library/UefiBootManagerLib.h>
+
+#define FAST_BOOT_DEVICE_PATH_VAR_NAME  L"FastBootDevicePath"
+
+//
+// The variable holds the fingerprint followed by a multi-instance device path
+//
+typedef struct {
+  UINT32    Fingerprint;
+} FAST_BOOT_CACHE_HEADER;
+
+UINT32  mConfigurationFingerprint = 0;
+
+/**
+  Calculates a fingerprint of the PCI devices present and of BootOrder.
+
+  The PCI devices are identified by their device path and their vendor and
+  device IDs. The fingerprint does not depend on the handle order.
+
+  @return The fingerprint, never 0.
+**/
+UINT32
+GetConfigurationFingerprint (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  UINTN                     HandleCount;
+  EFI_HANDLE                *HandleBuffer;
+  UINTN                     Index;
+  EFI_PCI_IO_PROTOCOL       *PciIo;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  UINT32                    Id;
+  UINT32                    Crc;
+  UINT32                    Fingerprint;
+  UINT16                    *BootOrder;
+  UINTN                     BootOrderSize;
+
+  Fingerprint = 0;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiPciIoProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &HandleBuffer
+                  );
+  if (!EFI_ERROR (Status)) {
+    for (Index = 0; Index < HandleCount; Index++) {
+      Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiPciIoProtocolGuid, (VOID **) &PciIo);
+      if (EFI_ERROR (Status)) {
+        continue;
+      }
+
+      Id = MAX_UINT32;
+      PciIo->Pci.Read (PciIo, EfiPciIoWidthUint32, PCI_VENDOR_ID_OFFSET, 1, &Id);
+      Fingerprint += CalculateCrc32 (&Id, sizeof (Id));
+
+      DevicePath = DevicePathFromHandle (HandleBuffer[Index]);
+      if (DevicePath != NULL) {
+        Fingerprint += CalculateCrc32 (DevicePath, GetDevicePathSize (DevicePath));
+      }
+    }
+
+    FreePool (HandleBuffer);
+  }
+
+  GetEfiGlobalVariable2 (L"BootOrder", (VOID **) &BootOrder, &BootOrderSize);
+  if (BootOrder != NULL) {
+    Crc = CalculateCrc32 (BootOrder, BootOrderSize);
+    Fingerprint = ((Fingerprint << 1) | (Fingerprint >> 31)) ^ Crc;
+    FreePool (BootOrder);
+  }
+
+  return (Fingerprint == 0) ? 1 : Fingerprint;
+}
+
+/**
+  Connects the devices recorded by the last boot.
+
+  The fingerprint of the current configuration is saved for
+  RecordFastBootDevices.
+
+  @retval TRUE   All recorded devices were connected.
+  @retval FALSE  There is no valid record, the configuration changed or a
+                 device could not be connected. The record is deleted in the
+                 last two cases.
+**/
+BOOLEAN
+ConnectFastBootDevices (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  FAST_BOOT_CACHE_HEADER    *Cache;
+  UINTN                     CacheSize;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Instance;
+  UINTN                     Size;
+  BOOLEAN                   Connected;
+
+  mConfigurationFingerprint = GetConfigurationFingerprint ();
+
+  GetVariable2 (FAST_BOOT_DEVICE_PATH_VAR_NAME, &gEfiCallerIdGuid, (VOID **) &Cache, &CacheSize);
+  if (Cache == NULL) {
+    return FALSE;
+  }
+
+  Connected = FALSE;
+  if ((CacheSize < sizeof (FAST_BOOT_CACHE_HEADER) + END_DEVICE_PATH_LENGTH) ||
+      !IsDevicePathValid ((EFI_DEVICE_PATH_PROTOCOL *) (Cache + 1), CacheSize - sizeof (FAST_BOOT_CACHE_HEADER)) ||
+      IsDevicePathEnd ((EFI_DEVICE_PATH_PROTOCOL *) (Cache + 1))) {
+    DEBUG ((DEBUG_INFO, "FastBoot: invalid record\n"));
+  } else if (Cache->Fingerprint != mConfigurationFingerprint) {
+    DEBUG ((DEBUG_INFO, "FastBoot: configuration changed\n"));
+  } else {
+    Connected  = TRUE;
+    DevicePath = (EFI_DEVICE_PATH_PROTOCOL *) (Cache + 1);
+    while (Connected && !IsDevicePathEnd (DevicePath)) {
+      Instance = GetNextDevicePathInstance (&DevicePath, &Size);
+      if (Instance == NULL) {
+        break;
+      }
+
+      DumpDevicePath (L"FastBoot", Instance);
+      Status = EfiBootManagerConnectDevicePath (Instance, NULL);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_INFO, "FastBoot: connect failed - %r\n", Status));
+        Connected = FALSE;
+      }
+
+      FreePool (Instance);
+      if (DevicePath == NULL) {
+        break;
+      }
+    }
+  }
+
+  if (!Connected) {
+    gRT->SetVariable (FAST_BOOT_DEVICE_PATH_VAR_NAME, &gEfiCallerIdGuid, 0, 0, NULL);
+  }
+
+  FreePool (Cache);
+  return Connected;
+}
+
+/**
+  Records the device of the boot option being started, for
+  ConnectFastBootDevices to connect on the next boot.
+
+  Called on ReadyToBoot. File path nodes are dropped. Options inside a
+  firmware volume need no device at all, so the record is deleted for them
+  and the next boot connects everything. The variable is only written when
+  the record changes, to avoid a flash write on every boot.
+**/
+VOID
+RecordFastBootDevices (
+  VOID
+  )
+{
+  EFI_STATUS                    Status;
+  UINT16                        BootCurrent;
+  UINTN                         VarSize;
+  CHAR16                        BootOptionName[16];
+  EFI_BOOT_MANAGER_LOAD_OPTION  BootOption;
+  EFI_DEVICE_PATH_PROTOCOL      *FullPath;
+  EFI_DEVICE_PATH_PROTOCOL      *Node;
+  UINTN                         DeviceSize;
+  FAST_BOOT_CACHE_HEADER        *Cache;
+  UINTN                         CacheSize;
+  FAST_BOOT_CACHE_HEADER        *OldCache;
+  UINTN                         OldCacheSize;
+
+  if (mConfigurationFingerprint == 0) {
+    mConfigurationFingerprint = GetConfigurationFingerprint ();
+  }
+
+  VarSize = sizeof (UINT16);
+  Status = gRT->GetVariable (
+                  L"BootCurrent",
+                  &gEfiGlobalVariableGuid,
+                  NULL,
+                  &VarSize,
+                  &BootCurrent
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  UnicodeSPrint (BootOptionName, sizeof (BootOptionName), L"Boot%04X", BootCurrent);
+  Status = EfiBootManagerVariableToLoadOption (BootOptionName, &BootOption);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  //
+  // Expand a short-form device path, the boot device is already connected
+  //
+  FullPath = EfiBootManagerGetNextLoadOptionDevicePath (BootOption.FilePath, NULL);
+  if (FullPath == NULL) {
+    FullPath = DuplicateDevicePath (BootOption.FilePath);
+  }
+  EfiBootManagerFreeLoadOption (&BootOption);
+  if (FullPath == NULL) {
+    return;
+  }
+
+  DeviceSize = 0;
+  for (Node = FullPath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH) &&
+        ((DevicePathSubType (Node) == MEDIA_FILEPATH_DP) ||
+         (DevicePathSubType (Node) == MEDIA_PIWG_FW_VOL_DP) ||
+         (DevicePathSubType (Node) == MEDIA_PIWG_FW_FILE_DP))) {
+      break;
+    }
+    DeviceSize += DevicePathNodeLength (Node);
+  }
+
+  GetVariable2 (FAST_BOOT_DEVICE_PATH_VAR_NAME, &gEfiCallerIdGuid, (VOID **) &OldCache, &OldCacheSize);
+
+  if (DeviceSize == 0) {
+    //
+    // Nothing to connect, let the next boot connect all devices
+    //
+    if (OldCache != NULL) {
+      Status = gRT->SetVariable (FAST_BOOT_DEVICE_PATH_VAR_NAME, &gEfiCallerIdGuid, 0, 0, NULL);
+      DEBUG ((DEBUG_INFO, "FastBoot: delete record for %s - %r\n", BootOptionName, Status));
+    }
+  } else {
+    CacheSize = sizeof (FAST_BOOT_CACHE_HEADER) + DeviceSize + END_DEVICE_PATH_LENGTH;
+    Cache     = AllocatePool (CacheSize);
+    if (Cache != NULL) {
+      Cache->Fingerprint = mConfigurationFingerprint;
+      CopyMem (Cache + 1, FullPath, DeviceSize);
+      SetDevicePathEndNode ((UINT8 *) (Cache + 1) + DeviceSize);
+
+      if ((OldCache == NULL) || (OldCacheSize != CacheSize) || (CompareMem (OldCache, Cache, CacheSize) != 0)) {
+        Status = gRT->SetVariable (
+                        FAST_BOOT_DEVICE_PATH_VAR_NAME,
+                        &gEfiCallerIdGuid,
+                        EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                        CacheSize,
+                        Cache
+                        );
+        DEBUG ((DEBUG_INFO, "FastBoot: record %s - %r\n", BootOptionName, Status));
+      }
+      FreePool (Cache);
+    }
+  }
+
+  if (OldCache != NULL) {
+    FreePool (OldCache);
+  }
+  FreePool (FullPath);
+}
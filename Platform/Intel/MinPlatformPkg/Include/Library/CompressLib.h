@@ -9,6 +9,20 @@
 #ifndef _EFI_COMPRESS_LIB_H_
 #define _EFI_COMPRESS_LIB_H_
 
+//
+// Compression levels accepted by CompressWithLevel().
+//
+// COMPRESS_LEVEL_FAST uses a shallow hash-chain search with greedy parsing.
+// COMPRESS_LEVEL_DEFAULT uses a deeper hash-chain search with lazy matching.
+// COMPRESS_LEVEL_BEST uses the exhaustive tree search and produces the same
+// output as Compress().
+//
+// All levels produce a standard EFI compressed stream.
+//
+#define COMPRESS_LEVEL_FAST     1
+#define COMPRESS_LEVEL_DEFAULT  2
+#define COMPRESS_LEVEL_BEST     3
+
 /**
   The compression routine.
 
@@ -30,5 +44,30 @@ Compress (
   IN OUT  UINT64  *DstSize
   );
 
+/**
+  The compression routine with a selectable speed/ratio trade-off.
+
+  @param[in]       SrcBuffer     The buffer containing the source data.
+  @param[in]       SrcSize       Number of bytes in SrcBuffer.
+  @param[in]       DstBuffer     The buffer to put the compressed image in.
+  @param[in, out]  DstSize       On input the size (in bytes) of DstBuffer, on
+                                 return the number of bytes placed in DstBuffer.
+  @param[in]       Level         One of the COMPRESS_LEVEL_* values.
+
+  @retval EFI_SUCCESS           The compression was sucessful.
+  @retval EFI_BUFFER_TOO_SMALL  The buffer was too small.  DstSize is required.
+  @retval EFI_INVALID_PARAMETER Level is not a supported compression level.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for compression process.
+**/
+EFI_STATUS
+EFIAPI
+CompressWithLevel (
+  IN      VOID    *SrcBuffer,
+  IN      UINT64  SrcSize,
+  IN      VOID    *DstBuffer,
+  IN OUT  UINT64  *DstSize,
+  IN      UINTN   Level
+  );
+
 #endif
 
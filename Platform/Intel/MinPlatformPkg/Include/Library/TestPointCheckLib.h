@@ -454,6 +454,44 @@ TestPointReadyToBootEsrtTableFunctional (
   VOID
   );
 
+/**
+  This service verifies the PEI boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each PEIM and of the PEI phase, as recorded
+                 in the FPDT performance HOBs, is within the budget listed in
+                 PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxeBootPerformanceBudget (
+  VOID
+  );
+
+/**
+  This service verifies the boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each module and of each boot phase, as
+                 recorded in the FPDT boot performance table, is within the
+                 budget listed in PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  );
+
 /**
   This service verifies UEFI Secure Boot is enabled.
 
@@ -765,10 +803,27 @@ TestPointSmmExitBootServices (
 // Byte 8 - Advanced
 #define TEST_POINT_BYTE8_READY_TO_BOOT_ESRT_TABLE_FUNCTIONAL                                BIT0
 #define TEST_POINT_BYTE8_READY_TO_BOOT_HSTI_TABLE_FUNCTIONAL                                BIT1
+#define TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET                                 BIT2
+#define TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET                              BIT3
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_ESRT_TABLE_FUNCTIONAL_ERROR_CODE                        L"0x08000000"
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_ESRT_TABLE_FUNCTIONAL_ERROR_STRING                      L"No ESRT\r\n"
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_HSTI_TABLE_FUNCTIONAL_ERROR_CODE                        L"0x08010000"
 #define   TEST_POINT_BYTE8_READY_TO_BOOT_HSTI_TABLE_FUNCTIONAL_ERROR_STRING                      L"No HSTI\r\n"
+#define   TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET_ERROR_CODE                         L"0x08020000"
+#define   TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET_ERROR_STRING                       L"PEI boot performance budget exceeded\r\n"
+#define   TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_CODE                      L"0x08030000"
+#define   TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_STRING                    L"Boot performance budget exceeded\r\n"
+
+//
+// Budget types of a TEST_POINT_BOOT_PERFORMANCE_BUDGET entry.
+// Module types are matched by ModuleGuid, phase types ignore it.
+//
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_ENTRY_POINT                                 0x01
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_LOAD_IMAGE                                  0x02
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_DRIVER_BINDING_START                        0x03
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_PEI                                   0x10
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_DXE                                   0x11
+#define TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_BDS                                   0x12
 
 #pragma pack (1)
 
@@ -782,6 +837,15 @@ typedef struct {
   CHAR16  End;
 } ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT;
 
+//
+// Entry of PcdTestPointBootPerformanceBudget.
+//
+typedef struct {
+  EFI_GUID  ModuleGuid;
+  UINT32    Type;
+  UINT32    BudgetInUs;
+} TEST_POINT_BOOT_PERFORMANCE_BUDGET;
+
 #pragma pack ()
 
 #endif
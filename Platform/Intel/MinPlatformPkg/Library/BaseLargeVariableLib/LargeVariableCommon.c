@@ -0,0 +1,83 @@
+/** @file
+  Large Variable Lib Common Functions
+
+  Helpers shared by the Large Variable Read and Write libraries to access the
+  header variable describing a data set split across multiple variables.
+
+  Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+#include <Library/VariableReadLib.h>
+
+#include "LargeVariableCommon.h"
+
+/**
+  Reads and validates the header variable of a large variable.
+
+  @param[in]   VariableName    A Null-terminated string that is the name of the vendor's
+                               variable. Its length must be less than
+                               MAX_VARIABLE_NAME_SIZE - MAX_VARIABLE_SPLIT_DIGITS.
+  @param[in]   VendorGuid      A unique identifier for the vendor.
+  @param[out]  HeaderName      Buffer of MAX_VARIABLE_NAME_SIZE characters receiving the
+                               name of the header variable.
+  @param[out]  Header          The header contents.
+
+  @retval EFI_SUCCESS          The header exists and is consistent.
+  @retval EFI_NOT_FOUND        The header does not exist.
+  @retval EFI_VOLUME_CORRUPTED The header exists but is not valid.
+  @retval Others               The header could not be read.
+
+**/
+EFI_STATUS
+GetLargeVariableHeader (
+  IN  CHAR16                       *VariableName,
+  IN  EFI_GUID                     *VendorGuid,
+  OUT CHAR16                       *HeaderName,
+  OUT LARGE_VARIABLE_HEADER        *Header
+  )
+{
+  EFI_STATUS    Status;
+  UINTN         HeaderSize;
+  UINTN         Index;
+  UINT64        TotalSize;
+
+  ZeroMem (HeaderName, MAX_VARIABLE_NAME_SIZE);
+  UnicodeSPrint (HeaderName, MAX_VARIABLE_NAME_SIZE, L"%s%s", VariableName, LARGE_VARIABLE_HEADER_SUFFIX);
+
+  HeaderSize = sizeof (LARGE_VARIABLE_HEADER);
+  Status = VarLibGetVariable (HeaderName, VendorGuid, NULL, &HeaderSize, Header);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    DEBUG ((DEBUG_ERROR, "GetLargeVariableHeader: %s is too large\n", HeaderName));
+    return EFI_VOLUME_CORRUPTED;
+  }
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((HeaderSize < OFFSET_OF (LARGE_VARIABLE_HEADER, Chunk)) ||
+      (Header->Signature != LARGE_VARIABLE_HEADER_SIGNATURE) ||
+      (Header->ChunkCount == 0) ||
+      (Header->ChunkCount > MAX_LARGE_VARIABLE_HEADER_CHUNKS) ||
+      (HeaderSize != LARGE_VARIABLE_HEADER_SIZE (Header->ChunkCount))) {
+    DEBUG ((DEBUG_ERROR, "GetLargeVariableHeader: %s is not valid\n", HeaderName));
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  TotalSize = 0;
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    TotalSize += Header->Chunk[Index].Size;
+  }
+  if (TotalSize != Header->TotalSize) {
+    DEBUG ((DEBUG_ERROR, "GetLargeVariableHeader: %s size mismatch\n", HeaderName));
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+}
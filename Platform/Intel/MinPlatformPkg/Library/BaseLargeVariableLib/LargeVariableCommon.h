@@ -51,4 +51,63 @@
 //
 #define MAX_VARIABLE_NAME_PAD_SIZE  3
 
+//
+// When data is split across multiple variables, a header variable named
+// VariableName + LARGE_VARIABLE_HEADER_SUFFIX records the number of chunks and
+// the size and CRC32 of each of them. Readers can then size the data set and
+// fetch each chunk without probing for the next variable name, and writers can
+// skip chunks whose contents did not change. The suffix is shorter than
+// MAX_VARIABLE_SPLIT_DIGITS and cannot collide with a chunk name, which always
+// ends in a digit.
+//
+#define LARGE_VARIABLE_HEADER_SUFFIX      L"Hdr"
+#define LARGE_VARIABLE_HEADER_SIGNATURE   SIGNATURE_32 ('L', 'V', 'A', 'R')
+
+//
+// Data sets needing more chunks than this are stored without a header and
+// discovered by probing variable names, as before. This keeps the header small
+// enough to be read with a single call into a fixed size buffer.
+//
+#define MAX_LARGE_VARIABLE_HEADER_CHUNKS  64
+
+typedef struct {
+  UINT32    Size;
+  UINT32    Crc32;
+} LARGE_VARIABLE_CHUNK_INFO;
+
+typedef struct {
+  UINT32                       Signature;
+  UINT32                       ChunkCount;
+  UINT64                       TotalSize;
+  LARGE_VARIABLE_CHUNK_INFO    Chunk[MAX_LARGE_VARIABLE_HEADER_CHUNKS];
+} LARGE_VARIABLE_HEADER;
+
+#define LARGE_VARIABLE_HEADER_SIZE(ChunkCount) \
+  (OFFSET_OF (LARGE_VARIABLE_HEADER, Chunk) + (ChunkCount) * sizeof (LARGE_VARIABLE_CHUNK_INFO))
+
+/**
+  Reads and validates the header variable of a large variable.
+
+  @param[in]   VariableName    A Null-terminated string that is the name of the vendor's
+                               variable. Its length must be less than
+                               MAX_VARIABLE_NAME_SIZE - MAX_VARIABLE_SPLIT_DIGITS.
+  @param[in]   VendorGuid      A unique identifier for the vendor.
+  @param[out]  HeaderName      Buffer of MAX_VARIABLE_NAME_SIZE characters receiving the
+                               name of the header variable.
+  @param[out]  Header          The header contents.
+
+  @retval EFI_SUCCESS          The header exists and is consistent.
+  @retval EFI_NOT_FOUND        The header does not exist.
+  @retval EFI_VOLUME_CORRUPTED The header exists but is not valid.
+  @retval Others               The header could not be read.
+
+**/
+EFI_STATUS
+GetLargeVariableHeader (
+  IN  CHAR16                       *VariableName,
+  IN  EFI_GUID                     *VendorGuid,
+  OUT CHAR16                       *HeaderName,
+  OUT LARGE_VARIABLE_HEADER        *Header
+  );
+
 #endif  // _LARGE_VARIABLE_COMMON_H_
@@ -9,13 +9,15 @@
   In the case where more than one variable is needed to store the data, an
   integer number will be added to the end of the variable name. This number
   will be incremented for each variable as needed to retrieve the entire data
-  set.
+  set. A header variable, when present, describes the chunks so they can be
+  read without probing for variable names.
 
   Copyright (c) 2021, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
 
+#include <Uefi.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
@@ -24,6 +26,74 @@
 
 #include "LargeVariableCommon.h"
 
+/**
+  Reads a large variable using the chunk sizes recorded in its header variable.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's
+                                 variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[in]       Header        The validated header of the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+  @retval EFI_INVALID_PARAMETER  The DataSize is not too small and Data is NULL.
+  @retval EFI_VOLUME_CORRUPTED   The chunks do not match the header.
+  @retval Others                 A chunk could not be read.
+
+**/
+STATIC
+EFI_STATUS
+GetLargeVariableFromHeader (
+  IN     CHAR16                      *VariableName,
+  IN     EFI_GUID                    *VendorGuid,
+  IN     LARGE_VARIABLE_HEADER       *Header,
+  IN OUT UINTN                       *DataSize,
+  OUT    VOID                        *Data           OPTIONAL
+  )
+{
+  CHAR16        TempVariableName[MAX_VARIABLE_NAME_SIZE];
+  EFI_STATUS    Status;
+  UINTN         Index;
+  UINTN         VariableSize;
+  UINT8         *OffsetPtr;
+
+  if (*DataSize < Header->TotalSize) {
+    *DataSize = (UINTN) Header->TotalSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  if (Data == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OffsetPtr = (UINT8 *) Data;
+  for (Index = 0; Index < Header->ChunkCount; Index++) {
+    ZeroMem (TempVariableName, MAX_VARIABLE_NAME_SIZE);
+    UnicodeSPrint (TempVariableName, MAX_VARIABLE_NAME_SIZE, L"%s%d", VariableName, Index);
+    VariableSize = Header->Chunk[Index].Size;
+    DEBUG ((DEBUG_INFO, "Reading %s, Guid = %g,", TempVariableName, VendorGuid));
+    Status = VarLibGetVariable (TempVariableName, VendorGuid, NULL, &VariableSize, (VOID *) OffsetPtr);
+    DEBUG ((DEBUG_INFO, " Size %d\n", VariableSize));
+    if (Status == EFI_BUFFER_TOO_SMALL || Status == EFI_NOT_FOUND) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+    if ((VariableSize != Header->Chunk[Index].Size) ||
+        (CalculateCrc32 (OffsetPtr, VariableSize) != Header->Chunk[Index].Crc32)) {
+      DEBUG ((DEBUG_ERROR, "GetLargeVariable: %s does not match the header\n", TempVariableName));
+      return EFI_VOLUME_CORRUPTED;
+    }
+    OffsetPtr += VariableSize;
+  }
+
+  *DataSize = (UINTN) Header->TotalSize;
+  return EFI_SUCCESS;
+}
+
 /**
   Returns the value of a large variable.
 
@@ -55,14 +125,15 @@ GetLargeVariable (
   OUT    VOID                        *Data           OPTIONAL
   )
 {
-  CHAR16        TempVariableName[MAX_VARIABLE_NAME_SIZE];
-  EFI_STATUS    Status;
-  UINTN         TotalSize;
-  UINTN         VarDataSize;
-  UINTN         Index;
-  UINTN         VariableSize;
-  UINTN         BytesRemaining;
-  UINT8         *OffsetPtr;
+  CHAR16                  TempVariableName[MAX_VARIABLE_NAME_SIZE];
+  LARGE_VARIABLE_HEADER   Header;
+  EFI_STATUS              Status;
+  UINTN                   TotalSize;
+  UINTN                   VarDataSize;
+  UINTN                   Index;
+  UINTN                   VariableSize;
+  UINTN                   BytesRemaining;
+  UINT8                   *OffsetPtr;
 
   VarDataSize = 0;
 
@@ -95,6 +166,19 @@ GetLargeVariable (
       goto Done;
     }
 
+    //
+    // Use the header, if present, to read the chunks directly
+    //
+    Status = GetLargeVariableHeader (VariableName, VendorGuid, TempVariableName, &Header);
+    if (!EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_VERBOSE, "GetLargeVariable: Header Found, NumVariables = %d\n", Header.ChunkCount));
+      Status = GetLargeVariableFromHeader (VariableName, VendorGuid, &Header, DataSize, Data);
+      if (Status != EFI_VOLUME_CORRUPTED) {
+        goto Done;
+      }
+      DEBUG ((DEBUG_WARN, "GetLargeVariable: Header is stale, probing variables\n"));
+    }
+
     VarDataSize = 0;
     Index       = 0;
     ZeroMem (TempVariableName, MAX_VARIABLE_NAME_SIZE);
@@ -9,6 +9,8 @@
   In the case where more than one variable is needed to store the data, an
   integer number will be added to the end of the variable name. This number
   will be incremented for each variable as needed to store the entire data set.
+  A header variable records the size and CRC32 of each chunk, so that chunks
+  whose contents did not change are not written again.
 
   Copyright (c) 2021 - 2022, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -19,6 +21,7 @@
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/PrintLib.h>
 #include <Library/VariableReadLib.h>
 #include <Library/VariableWriteLib.h>
@@ -118,6 +121,177 @@ GetVariableSplitSize (
   return VariableSplitSize;
 }
 
+/**
+  Deletes the header variable of a large variable, if present.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+
+  @retval EFI_SUCCESS            The header was deleted or was not present.
+  @retval Others                 The header could not be deleted.
+
+**/
+STATIC
+EFI_STATUS
+DeleteLargeVariableHeader (
+  IN  CHAR16                       *VariableName,
+  IN  EFI_GUID                     *VendorGuid
+  )
+{
+  CHAR16        HeaderName[MAX_VARIABLE_NAME_SIZE];
+  EFI_STATUS    Status;
+
+  ZeroMem (HeaderName, MAX_VARIABLE_NAME_SIZE);
+  UnicodeSPrint (HeaderName, MAX_VARIABLE_NAME_SIZE, L"%s%s", VariableName, LARGE_VARIABLE_HEADER_SUFFIX);
+  Status = VarLibSetVariable (
+             HeaderName,
+             VendorGuid,
+             EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+             0,
+             NULL
+             );
+  if (Status == EFI_NOT_FOUND) {
+    Status = EFI_SUCCESS;
+  }
+  return Status;
+}
+
+/**
+  Checks whether a chunk variable already holds the given data.
+
+  The size and CRC32 recorded in the header only tell that the chunk is likely
+  unchanged, so the stored chunk is read back and compared before a write is
+  skipped.
+
+  @param[in]  ChunkName          A Null-terminated string that is the name of the chunk variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+  @param[in]  Data               The data the chunk should hold.
+  @param[in]  DataSize           The size in bytes of the Data buffer.
+
+  @retval TRUE                   The chunk variable holds exactly Data.
+  @retval FALSE                  The chunk variable differs, is missing or could not be read.
+
+**/
+STATIC
+BOOLEAN
+IsLargeVariableChunkUnchanged (
+  IN  CHAR16                       *ChunkName,
+  IN  EFI_GUID                     *VendorGuid,
+  IN  VOID                         *Data,
+  IN  UINTN                        DataSize
+  )
+{
+  VOID          *ChunkData;
+  UINTN         ChunkSize;
+  EFI_STATUS    Status;
+  BOOLEAN       Unchanged;
+
+  ChunkData = AllocatePool (DataSize);
+  if (ChunkData == NULL) {
+    return FALSE;
+  }
+
+  ChunkSize = DataSize;
+  Status    = VarLibGetVariable (ChunkName, VendorGuid, NULL, &ChunkSize, ChunkData);
+  Unchanged = (BOOLEAN) (!EFI_ERROR (Status) &&
+                         (ChunkSize == DataSize) &&
+                         (CompareMem (ChunkData, Data, DataSize) == 0));
+  FreePool (ChunkData);
+  return Unchanged;
+}
+
+/**
+  Deletes the chunk variables and the header of a large variable stored using
+  multiple variables, if present.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+
+  @retval EFI_SUCCESS            The chunks and the header were deleted or were not present.
+  @retval Others                 A chunk or the header could not be deleted.
+
+**/
+STATIC
+EFI_STATUS
+DeleteLargeVariableChunks (
+  IN  CHAR16                       *VariableName,
+  IN  EFI_GUID                     *VendorGuid
+  )
+{
+  CHAR16        TempVariableName[MAX_VARIABLE_NAME_SIZE];
+  EFI_STATUS    Status;
+  EFI_STATUS    Status2;
+  UINTN         Index;
+
+  if (StrLen (VariableName) >= (MAX_VARIABLE_NAME_SIZE - MAX_VARIABLE_SPLIT_DIGITS)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Remove the header first, so that a set of chunks is never described by
+  // a header while it is only partially deleted
+  //
+  Status = DeleteLargeVariableHeader (VariableName, VendorGuid);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < MAX_VARIABLE_SPLIT; Index++) {
+    ZeroMem (TempVariableName, MAX_VARIABLE_NAME_SIZE);
+    UnicodeSPrint (TempVariableName, MAX_VARIABLE_NAME_SIZE, L"%s%d", VariableName, Index);
+    Status2 = VarLibSetVariable (
+                TempVariableName,
+                VendorGuid,
+                EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+                0,
+                NULL
+                );
+    if (Status2 == EFI_NOT_FOUND) {
+      break;
+    } else if (EFI_ERROR (Status2)) {
+      DEBUG ((DEBUG_ERROR, "DeleteLargeVariableChunks: Error deleting %s: Status = %r\n", TempVariableName, Status2));
+      Status = Status2;
+    } else {
+      DEBUG ((DEBUG_INFO, "Deleted %s, Guid = %g\n", TempVariableName, VendorGuid));
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Locks the header variable of a large variable, if present.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+
+  @retval EFI_SUCCESS            The header was locked or was not present.
+  @retval Others                 The header could not be locked.
+
+**/
+STATIC
+EFI_STATUS
+LockLargeVariableHeader (
+  IN  CHAR16                       *VariableName,
+  IN  EFI_GUID                     *VendorGuid
+  )
+{
+  CHAR16        HeaderName[MAX_VARIABLE_NAME_SIZE];
+  UINTN         VariableSize;
+  EFI_STATUS    Status;
+
+  ZeroMem (HeaderName, MAX_VARIABLE_NAME_SIZE);
+  UnicodeSPrint (HeaderName, MAX_VARIABLE_NAME_SIZE, L"%s%s", VariableName, LARGE_VARIABLE_HEADER_SUFFIX);
+  VariableSize = 0;
+  Status = VarLibGetVariable (HeaderName, VendorGuid, NULL, &VariableSize, NULL);
+  if (Status == EFI_NOT_FOUND) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "Locking %s, Guid = %g\n", HeaderName, VendorGuid));
+  return VarLibVariableRequestToLock (HeaderName, VendorGuid);
+}
+
 /**
   Deletes a large variable.
 
@@ -210,6 +384,12 @@ DeleteLargeVariableInternal (
           Status = Status2;
         }
       }   // End of for loop
+
+      Status2 = DeleteLargeVariableHeader (VariableName, VendorGuid);
+      if (EFI_ERROR (Status2)) {
+        DEBUG ((DEBUG_ERROR, "DeleteLargeVariableInternal: Error deleting header: Status = %r\n", Status2));
+        Status = Status2;
+      }
     } else {
       Status = EFI_NOT_FOUND;
     }
@@ -259,17 +439,23 @@ SetLargeVariable (
   IN  VOID                         *Data
   )
 {
-  CHAR16        TempVariableName[MAX_VARIABLE_NAME_SIZE];
-  UINT64        VariableSplitSize;
-  UINT64        RemainingVariableStorage;
-  EFI_STATUS    Status;
-  EFI_STATUS    Status2;
-  UINTN         VariableNameLength;
-  UINTN         Index;
-  UINTN         VariablesSaved;
-  UINT8         *OffsetPtr;
-  UINTN         BytesRemaining;
-  UINTN         SizeToSave;
+  CHAR16                  TempVariableName[MAX_VARIABLE_NAME_SIZE];
+  CHAR16                  HeaderName[MAX_VARIABLE_NAME_SIZE];
+  LARGE_VARIABLE_HEADER   OldHeader;
+  LARGE_VARIABLE_HEADER   NewHeader;
+  BOOLEAN                 UseHeader;
+  BOOLEAN                 HeaderDeleted;
+  UINT32                  Crc32;
+  UINT64                  VariableSplitSize;
+  UINT64                  RemainingVariableStorage;
+  EFI_STATUS              Status;
+  EFI_STATUS              Status2;
+  UINTN                   VariableNameLength;
+  UINTN                   Index;
+  UINTN                   VariablesSaved;
+  UINT8                   *OffsetPtr;
+  UINTN                   BytesRemaining;
+  UINTN                   SizeToSave;
 
   //
   // Check input parameters.
@@ -321,6 +507,18 @@ SetLargeVariable (
     if (EFI_ERROR (Status)) {
       goto Done;
     }
+
+    //
+    // A previous, larger data set may have been stored using multiple
+    // variables. Readers look for the single variable first, but the stale
+    // chunks would still consume NV storage space.
+    //
+    Status = DeleteLargeVariableChunks (VariableName, VendorGuid);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting previous chunks: Status = %r\n", Status));
+      goto Done;
+    }
+
     if (LockVariable) {
       Status = VarLibVariableRequestToLock (VariableName, VendorGuid);
       if (EFI_ERROR (Status)) {
@@ -376,6 +574,20 @@ SetLargeVariable (
     BytesRemaining    = DataSize;
     VariablesSaved    = 0;
 
+    //
+    // The current header tells which chunks already hold the right data
+    //
+    Status = GetLargeVariableHeader (VariableName, VendorGuid, HeaderName, &OldHeader);
+    if (EFI_ERROR (Status)) {
+      OldHeader.ChunkCount = 0;
+    }
+    Status = EFI_SUCCESS;
+    ZeroMem (&NewHeader, sizeof (NewHeader));
+    NewHeader.Signature = LARGE_VARIABLE_HEADER_SIGNATURE;
+    NewHeader.TotalSize = DataSize;
+    UseHeader           = TRUE;
+    HeaderDeleted       = FALSE;
+
     //
     // Store chunks of data in UEFI variables until all data is stored
     //
@@ -397,23 +609,106 @@ SetLargeVariable (
       } else {
         SizeToSave = BytesRemaining;
       }
-      DEBUG ((DEBUG_INFO, "Saving %s, Guid = %g, Size %d\n", TempVariableName, VendorGuid, SizeToSave));
-      Status = VarLibSetVariable (
-                TempVariableName,
-                VendorGuid,
-                EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
-                SizeToSave,
-                (VOID *) OffsetPtr
-                );
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error writting variable: Status = %r\n", Status));
-        goto Done;
+      Crc32 = CalculateCrc32 (OffsetPtr, SizeToSave);
+      if (Index < MAX_LARGE_VARIABLE_HEADER_CHUNKS) {
+        NewHeader.Chunk[Index].Size  = (UINT32) SizeToSave;
+        NewHeader.Chunk[Index].Crc32 = Crc32;
+      } else {
+        UseHeader = FALSE;
+      }
+
+      if ((Index < OldHeader.ChunkCount) &&
+          (OldHeader.Chunk[Index].Size == SizeToSave) &&
+          (OldHeader.Chunk[Index].Crc32 == Crc32) &&
+          IsLargeVariableChunkUnchanged (TempVariableName, VendorGuid, OffsetPtr, SizeToSave)) {
+        DEBUG ((DEBUG_INFO, "Unchanged %s, Guid = %g, Size %d\n", TempVariableName, VendorGuid, SizeToSave));
+      } else {
+        //
+        // Drop the header before the first chunk changes, so that an
+        // interrupted update is never described by a stale header
+        //
+        if ((OldHeader.ChunkCount != 0) && !HeaderDeleted) {
+          Status = DeleteLargeVariableHeader (VariableName, VendorGuid);
+          if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting header: Status = %r\n", Status));
+            goto Done;
+          }
+          HeaderDeleted = TRUE;
+        }
+
+        DEBUG ((DEBUG_INFO, "Saving %s, Guid = %g, Size %d\n", TempVariableName, VendorGuid, SizeToSave));
+        Status = VarLibSetVariable (
+                  TempVariableName,
+                  VendorGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+                  SizeToSave,
+                  (VOID *) OffsetPtr
+                  );
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error writting variable: Status = %r\n", Status));
+          goto Done;
+        }
       }
       VariablesSaved++;
       BytesRemaining -= SizeToSave;
       OffsetPtr += SizeToSave;
     }   // End of for loop
 
+    //
+    // Delete chunks left over from a previously larger data set
+    //
+    for (Index = VariablesSaved; Index < OldHeader.ChunkCount; Index++) {
+      if (!HeaderDeleted) {
+        Status = DeleteLargeVariableHeader (VariableName, VendorGuid);
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting header: Status = %r\n", Status));
+          goto Done;
+        }
+        HeaderDeleted = TRUE;
+      }
+      ZeroMem (TempVariableName, MAX_VARIABLE_NAME_SIZE);
+      UnicodeSPrint (TempVariableName, MAX_VARIABLE_NAME_SIZE, L"%s%d", VariableName, Index);
+      DEBUG ((DEBUG_INFO, "Deleting %s, Guid = %g\n", TempVariableName, VendorGuid));
+      Status2 = VarLibSetVariable (
+                  TempVariableName,
+                  VendorGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+                  0,
+                  NULL
+                  );
+      if (EFI_ERROR (Status2) && (Status2 != EFI_NOT_FOUND)) {
+        DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting variable: Status = %r\n", Status2));
+      }
+    }
+
+    //
+    // Write the header describing the new chunks, unless the old one already
+    // does. Data sets with too many chunks are stored without a header.
+    //
+    if (UseHeader) {
+      NewHeader.ChunkCount = (UINT32) VariablesSaved;
+      if ((OldHeader.ChunkCount == 0) || HeaderDeleted) {
+        DEBUG ((DEBUG_INFO, "Saving %s, Guid = %g, Size %d\n", HeaderName, VendorGuid, LARGE_VARIABLE_HEADER_SIZE (NewHeader.ChunkCount)));
+        Status = VarLibSetVariable (
+                   HeaderName,
+                   VendorGuid,
+                   EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+                   LARGE_VARIABLE_HEADER_SIZE (NewHeader.ChunkCount),
+                   &NewHeader
+                   );
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error writting header: Status = %r\n", Status));
+          goto Done;
+        }
+      }
+    } else if (!HeaderDeleted) {
+      Status = DeleteLargeVariableHeader (VariableName, VendorGuid);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting header: Status = %r\n", Status));
+        goto Done;
+      }
+    }
+
     //
     // If the user requested that the variables be locked, lock them now that
     // all data is saved.
@@ -435,6 +730,14 @@ SetLargeVariable (
           goto Done;
         }
       }
+
+      Status = LockLargeVariableHeader (VariableName, VendorGuid);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error locking header: Status = %r\n", Status));
+        Status = EFI_ABORTED;
+        VariablesSaved = 0;
+        goto Done;
+      }
     }
   }
 
@@ -457,6 +760,7 @@ Done:
         DEBUG ((DEBUG_ERROR, "SetLargeVariable: Error deleting variable: Status = %r\n", Status2));
       }
     }
+    DeleteLargeVariableHeader (VariableName, VendorGuid);
   }
   DEBUG ((DEBUG_ERROR, "SetLargeVariable: Status = %r\n", Status));
   return Status;
@@ -568,8 +872,13 @@ LockLargeVariable (
           }
         } else if (Status == EFI_NOT_FOUND) {
           //
-          // No more variables need to lock.
+          // No more variables need to lock, lock the header describing them.
           //
+          Status = LockLargeVariableHeader (VariableName, VendorGuid);
+          if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "LockLargeVariable: Failed! Satus = %r\n", Status));
+            return EFI_ABORTED;
+          }
           return EFI_SUCCESS;
         }
       }   // End of for loop
@@ -15,6 +15,7 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/CompressLib.h>
 #include <Uefi/UefiBaseType.h>
 
 #define SHELL_FREE_NON_NULL(Pointer)  \
@@ -60,6 +61,28 @@ typedef INT16             NODE;
 #else
   #define                 NPT NP
 #endif
+
+//
+// Hash-chain match finder. Each chain links the positions sharing the hash of
+// their first THRESHOLD bytes, newest first, through a WNDSIZ ring of links.
+//
+#define HC_HASH_BIT       15
+#define HC_HASH_SIZE      (1U << HC_HASH_BIT)
+#define HC_NIL            MAX_UINT32
+#define HC_HASH(Ptr)      \
+  (((((UINT32) (Ptr)[0] << 16) | ((UINT32) (Ptr)[1] << 8) | (Ptr)[2]) * 0x9E3779B1U) >> (32 - HC_HASH_BIT))
+
+typedef struct {
+  UINT32  ChainDepth;   // Chain entries examined per search, 0 selects the tree finder
+  UINT32  NiceLength;   // Stop searching once a match this long is found
+  UINT32  LazyLength;   // Look one byte ahead only for shorter matches, 0 is greedy
+} COMPRESS_LEVEL_PARAMS;
+
+STATIC CONST COMPRESS_LEVEL_PARAMS  mLevelParamsTable[] = {
+  { 4,  32,       0  },     // COMPRESS_LEVEL_FAST
+  { 32, 128,      32 },     // COMPRESS_LEVEL_DEFAULT
+  { 0,  MAXMATCH, 0  }      // COMPRESS_LEVEL_BEST
+};
 //
 // Function Prototypes
 //
@@ -125,6 +148,10 @@ STATIC NODE   *mPrev;
 STATIC NODE   *mNext = NULL;
 INT32         mHuffmanDepth = 0;
 
+STATIC UINT32 *mHashHead;
+STATIC UINT32 *mHashPrev;
+STATIC CONST COMPRESS_LEVEL_PARAMS  *mLevelParams;
+
 /**
   Make a CRC table.
 
@@ -195,13 +222,23 @@ AllocateMemory (
   VOID
   )
 {
-  mText       = AllocateZeroPool (WNDSIZ * 2 + MAXMATCH);
-  mLevel      = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mLevel));
-  mChildCount = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mChildCount));
-  mPosition   = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mPosition));
-  mParent     = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mParent));
-  mPrev       = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mPrev));
-  mNext       = AllocateZeroPool ((MAX_HASH_VAL + 1) * sizeof (*mNext));
+  if (mLevelParams->ChainDepth != 0) {
+    mHashHead = AllocatePool (HC_HASH_SIZE * sizeof (*mHashHead));
+    mHashPrev = AllocatePool (WNDSIZ * sizeof (*mHashPrev));
+    if ((mHashHead == NULL) || (mHashPrev == NULL)) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    SetMem32 (mHashHead, HC_HASH_SIZE * sizeof (*mHashHead), HC_NIL);
+  } else {
+    mText       = AllocateZeroPool (WNDSIZ * 2 + MAXMATCH);
+    mLevel      = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mLevel));
+    mChildCount = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mChildCount));
+    mPosition   = AllocateZeroPool ((WNDSIZ + MAX_UINT8 + 1) * sizeof (*mPosition));
+    mParent     = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mParent));
+    mPrev       = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mPrev));
+    mNext       = AllocateZeroPool ((MAX_HASH_VAL + 1) * sizeof (*mNext));
+  }
 
   mBufSiz     = BLKSIZ;
   mBuf        = AllocateZeroPool (mBufSiz);
@@ -237,6 +274,8 @@ FreeMemory (
   SHELL_FREE_NON_NULL (mPrev);
   SHELL_FREE_NON_NULL (mNext);
   SHELL_FREE_NON_NULL (mBuf);
+  SHELL_FREE_NON_NULL (mHashHead);
+  SHELL_FREE_NON_NULL (mHashPrev);
 }
 
 /**
@@ -1351,6 +1390,194 @@ Encode (
   return (Status);
 }
 
+/**
+  Link a source position into its hash chain and optionally search the chain
+  for the longest earlier match within the window.
+
+  @param[in]  Pos         The offset of the current position in the source.
+  @param[in]  Search      TRUE to search for a match, FALSE to only link Pos.
+  @param[out] MatchPos    The offset of the longest match found.
+
+  @return The length of the longest match, or 0 when none was searched for.
+**/
+UINT32
+EFIAPI
+HashChainInsert (
+  IN  UINT32    Pos,
+  IN  BOOLEAN   Search,
+  OUT UINT32    *MatchPos
+  )
+{
+  UINT32  Hash;
+  UINT32  Candidate;
+  UINT32  ChainDepth;
+  UINT32  MaxLen;
+  UINT32  BestLen;
+  UINT32  Len;
+  UINT8   *Scan;
+  UINT8   *Match;
+
+  if (Pos + THRESHOLD > mOrigSize) {
+    return 0;
+  }
+
+  Scan                              = &mSrc[Pos];
+  Hash                              = HC_HASH (Scan);
+  Candidate                         = mHashHead[Hash];
+  mHashPrev[Pos & (WNDSIZ - 1)]     = Candidate;
+  mHashHead[Hash]                   = Pos;
+  if (!Search) {
+    return 0;
+  }
+
+  MaxLen      = MIN (MAXMATCH, mOrigSize - Pos);
+  BestLen     = 0;
+  ChainDepth  = mLevelParams->ChainDepth;
+  while (Candidate != HC_NIL && ChainDepth-- > 0) {
+    //
+    // Links of positions inside the window are never overwritten, so the
+    // chain only needs to stop once it walks out of the window.
+    //
+    if (Pos - Candidate >= WNDSIZ) {
+      break;
+    }
+
+    Match = &mSrc[Candidate];
+    if (Match[BestLen] == Scan[BestLen]) {
+      Len = 0;
+      while (Len < MaxLen && Match[Len] == Scan[Len]) {
+        Len++;
+      }
+
+      if (Len > BestLen) {
+        BestLen   = Len;
+        *MatchPos = Candidate;
+        if (BestLen >= mLevelParams->NiceLength || BestLen >= MaxLen) {
+          break;
+        }
+      }
+    }
+
+    Candidate = mHashPrev[Candidate & (WNDSIZ - 1)];
+  }
+
+  return BestLen;
+}
+
+/**
+  Output a Pointer and link the positions it covers into the hash chains.
+
+  @param[in] Pos          The offset the Pointer starts at.
+  @param[in] MatchLen     The 'String Length' of the Pointer.
+  @param[in] MatchPos     The offset of the earlier copy of the string.
+  @param[in] Linked       The number of positions from Pos already linked
+                          into the hash chains.
+**/
+VOID
+EFIAPI
+HashChainOutputMatch (
+  IN UINT32   Pos,
+  IN UINT32   MatchLen,
+  IN UINT32   MatchPos,
+  IN UINT32   Linked
+  )
+{
+  UINT32  Index;
+
+  CompressOutput (MatchLen + (MAX_UINT8 + 1 - THRESHOLD), Pos - MatchPos - 1);
+  for (Index = Linked; Index < MatchLen; Index++) {
+    HashChainInsert (Pos + Index, FALSE, NULL);
+  }
+}
+
+/**
+  The main controlling routine for compression with the hash-chain match
+  finder. The source is matched in place, without the sliding text buffer.
+
+  @retval EFI_SUCCESS           The compression is successful.
+  @retval EFI_OUT_0F_RESOURCES  Not enough memory for compression process.
+**/
+EFI_STATUS
+EFIAPI
+HashChainEncode (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Pos;
+  UINT32      MatchLen;
+  UINT32      MatchPos;
+  UINT32      PrevLen;
+  UINT32      PrevPos;
+  BOOLEAN     Pending;
+
+  Status = AllocateMemory ();
+  if (EFI_ERROR (Status)) {
+    FreeMemory ();
+    return Status;
+  }
+
+  HufEncodeStart ();
+
+  mOrigSize = (UINT32) (mSrcUpperLimit - mSrc);
+  Pos       = 0;
+  MatchPos  = 0;
+  PrevLen   = 0;
+  PrevPos   = 0;
+  Pending   = FALSE;
+
+  while (Pos < mOrigSize) {
+    if (mLevelParams->LazyLength == 0) {
+      //
+      // Greedy parsing: take the match found at the current position.
+      //
+      MatchLen = HashChainInsert (Pos, TRUE, &MatchPos);
+      if (MatchLen >= THRESHOLD) {
+        HashChainOutputMatch (Pos, MatchLen, MatchPos, 1);
+        Pos += MatchLen;
+      } else {
+        CompressOutput (mSrc[Pos], 0);
+        Pos++;
+      }
+
+      continue;
+    }
+
+    //
+    // Lazy parsing: the match found at the previous position is only
+    // output when the current position does not offer a longer one.
+    //
+    MatchLen = HashChainInsert (Pos, (BOOLEAN) (PrevLen < mLevelParams->LazyLength), &MatchPos);
+    if (Pending && PrevLen >= THRESHOLD && MatchLen <= PrevLen) {
+      //
+      // Both Pos - 1 and Pos are already in the hash chains.
+      //
+      HashChainOutputMatch (Pos - 1, PrevLen, PrevPos, 2);
+      Pos     += PrevLen - 1;
+      PrevLen = 0;
+      Pending = FALSE;
+      continue;
+    }
+
+    if (Pending) {
+      CompressOutput (mSrc[Pos - 1], 0);
+    }
+
+    PrevLen = MatchLen;
+    PrevPos = MatchPos;
+    Pending = TRUE;
+    Pos++;
+  }
+
+  if (Pending) {
+    CompressOutput (mSrc[Pos - 1], 0);
+  }
+
+  HufEncodeEnd ();
+  FreeMemory ();
+  return (Status);
+}
+
 /**
   The compression routine.
 
@@ -1371,9 +1598,43 @@ Compress (
   IN       VOID   *DstBuffer,
   IN OUT   UINT64 *DstSize
   )
+{
+  return CompressWithLevel (SrcBuffer, SrcSize, DstBuffer, DstSize, COMPRESS_LEVEL_BEST);
+}
+
+/**
+  The compression routine with a selectable speed/ratio trade-off.
+
+  @param[in]       SrcBuffer     The buffer containing the source data.
+  @param[in]       SrcSize       The number of bytes in SrcBuffer.
+  @param[in]       DstBuffer     The buffer to put the compressed image in.
+  @param[in, out]  DstSize       On input the size (in bytes) of DstBuffer, on
+                                return the number of bytes placed in DstBuffer.
+  @param[in]       Level         One of the COMPRESS_LEVEL_* values.
+
+  @retval EFI_SUCCESS           The compression was sucessful.
+  @retval EFI_BUFFER_TOO_SMALL  The buffer was too small.  DstSize is required.
+  @retval EFI_INVALID_PARAMETER Level is not a supported compression level.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for compression process.
+**/
+EFI_STATUS
+EFIAPI
+CompressWithLevel (
+  IN       VOID   *SrcBuffer,
+  IN       UINT64 SrcSize,
+  IN       VOID   *DstBuffer,
+  IN OUT   UINT64 *DstSize,
+  IN       UINTN  Level
+  )
 {
   EFI_STATUS  Status;
 
+  if ((Level < COMPRESS_LEVEL_FAST) || (Level > COMPRESS_LEVEL_BEST) || (SrcSize > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mLevelParams    = &mLevelParamsTable[Level - COMPRESS_LEVEL_FAST];
+
   //
   // Initializations
   //
@@ -1386,6 +1647,8 @@ Compress (
   mParent         = NULL;
   mPrev           = NULL;
   mNext           = NULL;
+  mHashHead       = NULL;
+  mHashPrev       = NULL;
 
   mSrc            = SrcBuffer;
   mSrcUpperLimit  = mSrc + SrcSize;
@@ -1403,7 +1666,11 @@ Compress (
   //
   // Compress it
   //
-  Status = Encode ();
+  if (mLevelParams->ChainDepth != 0) {
+    Status = HashChainEncode ();
+  } else {
+    Status = Encode ();
+  }
   if (EFI_ERROR (Status)) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -406,6 +406,202 @@ EFI_PEI_NOTIFY_DESCRIPTOR mMemoryNotifyList = {
   BuildDefaultDataHobForRecoveryVariable 
 };
 
+/**
+  Compute the index hash of a variable name and vendor GUID.
+
+  @param[in] VariableName       The variable name.
+  @param[in] NameSize           The maximum size in bytes of VariableName.
+  @param[in] VendorGuid         The vendor GUID.
+
+  @return The 32-bit FNV-1a hash of the name, up to its terminator, and the GUID.
+
+**/
+STATIC
+UINT32
+VariableHobIndexHash (
+  IN CONST CHAR16               *VariableName,
+  IN UINTN                      NameSize,
+  IN CONST EFI_GUID             *VendorGuid
+  )
+{
+  UINT32                        Hash;
+  UINTN                         Index;
+  CONST UINT8                   *GuidPtr;
+
+  Hash = 0x811C9DC5;
+  for (Index = 0; Index < NameSize / sizeof (CHAR16); Index++) {
+    Hash = (Hash ^ VariableName[Index]) * 0x01000193;
+    if (VariableName[Index] == L'\0') {
+      break;
+    }
+  }
+
+  GuidPtr = (CONST UINT8 *) VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ GuidPtr[Index]) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Build the hash index for a default variable store HOB and publish it
+  in a gDefaultVariableHobIndexGuid HOB.
+
+  @param[in] VarStoreHeader     Pointer to the variable store in the HOB.
+
+  @retval EFI_SUCCESS           The index HOB is created.
+  @retval EFI_OUT_OF_RESOURCES  No enough resource to create the index HOB.
+
+**/
+EFI_STATUS
+BuildVariableHobIndex (
+  IN VARIABLE_STORE_HEADER      *VarStoreHeader
+  )
+{
+  BOOLEAN                       AuthFlag;
+  AUTHENTICATED_VARIABLE_HEADER *StartPtr;
+  AUTHENTICATED_VARIABLE_HEADER *EndPtr;
+  AUTHENTICATED_VARIABLE_HEADER *CurrPtr;
+  VARIABLE_HOB_INDEX            *VariableIndex;
+  VARIABLE_HOB_INDEX_ENTRY      *Entry;
+  UINT32                        VariableCount;
+  UINT32                        BucketCount;
+  UINT32                        Hash;
+  UINT32                        Slot;
+
+  AuthFlag = CompareGuid (&VarStoreHeader->Signature, &gEfiAuthenticatedVariableGuid);
+  StartPtr = GetStartPointer (VarStoreHeader);
+  EndPtr   = GetEndPointer (VarStoreHeader);
+
+  VariableCount = 0;
+  for ( CurrPtr = StartPtr
+      ; (CurrPtr < EndPtr) && IsValidVariableHeader (CurrPtr)
+      ; CurrPtr = GetNextVariablePtr (CurrPtr, AuthFlag)
+      ) {
+    if (CurrPtr->State == VAR_ADDED) {
+      VariableCount++;
+    }
+  }
+
+  //
+  // Keep the table at most half full so that probe sequences stay short.
+  //
+  BucketCount = 1;
+  while (BucketCount < VariableCount * 2) {
+    BucketCount <<= 1;
+  }
+
+  VariableIndex = (VARIABLE_HOB_INDEX *) BuildGuidHob (
+                                           &gDefaultVariableHobIndexGuid,
+                                           sizeof (VARIABLE_HOB_INDEX) + BucketCount * sizeof (VARIABLE_HOB_INDEX_ENTRY)
+                                           );
+  if (VariableIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  VariableIndex->Signature     = VARIABLE_HOB_INDEX_SIGNATURE;
+  CopyGuid (&VariableIndex->StoreSignature, &VarStoreHeader->Signature);
+  VariableIndex->StoreSize     = VarStoreHeader->Size;
+  VariableIndex->BucketCount   = BucketCount;
+  VariableIndex->VariableCount = VariableCount;
+  Entry = (VARIABLE_HOB_INDEX_ENTRY *) (VariableIndex + 1);
+  ZeroMem (Entry, BucketCount * sizeof (VARIABLE_HOB_INDEX_ENTRY));
+
+  for ( CurrPtr = StartPtr
+      ; (CurrPtr < EndPtr) && IsValidVariableHeader (CurrPtr)
+      ; CurrPtr = GetNextVariablePtr (CurrPtr, AuthFlag)
+      ) {
+    if ((CurrPtr->State != VAR_ADDED) || (NameSizeOfVariable (CurrPtr, AuthFlag) == 0)) {
+      continue;
+    }
+
+    Hash = VariableHobIndexHash (
+             GetVariableNamePtr (CurrPtr, AuthFlag),
+             NameSizeOfVariable (CurrPtr, AuthFlag),
+             GetVendorGuidPtr (CurrPtr, AuthFlag)
+             );
+    Slot = Hash & (BucketCount - 1);
+    while (Entry[Slot].Offset != 0) {
+      Slot = (Slot + 1) & (BucketCount - 1);
+    }
+
+    Entry[Slot].Hash   = Hash;
+    Entry[Slot].Offset = (UINT32) ((UINTN) CurrPtr - (UINTN) VarStoreHeader);
+  }
+
+  DEBUG ((DEBUG_INFO, "Default variable HOB index: %d variables, %d buckets\n", VariableCount, BucketCount));
+  return EFI_SUCCESS;
+}
+
+/**
+  Find variable from default variable HOB through the hash index.
+
+  @param[in]  VariableStoreHeader  Pointer to the variable store in the HOB.
+  @param[in]  VariableName         A Null-terminated string that is the name of the vendor's
+                                   variable.
+  @param[in]  VendorGuid           A unique identifier for the vendor.
+  @param[in]  AuthFlag             Authenticated variable flag.
+  @param[out] Variable             Pointer to variable header, NULL if not found.
+
+  @retval TRUE                     The index matches the store and Variable is valid.
+  @retval FALSE                    No usable index, the caller must scan the store.
+
+**/
+STATIC
+BOOLEAN
+FindVariableFromHobIndex (
+  IN  VARIABLE_STORE_HEADER          *VariableStoreHeader,
+  IN  CHAR16                         *VariableName,
+  IN  EFI_GUID                       *VendorGuid,
+  IN  BOOLEAN                        AuthFlag,
+  OUT AUTHENTICATED_VARIABLE_HEADER  **Variable
+  )
+{
+  EFI_HOB_GUID_TYPE             *GuidHob;
+  VARIABLE_HOB_INDEX            *VariableIndex;
+  VARIABLE_HOB_INDEX_ENTRY      *Entry;
+  AUTHENTICATED_VARIABLE_HEADER *CurrPtr;
+  UINT32                        Hash;
+  UINT32                        Slot;
+  UINT32                        Probe;
+
+  GuidHob = GetFirstGuidHob (&gDefaultVariableHobIndexGuid);
+  if (GuidHob == NULL) {
+    return FALSE;
+  }
+
+  VariableIndex = (VARIABLE_HOB_INDEX *) GET_GUID_HOB_DATA (GuidHob);
+  if ((VariableIndex->Signature != VARIABLE_HOB_INDEX_SIGNATURE) ||
+      !CompareGuid (&VariableIndex->StoreSignature, &VariableStoreHeader->Signature) ||
+      (VariableIndex->StoreSize != VariableStoreHeader->Size) ||
+      (VariableIndex->BucketCount == 0) ||
+      ((VariableIndex->BucketCount & (VariableIndex->BucketCount - 1)) != 0)) {
+    return FALSE;
+  }
+
+  *Variable = NULL;
+  Entry     = (VARIABLE_HOB_INDEX_ENTRY *) (VariableIndex + 1);
+  Hash      = VariableHobIndexHash (VariableName, MAX_UINTN, VendorGuid);
+  Slot      = Hash & (VariableIndex->BucketCount - 1);
+  for (Probe = 0; (Probe < VariableIndex->BucketCount) && (Entry[Slot].Offset != 0); Probe++) {
+    if (Entry[Slot].Hash == Hash) {
+      CurrPtr = (AUTHENTICATED_VARIABLE_HEADER *) ((UINTN) VariableStoreHeader + Entry[Slot].Offset);
+      if (IsValidVariableHeader (CurrPtr) &&
+          (CurrPtr->State == VAR_ADDED) &&
+          CompareGuid (VendorGuid, GetVendorGuidPtr (CurrPtr, AuthFlag)) &&
+          (CompareMem (VariableName, GetVariableNamePtr (CurrPtr, AuthFlag), NameSizeOfVariable (CurrPtr, AuthFlag)) == 0)) {
+        *Variable = CurrPtr;
+        break;
+      }
+    }
+
+    Slot = (Slot + 1) & (VariableIndex->BucketCount - 1);
+  }
+
+  return TRUE;
+}
+
 /**
   Find variable from default variable HOB.
 
@@ -449,6 +645,13 @@ FindVariableFromHob (
     return NULL;
   }
 
+  //
+  // Use the hash index when one was published for this store.
+  //
+  if (FindVariableFromHobIndex (VariableStoreHeader, VariableName, VendorGuid, *AuthFlag, &CurrPtr)) {
+    return CurrPtr;
+  }
+
   StartPtr = GetStartPointer (VariableStoreHeader);
   EndPtr   = GetEndPointer (VariableStoreHeader);
   for ( CurrPtr = StartPtr
@@ -445,6 +445,15 @@ CreateDefaultVariableHob (
   //
   VarStoreHeaderHob->Size = VarStoreHeader->Size - VarDataOffset + VarHobDataOffset;
 
+  //
+  // Publish a hash index over the new HOB so that lookups do not need to
+  // scan the whole store. Lookups fall back to scanning without it.
+  //
+  Status = BuildVariableHobIndex (VarStoreHeaderHob);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "Failed to build default variable HOB index - %r\n", Status));
+  }
+
   //
   // On recovery boot mode, emulation variable driver will be used.
   // But, Emulation variable only knows normal variable data format. 
@@ -10,6 +10,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 extern EFI_GUID gEfiVariableGuid;
 extern EFI_GUID gEfiAuthenticatedVariableGuid;
+extern EFI_GUID gDefaultVariableHobIndexGuid;
 
 ///
 /// Alignment of variable name and data, according to the architecture:
@@ -169,4 +170,55 @@ typedef struct {
 
 #pragma pack()
 
+///
+/// Hash index over the default variable store HOB, published in a
+/// gDefaultVariableHobIndexGuid HOB. Entries are kept in an open-addressed
+/// table with linear probing, and locate variables by their offset from
+/// the store header so the index survives HOB migration.
+///
+#define VARIABLE_HOB_INDEX_SIGNATURE  SIGNATURE_32 ('V', 'H', 'I', 'X')
+
+typedef struct {
+  ///
+  /// Hash of the variable name and vendor GUID, see VariableHobIndexHash().
+  ///
+  UINT32      Hash;
+  ///
+  /// Offset of the variable header from the store header, 0 if unused.
+  ///
+  UINT32      Offset;
+} VARIABLE_HOB_INDEX_ENTRY;
+
+typedef struct {
+  UINT32      Signature;
+  ///
+  /// Signature and size of the indexed variable store, used to detect a stale index.
+  ///
+  EFI_GUID    StoreSignature;
+  UINT32      StoreSize;
+  ///
+  /// Number of entries in the table, always a power of two.
+  ///
+  UINT32      BucketCount;
+  UINT32      VariableCount;
+  //
+  // VARIABLE_HOB_INDEX_ENTRY  Entry[BucketCount];
+  //
+} VARIABLE_HOB_INDEX;
+
+/**
+  Build the hash index for a default variable store HOB and publish it
+  in a gDefaultVariableHobIndexGuid HOB.
+
+  @param[in] VarStoreHeader     Pointer to the variable store in the HOB.
+
+  @retval EFI_SUCCESS           The index HOB is created.
+  @retval EFI_OUT_OF_RESOURCES  No enough resource to create the index HOB.
+
+**/
+EFI_STATUS
+BuildVariableHobIndex (
+  IN VARIABLE_STORE_HEADER      *VarStoreHeader
+  );
+
 #endif
@@ -79,6 +79,8 @@ OnEndOfDxe (
   TestPointEndOfDxeDmaAcpiTableFunctional ();
 
   TestPointEndOfDxeDmaProtectionEnabled ();
+
+  TestPointEndOfDxeBootPerformanceBudget ();
 }
 
 /**
@@ -154,6 +156,7 @@ OnReadyToBootLater (
   TestPointReadyToBootTcgTrustedBootEnabled ();
   TestPointReadyToBootTcgMorEnabled ();
   TestPointReadyToBootEsrtTableFunctional ();
+  TestPointReadyToBootBootPerformanceBudget ();
 }
 
 /**
@@ -0,0 +1,392 @@
+/** @file
+
+Copyright (c) 2024, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <PiDxe.h>
+#include <Library/TestPointCheckLib.h>
+#include <Library/TestPointLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/HobLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
+#include <IndustryStandard/Acpi.h>
+#include <Guid/FirmwarePerformance.h>
+#include <Guid/ExtendedFirmwarePerformance.h>
+
+VOID *
+TestPointGetAcpi (
+  IN UINT32  Signature
+  );
+
+typedef struct {
+  UINT32    Type;
+  CHAR8     *Token;
+} BOOT_PERFORMANCE_PHASE;
+
+GLOBAL_REMOVE_IF_UNREFERENCED BOOT_PERFORMANCE_PHASE  mBootPerformancePhase[] = {
+  { TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_PEI, "PEI" },
+  { TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_DXE, "DXE" },
+  { TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_PHASE_BDS, "BDS" },
+};
+
+/**
+  Collects the PEI performance records from the FPDT HOBs.
+
+  @param[out] RecordsSize   Size of the returned records.
+
+  @return The records, to be freed by the caller, or NULL.
+**/
+UINT8 *
+GetPeiPerformanceRecords (
+  OUT UINTN  *RecordsSize
+  )
+{
+  EFI_HOB_GUID_TYPE         *GuidHob;
+  FPDT_PEI_EXT_PERF_HEADER  *PeiPerformanceHeader;
+  UINT8                     *Records;
+  UINTN                     Size;
+
+  Size    = 0;
+  GuidHob = GetFirstGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid);
+  while (GuidHob != NULL) {
+    PeiPerformanceHeader = GET_GUID_HOB_DATA (GuidHob);
+    Size                += PeiPerformanceHeader->SizeOfAllEntries;
+    GuidHob              = GetNextGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  *RecordsSize = 0;
+  if (Size == 0) {
+    return NULL;
+  }
+
+  Records = AllocatePool (Size);
+  if (Records == NULL) {
+    return NULL;
+  }
+
+  GuidHob = GetFirstGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid);
+  while (GuidHob != NULL) {
+    PeiPerformanceHeader = GET_GUID_HOB_DATA (GuidHob);
+    CopyMem (Records + *RecordsSize, PeiPerformanceHeader + 1, PeiPerformanceHeader->SizeOfAllEntries);
+    *RecordsSize += PeiPerformanceHeader->SizeOfAllEntries;
+    GuidHob       = GetNextGuidHob (&gEdkiiFpdtExtendedFirmwarePerformanceGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  return Records;
+}
+
+/**
+  Gets the performance records of the FPDT boot performance table.
+
+  @param[out] RecordsSize   Size of the returned records.
+
+  @return The records, in the boot performance table, or NULL.
+**/
+UINT8 *
+GetBootPerformanceRecords (
+  OUT UINTN  *RecordsSize
+  )
+{
+  FIRMWARE_PERFORMANCE_TABLE  *Fpdt;
+  BOOT_PERFORMANCE_TABLE      *Fbpt;
+
+  *RecordsSize = 0;
+
+  Fpdt = TestPointGetAcpi (EFI_ACPI_5_0_FIRMWARE_PERFORMANCE_DATA_TABLE_SIGNATURE);
+  if (Fpdt == NULL) {
+    return NULL;
+  }
+
+  Fbpt = (BOOT_PERFORMANCE_TABLE *)(UINTN)Fpdt->BootPointerRecord.BootPerformanceTablePointer;
+  if ((Fbpt == NULL) || (Fbpt->Header.Length < sizeof (BOOT_PERFORMANCE_TABLE))) {
+    return NULL;
+  }
+
+  *RecordsSize = Fbpt->Header.Length - sizeof (BOOT_PERFORMANCE_TABLE);
+  return (UINT8 *)(Fbpt + 1);
+}
+
+/**
+  Gets the start and end progress IDs measured for a budget type.
+
+  @param[in]  Type        Budget type.
+  @param[out] StartId     Progress ID of the start records.
+  @param[out] EndId       Progress ID of the end records.
+
+  @retval TRUE   The type is a module budget.
+  @retval FALSE  The type is a phase budget or unknown.
+**/
+BOOLEAN
+GetModuleProgressId (
+  IN  UINT32  Type,
+  OUT UINT16  *StartId,
+  OUT UINT16  *EndId
+  )
+{
+  switch (Type) {
+  case TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_ENTRY_POINT:
+    *StartId = MODULE_START_ID;
+    *EndId   = MODULE_END_ID;
+    return TRUE;
+  case TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_LOAD_IMAGE:
+    *StartId = MODULE_LOADIMAGE_START_ID;
+    *EndId   = MODULE_LOADIMAGE_END_ID;
+    return TRUE;
+  case TEST_POINT_BOOT_PERFORMANCE_BUDGET_TYPE_DRIVER_BINDING_START:
+    *StartId = MODULE_DB_START_ID;
+    *EndId   = MODULE_DB_END_ID;
+    return TRUE;
+  default:
+    return FALSE;
+  }
+}
+
+/**
+  Measures the time spent for one budget entry.
+
+  Module times are summed over all start/end pairs of the module, a phase
+  that has not ended yet is measured up to the last record.
+
+  @param[in]  Budget        The budget entry.
+  @param[in]  Records       The performance records.
+  @param[in]  RecordsSize   Size of the performance records.
+  @param[out] TimeInNs      The time measured, in nanoseconds.
+
+  @retval TRUE   The time was measured.
+  @retval FALSE  The records do not cover this entry.
+**/
+BOOLEAN
+MeasureBudgetTime (
+  IN  TEST_POINT_BOOT_PERFORMANCE_BUDGET  *Budget,
+  IN  UINT8                               *Records,
+  IN  UINTN                               RecordsSize,
+  OUT UINT64                              *TimeInNs
+  )
+{
+  UINTN            Offset;
+  FPDT_RECORD_PTR  RecordPtr;
+  UINT16           StartId;
+  UINT16           EndId;
+  CHAR8            *Token;
+  UINTN            Index;
+  UINT64           StartTimestamp;
+  UINT64           LastTimestamp;
+  BOOLEAN          Started;
+  BOOLEAN          Found;
+
+  Token = NULL;
+  if (!GetModuleProgressId (Budget->Type, &StartId, &EndId)) {
+    for (Index = 0; Index < ARRAY_SIZE (mBootPerformancePhase); Index++) {
+      if (mBootPerformancePhase[Index].Type == Budget->Type) {
+        Token = mBootPerformancePhase[Index].Token;
+        break;
+      }
+    }
+    if (Token == NULL) {
+      return FALSE;
+    }
+    StartId = PERF_CROSSMODULE_START_ID;
+    EndId   = PERF_CROSSMODULE_END_ID;
+  }
+
+  *TimeInNs      = 0;
+  StartTimestamp = 0;
+  LastTimestamp  = 0;
+  Started        = FALSE;
+  Found          = FALSE;
+
+  for (Offset = 0; Offset + sizeof (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER) <= RecordsSize; Offset += RecordPtr.RecordHeader->Length) {
+    RecordPtr.RecordHeader = (EFI_ACPI_5_0_FPDT_PERFORMANCE_RECORD_HEADER *)(Records + Offset);
+    if ((RecordPtr.RecordHeader->Length < sizeof (FPDT_GUID_EVENT_RECORD)) ||
+        (RecordPtr.RecordHeader->Length > RecordsSize - Offset)) {
+      break;
+    }
+
+    //
+    // All extended records except the dual GUID one start like the GUID event record
+    //
+    switch (RecordPtr.RecordHeader->Type) {
+    case FPDT_GUID_EVENT_TYPE:
+    case FPDT_DYNAMIC_STRING_EVENT_TYPE:
+    case FPDT_GUID_QWORD_EVENT_TYPE:
+    case FPDT_GUID_QWORD_STRING_EVENT_TYPE:
+      break;
+    default:
+      continue;
+    }
+
+    LastTimestamp = RecordPtr.GuidEvent->Timestamp;
+
+    if ((RecordPtr.GuidEvent->ProgressID != StartId) && (RecordPtr.GuidEvent->ProgressID != EndId)) {
+      continue;
+    }
+
+    if (Token != NULL) {
+      if ((RecordPtr.RecordHeader->Type != FPDT_DYNAMIC_STRING_EVENT_TYPE) ||
+          (RecordPtr.RecordHeader->Length < OFFSET_OF (FPDT_DYNAMIC_STRING_EVENT_RECORD, String) + AsciiStrSize (Token)) ||
+          (CompareMem (RecordPtr.DynamicStringEvent->String, Token, AsciiStrSize (Token)) != 0)) {
+        continue;
+      }
+    } else if (!CompareGuid (&RecordPtr.GuidEvent->Guid, &Budget->ModuleGuid)) {
+      continue;
+    }
+
+    if (RecordPtr.GuidEvent->ProgressID == StartId) {
+      StartTimestamp = RecordPtr.GuidEvent->Timestamp;
+      Started        = TRUE;
+    } else if (Started) {
+      *TimeInNs += RecordPtr.GuidEvent->Timestamp - StartTimestamp;
+      Started    = FALSE;
+      Found      = TRUE;
+    }
+  }
+
+  if (Started && (Token != NULL)) {
+    *TimeInNs += LastTimestamp - StartTimestamp;
+    Found      = TRUE;
+  }
+
+  return Found;
+}
+
+/**
+  Checks the performance records against the platform budget table in
+  PcdTestPointBootPerformanceBudget.
+
+  @param[in] Records       The performance records.
+  @param[in] RecordsSize   Size of the performance records.
+  @param[in] ErrorString   Error string to report violations with.
+
+  @retval EFI_SUCCESS            All measured times are within budget.
+  @retval EFI_INVALID_PARAMETER  At least one budget is exceeded.
+**/
+EFI_STATUS
+TestPointCheckBootPerformanceBudget (
+  IN UINT8   *Records,
+  IN UINTN   RecordsSize,
+  IN CHAR16  *ErrorString
+  )
+{
+  TEST_POINT_BOOT_PERFORMANCE_BUDGET  *Budget;
+  UINTN                               BudgetCount;
+  UINTN                               Index;
+  UINT64                              Time;
+  EFI_STATUS                          Status;
+
+  Budget      = PcdGetPtr (PcdTestPointBootPerformanceBudget);
+  BudgetCount = PcdGetSize (PcdTestPointBootPerformanceBudget) / sizeof (TEST_POINT_BOOT_PERFORMANCE_BUDGET);
+  Status      = EFI_SUCCESS;
+
+  DEBUG ((DEBUG_INFO, "Boot performance budget (%d entries, 0x%x bytes of records):\n", BudgetCount, RecordsSize));
+  for (Index = 0; Index < BudgetCount; Index++) {
+    if (!MeasureBudgetTime (&Budget[Index], Records, RecordsSize, &Time)) {
+      continue;
+    }
+    Time = DivU64x32 (Time, 1000);
+
+    DEBUG ((
+      DEBUG_INFO,
+      "  %g type 0x%x - %ld us, budget %d us\n",
+      &Budget[Index].ModuleGuid,
+      Budget[Index].Type,
+      Time,
+      Budget[Index].BudgetInUs
+      ));
+    if (Time > Budget[Index].BudgetInUs) {
+      DEBUG ((DEBUG_ERROR, "  %g type 0x%x is over budget\n", &Budget[Index].ModuleGuid, Budget[Index].Type));
+      Status = EFI_INVALID_PARAMETER;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    TestPointLibAppendErrorString (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      ErrorString
+      );
+  }
+
+  return Status;
+}
+
+/**
+  Checks the PEI performance records against the budget table at End Of DXE.
+
+  @retval EFI_SUCCESS            All measured times are within budget.
+  @retval EFI_INVALID_PARAMETER  At least one budget is exceeded.
+**/
+EFI_STATUS
+TestPointCheckPeiBootPerformance (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Records;
+  UINTN       RecordsSize;
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckPeiBootPerformance - Enter\n"));
+
+  Records = GetPeiPerformanceRecords (&RecordsSize);
+  Status  = TestPointCheckBootPerformanceBudget (
+              Records,
+              RecordsSize,
+              TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET_ERROR_CODE \
+                TEST_POINT_END_OF_DXE \
+                TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET_ERROR_STRING
+              );
+  if (Records != NULL) {
+    FreePool (Records);
+  }
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckPeiBootPerformance - Exit\n"));
+  return Status;
+}
+
+/**
+  Checks the FPDT boot performance records against the budget table at
+  Ready To Boot. Uses the PEI records when the FPDT is not installed.
+
+  @retval EFI_SUCCESS            All measured times are within budget.
+  @retval EFI_INVALID_PARAMETER  At least one budget is exceeded.
+**/
+EFI_STATUS
+TestPointCheckBootPerformance (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *Records;
+  UINTN       RecordsSize;
+  UINT8       *PeiRecords;
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Enter\n"));
+
+  PeiRecords = NULL;
+  Records    = GetBootPerformanceRecords (&RecordsSize);
+  if (Records == NULL) {
+    DEBUG ((DEBUG_INFO, "No FPDT boot performance table, checking PEI records only\n"));
+    PeiRecords = GetPeiPerformanceRecords (&RecordsSize);
+    Records    = PeiRecords;
+  }
+
+  Status = TestPointCheckBootPerformanceBudget (
+             Records,
+             RecordsSize,
+             TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_CODE \
+               TEST_POINT_READY_TO_BOOT \
+               TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET_ERROR_STRING
+             );
+  if (PeiRecords != NULL) {
+    FreePool (PeiRecords);
+  }
+
+  DEBUG ((DEBUG_INFO, "==== TestPointCheckBootPerformance - Exit\n"));
+  return Status;
+}
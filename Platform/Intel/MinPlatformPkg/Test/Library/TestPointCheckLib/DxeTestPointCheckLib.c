@@ -102,6 +102,16 @@ TestPointCheckEsrt (
   VOID
   );
 
+EFI_STATUS
+TestPointCheckPeiBootPerformance (
+  VOID
+  );
+
+EFI_STATUS
+TestPointCheckBootPerformance (
+  VOID
+  );
+
 EFI_STATUS
 TestPointCheckSmmInfo (
   VOID
@@ -1062,6 +1072,100 @@ TestPointReadyToBootEsrtTableFunctional (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the PEI boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each PEIM and of the PEI phase, as recorded
+                 in the FPDT performance HOBs, is within the budget listed in
+                 PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxeBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+
+  if ((mFeatureImplemented[8] & TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfDxeBootPerformanceBudget - Enter\n"));
+
+  Result = TRUE;
+  Status = TestPointCheckPeiBootPerformance ();
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      8,
+      TEST_POINT_BYTE8_END_OF_DXE_BOOT_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointEndOfDxeBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
+/**
+  This service verifies the boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each module and of each boot phase, as
+                 recorded in the FPDT boot performance table, is within the
+                 budget listed in PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Result;
+
+  if ((mFeatureImplemented[8] & TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootBootPerformanceBudget - Enter\n"));
+
+  Result = TRUE;
+  Status = TestPointCheckBootPerformance ();
+  if (EFI_ERROR(Status)) {
+    Result = FALSE;
+  }
+
+  if (Result) {
+    TestPointLibSetFeaturesVerified (
+      PLATFORM_TEST_POINT_ROLE_PLATFORM_IBV,
+      NULL,
+      8,
+      TEST_POINT_BYTE8_READY_TO_BOOT_BOOT_PERFORMANCE_BUDGET
+      );
+  }
+
+  DEBUG ((DEBUG_INFO, "======== TestPointReadyToBootBootPerformanceBudget - Exit\n"));
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies UEFI Secure Boot is enabled.
 
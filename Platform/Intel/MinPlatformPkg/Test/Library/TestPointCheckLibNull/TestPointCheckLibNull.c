@@ -516,6 +516,50 @@ TestPointReadyToBootEsrtTableFunctional (
   return EFI_SUCCESS;
 }
 
+/**
+  This service verifies the PEI boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each PEIM and of the PEI phase, as recorded
+                 in the FPDT performance HOBs, is within the budget listed in
+                 PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointEndOfDxeBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  This service verifies the boot performance against the platform budget.
+
+  Test subject: Boot performance.
+  Test overview: Verify the time of each module and of each boot phase, as
+                 recorded in the FPDT boot performance table, is within the
+                 budget listed in PcdTestPointBootPerformanceBudget.
+  Reporting mechanism: Set ADAPTER_INFO_PLATFORM_TEST_POINT_STRUCT.
+                       Dumps the measured and budgeted times.
+
+  @retval EFI_SUCCESS         The test point check was performed successfully.
+  @retval EFI_UNSUPPORTED     The test point check is not supported on this platform.
+**/
+EFI_STATUS
+EFIAPI
+TestPointReadyToBootBootPerformanceBudget (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
 /**
   This service verifies UEFI Secure Boot is enabled.
 
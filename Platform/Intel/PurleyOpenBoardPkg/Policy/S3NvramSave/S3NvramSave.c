@@ -171,7 +171,7 @@ SaveS3StructToNvram (
         ASSERT (CompressedVariableData != NULL); 
         if (Status == EFI_SUCCESS) {
           CompressedBufferSize = BufferSize;
-          Status = Compress(HobData, S3ChunkSize, CompressedVariableData, &CompressedBufferSize);
+          Status = CompressWithLevel (HobData, S3ChunkSize, CompressedVariableData, &CompressedBufferSize, COMPRESS_LEVEL_DEFAULT);
           if (Status == EFI_BUFFER_TOO_SMALL){
             gBS->FreePool(CompressedVariableData);
             Status = gBS->AllocatePool(
@@ -180,7 +180,7 @@ SaveS3StructToNvram (
                             (VOID**)&CompressedVariableData
                             );
             ASSERT (CompressedVariableData != NULL);
-            Status = Compress(HobData, S3ChunkSize, CompressedVariableData, &CompressedBufferSize);
+            Status = CompressWithLevel (HobData, S3ChunkSize, CompressedVariableData, &CompressedBufferSize, COMPRESS_LEVEL_DEFAULT);
           }
           if(Status == EFI_SUCCESS) {
             Status = gRT->SetVariable (
@@ -12,6 +12,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/IoLib.h>
 #include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/TimerLib.h>
 #include <Library/PchCycleDecodingLib.h>
@@ -33,6 +34,9 @@
 /**
   Configures GPIO
 
+  The table is translated into a pad configuration image and programmed from it.
+  If the image cannot be built, the table is programmed directly.
+
   @param[in]  GpioTable       Point to Platform Gpio table
   @param[in]  GpioTableCount  Number of Gpio table entries
 
@@ -43,13 +47,33 @@ ConfigureGpio (
   IN UINT16                           GpioTableCount
   )
 {
+  EFI_STATUS                          Status;
+  VOID                                *Image;
+  UINT32                              ImageSize;
+
   DEBUG ((DEBUG_INFO, "ConfigureGpio() Start\n"));
 
 
   CreateGpioCheckConflictHob (GpioDefinition, GpioTableCount);
 
+  Image     = NULL;
+  ImageSize = 0;
+  Status    = GpioBuildPadConfigImage (GpioTableCount, GpioDefinition, NULL, &ImageSize);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Image = AllocatePool (ImageSize);
+    if (Image != NULL) {
+      Status = GpioBuildPadConfigImage (GpioTableCount, GpioDefinition, Image, &ImageSize);
+      if (!EFI_ERROR (Status)) {
+        Status = GpioConfigurePadsFromImage (Image);
+      }
+      FreePool (Image);
+    }
+  }
 
-  GpioConfigurePads (GpioTableCount, GpioDefinition);
+  if ((Image == NULL) || EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "GPIO pad configuration image not used, Status = %r\n", Status));
+    GpioConfigurePads (GpioTableCount, GpioDefinition);
+  }
 
   DEBUG ((DEBUG_INFO, "ConfigureGpio() End\n"));
 }
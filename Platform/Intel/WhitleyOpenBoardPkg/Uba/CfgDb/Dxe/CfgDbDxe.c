@@ -10,15 +10,42 @@
 #include "CfgDbDxe.h"
 
 #include <PiDxe.h>  // For Hob
+#include <Guid/EventGroup.h>
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/HobLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+/**
+  Internal function for getting the hash index bucket of a resource ID.
+
+  @param ResId                  The resource ID.
+
+  @retval                       The bucket number.
+**/
+STATIC
+UINTN
+InternalResIdHash (
+  IN  CONST EFI_GUID                      *ResId
+  )
+{
+  UINT32                                Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *) ResId) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (UBA_CONFIG_HASH_BUCKETS - 1);
+}
+
 /**
   Internal function for getting the platform record node in the database.
 
@@ -96,8 +123,9 @@ InternalInitSkuDxe (
   if (SkuNode != NULL) {
     // Output the point of sku node.
     *SkuNode = NewSkuNode;
-    // Pass the point to CurrentSku in UbaDxePrivate.
+    // Pass the point to CurrentSku in UbaDxePrivate, the index only covers CurrentSku.
     UbaDxePrivate->CurrentSku = NewSkuNode;
+    ZeroMem (UbaDxePrivate->HashBuckets, sizeof (UbaDxePrivate->HashBuckets));
   }
 
   return EFI_SUCCESS;
@@ -110,6 +138,8 @@ InternalInitSkuDxe (
   @param ResId                  The resource ID.
   @param Data                   Data pointer.
   @param DataSize               Data size.
+  @param CopyData               TRUE to keep a copy of the data, FALSE to reference
+                                data which stays valid, e.g. in the HOB from PEI.
 
   @retval EFI_INVALID_PARAMETER Parameter invalid.
   @retval EFI_OUT_OF_RESOURCES  No enough resource.
@@ -120,14 +150,18 @@ InternalAddNewConfigData (
   IN  UBA_CONFIG_DATABASE_PROTOCOL        *This,
   IN  EFI_GUID                            *ResId,
   IN  VOID                                *Data,
-  IN  UINTN                               DataSize
+  IN  UINTN                               DataSize,
+  IN  BOOLEAN                             CopyData
   )
 {
   EFI_STATUS                      Status;
   EFI_HANDLE                      Handle;
   UBA_DXE_PRIVATE_DATA            *UbaDxePrivate;
+  UBA_DXE_CONFIG_NODE             *NewHashNode;
+  UBA_DXE_CONFIG_NODE             **HashLink;
   UBA_CONFIG_NODE                 *NewDataNode;
   UBA_BOARD_NODE                  *SkuNode;
+  UINTN                           NodeSize;
   UbaDxePrivate = NULL;
   NewDataNode   = NULL;
   SkuNode       = NULL;
@@ -143,20 +177,40 @@ InternalAddNewConfigData (
     return Status;
   }
 
-  NewDataNode = AllocateZeroPool (sizeof (UBA_CONFIG_NODE));
-  if (NewDataNode == NULL) {
+  //
+  // A copy of the data is kept in the same allocation as its node
+  //
+  NodeSize = ALIGN_VALUE (sizeof (UBA_DXE_CONFIG_NODE), sizeof (UINT64));
+  NewHashNode = AllocateZeroPool (CopyData ? NodeSize + DataSize : NodeSize);
+  if (NewHashNode == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
+  NewDataNode = &NewHashNode->Node;
 
   NewDataNode->Signature      = UBA_BOARD_SIGNATURE;
   NewDataNode->Version        = UBA_BOARD_VERSION;
   NewDataNode->Handle         = (EFI_HANDLE) (UINTN) UbaDxePrivate->HandleCount;
-  NewDataNode->Data           = AllocateCopyPool (DataSize, Data);
   NewDataNode->Size           = (UINT32) DataSize;
+  if (CopyData) {
+    NewDataNode->Data         = (UINT8 *) NewHashNode + NodeSize;
+    CopyMem (NewDataNode->Data, Data, DataSize);
+  } else {
+    NewDataNode->Data         = Data;
+  }
 
   CopyMem (&NewDataNode->ResId, ResId, sizeof (EFI_GUID));
 
   InsertTailList (&SkuNode->DataLinkHead, &NewDataNode->DataLink);
+
+  //
+  // Append to the hash chain so lookups keep returning the first added data
+  //
+  HashLink = &UbaDxePrivate->HashBuckets[InternalResIdHash (ResId)];
+  while (*HashLink != NULL) {
+    HashLink = &(*HashLink)->HashNext;
+  }
+  *HashLink = NewHashNode;
+
   SkuNode->DataCount ++;
   UbaDxePrivate->ConfigDataCount ++;
   UbaDxePrivate->HandleCount ++;
@@ -203,29 +257,21 @@ InternalGetConfigData (
   OUT UINTN                               *DataSize   OPTIONAL
   )
 {
-  LIST_ENTRY                            *ListHead;
-  LIST_ENTRY                            *Link;
+  UBA_DXE_PRIVATE_DATA                  *UbaDxePrivate;
+  UBA_DXE_CONFIG_NODE                   *HashNode;
   UBA_CONFIG_NODE                       *DataNode;
-  ListHead = NULL;
-  Link     = NULL;
   DataNode = NULL;
 
   if ((SkuNode == NULL) || (ResId == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  ListHead = &SkuNode->DataLinkHead;
-  if (IsListEmpty (ListHead)) {
-    return EFI_NOT_FOUND;
-  }
+  UbaDxePrivate = PRIVATE_DATA_FROM_PROTOCOL (This);
+  ASSERT (SkuNode == UbaDxePrivate->CurrentSku);
 
-  for (Link = GetFirstNode (ListHead); !IsNull (ListHead, Link); Link = GetNextNode (ListHead, Link)) {
+  for (HashNode = UbaDxePrivate->HashBuckets[InternalResIdHash (ResId)]; HashNode != NULL; HashNode = HashNode->HashNext) {
 
-    DataNode = CONFIG_NODE_INSTANCE_FROM_THIS (Link);
-    ASSERT (DataNode != NULL);
-    if (DataNode == NULL) {
-      return EFI_UNSUPPORTED;
-    }
+    DataNode = &HashNode->Node;
     if (CompareGuid (ResId, &DataNode->ResId)) {
 
       if (DataSize != NULL) {
@@ -331,7 +377,7 @@ DxeUbaAddData (
     return Status;
   }
 
-  Status = InternalAddNewConfigData (This, ResId, Data, DataSize);
+  Status = InternalAddNewConfigData (This, ResId, Data, DataSize, TRUE);
 
   return Status;
 }
@@ -360,7 +406,10 @@ DxeUbaGetData (
   )
 {
   EFI_STATUS                      Status;
+  UBA_DXE_PRIVATE_DATA            *UbaDxePrivate;
   UBA_BOARD_NODE                  *SkuNode;
+  UINT64                          StartTicks;
+  UINT64                          Ticks;
   SkuNode = NULL;
 
   if ((ResId == NULL) || (Data == NULL) || (DataSize == NULL)) {
@@ -372,7 +421,20 @@ DxeUbaGetData (
     return Status;
   }
 
+  UbaDxePrivate = PRIVATE_DATA_FROM_PROTOCOL (This);
+  StartTicks    = GetPerformanceCounter ();
+
   Status = InternalGetConfigData (This, SkuNode, ResId, Data, DataSize);
+
+  Ticks = GetPerformanceCounter ();
+  Ticks = UbaDxePrivate->CounterCountsDown ? StartTicks - Ticks : Ticks - StartTicks;
+  UbaDxePrivate->GetDataTicks += Ticks;
+  UbaDxePrivate->GetDataCount ++;
+  if (Status == EFI_NOT_FOUND) {
+    UbaDxePrivate->GetDataMissCount ++;
+  }
+  DEBUG ((DEBUG_VERBOSE, "UbaGetData: %g %r, %ld ns\n", ResId, Status, GetTimeInNanoSecond (Ticks)));
+
   if (!EFI_ERROR (Status)) {
     return EFI_SUCCESS;
   }
@@ -425,14 +487,15 @@ InternalGetConfigDataFromHob (
     return Status;
   }
 
-  // Obtain all data stored in the hob from PEI phase.
+  // Obtain all data stored in the hob from PEI phase, the data is referenced in place.
   for (Index = 0; Index < HobHeader->DataCount; Index ++) {
-    Status = This->AddData (
-                     This,
-                     &HobDataFieldStart[Index].ResId,
-                     (VOID *) ((UINTN) HobDataFieldStart[Index].DataOffset + (UINTN) HobHeader),
-                     HobDataFieldStart[Index].Size
-                     );
+    Status = InternalAddNewConfigData (
+               This,
+               &HobDataFieldStart[Index].ResId,
+               (VOID *) ((UINTN) HobDataFieldStart[Index].DataOffset + (UINTN) HobHeader),
+               HobDataFieldStart[Index].Size,
+               FALSE
+               );
     ASSERT_EFI_ERROR (Status);
     if (Status != EFI_SUCCESS) {
       return Status;
@@ -442,6 +505,35 @@ InternalGetConfigDataFromHob (
   return EFI_SUCCESS;
 }
 
+/**
+  End of DXE event callback, reports the GetData statistics.
+
+  @param Event                  Event whose notification function is being invoked.
+  @param Context                The UBA_DXE_PRIVATE_DATA instance.
+**/
+VOID
+EFIAPI
+UbaEndOfDxeCallback (
+  IN EFI_EVENT                             Event,
+  IN VOID                                  *Context
+  )
+{
+  UBA_DXE_PRIVATE_DATA                  *UbaDxePrivate;
+
+  UbaDxePrivate = (UBA_DXE_PRIVATE_DATA *) Context;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "UbaConfigDatabaseDxe: %d data, %ld GetData calls (%ld not found), %ld ns\n",
+    UbaDxePrivate->ConfigDataCount,
+    UbaDxePrivate->GetDataCount,
+    UbaDxePrivate->GetDataMissCount,
+    GetTimeInNanoSecond (UbaDxePrivate->GetDataTicks)
+    ));
+
+  gBS->CloseEvent (Event);
+}
+
 /**
   The Driver Entry Point.
 
@@ -464,6 +556,9 @@ UbaConfigDatabaseEntry (
   EFI_STATUS                            Status;
   UBA_DXE_PRIVATE_DATA                  *UbaDxePrivate;
   EFI_HANDLE                            Handle;
+  EFI_EVENT                             EndOfDxeEvent;
+  UINT64                                CounterStart;
+  UINT64                                CounterEnd;
   UbaDxePrivate = NULL;
 
   UbaDxePrivate = AllocateZeroPool (sizeof (UBA_DXE_PRIVATE_DATA));
@@ -478,6 +573,9 @@ UbaConfigDatabaseEntry (
   UbaDxePrivate->ConfigDataCount           = 0;
   UbaDxePrivate->HandleCount               = 0;
 
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  UbaDxePrivate->CounterCountsDown         = (BOOLEAN) (CounterEnd < CounterStart);
+
   UbaDxePrivate->UbaCfgDbProtocol.Signature      = UBA_CONFIG_PROTOCOL_SIGNATURE;
   UbaDxePrivate->UbaCfgDbProtocol.Version        = UBA_CONFIG_PROTOCOL_VERSION;
 
@@ -503,6 +601,18 @@ UbaConfigDatabaseEntry (
   // Init sku dxe and get configuration data from hob passed by PEIM.
   Status = InternalGetConfigDataFromHob (&UbaDxePrivate->UbaCfgDbProtocol);
   ASSERT_EFI_ERROR (Status);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  gBS->CreateEventEx (
+         EVT_NOTIFY_SIGNAL,
+         TPL_CALLBACK,
+         UbaEndOfDxeCallback,
+         UbaDxePrivate,
+         &gEfiEndOfDxeEventGroupGuid,
+         &EndOfDxeEvent
+         );
 
   return Status;
 }
@@ -15,6 +15,19 @@
 #include <Protocol/UbaCfgDb.h>
 #include <Guid/UbaCfgHob.h>
 
+//
+// Number of buckets of the ResId hash index, must be a power of two
+//
+#define UBA_CONFIG_HASH_BUCKETS         64
+
+//
+// Configuration data node, chained in a ResId hash bucket
+//
+typedef struct _UBA_DXE_CONFIG_NODE {
+  UBA_CONFIG_NODE                 Node;
+  struct _UBA_DXE_CONFIG_NODE     *HashNext;
+} UBA_DXE_CONFIG_NODE;
+
 typedef struct _UBA_DXE_PRIVATE_DATA {
   UINT32                          Signature;
   UINT32                          Version;
@@ -22,6 +35,12 @@ typedef struct _UBA_DXE_PRIVATE_DATA {
   UINTN                           ConfigDataCount;              //for AllConfigDataSize
   UINTN                           HandleCount;
   UBA_BOARD_NODE                  *CurrentSku;
+  UBA_DXE_CONFIG_NODE             *HashBuckets[UBA_CONFIG_HASH_BUCKETS];   //ResId index of CurrentSku data
+
+  UINT64                          GetDataCount;                 //GetData statistics, reported at EndOfDxe
+  UINT64                          GetDataMissCount;
+  UINT64                          GetDataTicks;
+  BOOLEAN                         CounterCountsDown;
 
   UBA_CONFIG_DATABASE_PROTOCOL   UbaCfgDbProtocol;
 } UBA_DXE_PRIVATE_DATA;
@@ -20,6 +20,31 @@
 #include <Library/PeiServicesLib.h>
 #include <Library/PeiServicesTablePointerLib.h>
 
+/**
+  Internal function for getting the hash index bucket of a resource ID.
+
+  @param ResId                  The resource ID.
+
+  @retval                       The bucket number.
+**/
+STATIC
+UINTN
+InternalResIdHash (
+  IN  CONST EFI_GUID                      *ResId
+  )
+{
+  UINT32                                Hash;
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *) ResId) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *) ResId + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (UBA_CONFIG_HASH_BUCKETS - 1);
+}
+
 /**
   Internal function for getting the platform record node in the database.
 
@@ -98,6 +123,7 @@ InternalInitSku (
   if (SkuNode != NULL) {
     *SkuNode = NewSkuNode;
     UbaPeimPrivate->CurrentSku = NewSkuNode;
+    ZeroMem (UbaPeimPrivate->HashBuckets, sizeof (UbaPeimPrivate->HashBuckets));
   }
 
   return EFI_SUCCESS;
@@ -125,6 +151,8 @@ InternalAddNewConfigData (
 {
   EFI_STATUS                      Status;
   UBA_PEIM_PRIVATE_DATA           *UbaPeimPrivate;
+  UBA_PEIM_CONFIG_NODE            *NewHashNode;
+  UBA_PEIM_CONFIG_NODE            **HashLink;
   UBA_CONFIG_NODE                 *NewDataNode;
   UBA_BOARD_NODE                  *SkuNode;
   EFI_PEI_PPI_DESCRIPTOR          *ConfigDataPpi;
@@ -144,10 +172,11 @@ InternalAddNewConfigData (
     return Status;
   }
 
-  NewDataNode = AllocateZeroPool (sizeof (UBA_CONFIG_NODE));
-  if (NewDataNode == NULL) {
+  NewHashNode = AllocateZeroPool (sizeof (UBA_PEIM_CONFIG_NODE));
+  if (NewHashNode == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
+  NewDataNode = &NewHashNode->Node;
 
   NewDataNode->Signature      = UBA_BOARD_SIGNATURE;
   NewDataNode->Version        = UBA_BOARD_VERSION;
@@ -158,6 +187,16 @@ InternalAddNewConfigData (
   CopyMem (&NewDataNode->ResId, ResId, sizeof (EFI_GUID));
 
   InsertTailList (&SkuNode->DataLinkHead, &NewDataNode->DataLink);
+
+  //
+  // Append to the hash chain so lookups keep returning the first added data
+  //
+  HashLink = &UbaPeimPrivate->HashBuckets[InternalResIdHash (ResId)];
+  while (*HashLink != NULL) {
+    HashLink = &(*HashLink)->HashNext;
+  }
+  *HashLink = NewHashNode;
+
   SkuNode->DataCount ++;
   UbaPeimPrivate->ConfigDataCount ++;
   UbaPeimPrivate->HandleCount ++;
@@ -207,30 +246,21 @@ InternalGetConfigData (
   OUT UINTN                               *DataSize   OPTIONAL
   )
 {
-  LIST_ENTRY                            *ListHead;
-  LIST_ENTRY                            *Link;
+  UBA_PEIM_PRIVATE_DATA                 *UbaPeimPrivate;
+  UBA_PEIM_CONFIG_NODE                  *HashNode;
   UBA_CONFIG_NODE                       *DataNode;
-  ListHead = NULL;
-  Link = NULL;
   DataNode = NULL;
 
   if ((SkuNode == NULL) || (ResId == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  ListHead = &SkuNode->DataLinkHead;
-  if (IsListEmpty (ListHead)) {
-    return EFI_NOT_FOUND;
-  }
-
-  for (Link = GetFirstNode (ListHead); !IsNull (ListHead, Link); Link = GetNextNode (ListHead, Link)) {
+  UbaPeimPrivate = PRIVATE_DATA_FROM_PPI (This);
+  ASSERT (SkuNode == UbaPeimPrivate->CurrentSku);
 
-    DataNode = CONFIG_NODE_INSTANCE_FROM_THIS (Link);
-    ASSERT (DataNode != NULL);
-    if (DataNode == NULL) {
-      return EFI_UNSUPPORTED;
-    }
+  for (HashNode = UbaPeimPrivate->HashBuckets[InternalResIdHash (ResId)]; HashNode != NULL; HashNode = HashNode->HashNext) {
 
+    DataNode = &HashNode->Node;
     if (CompareGuid (ResId, &DataNode->ResId)) {
 
       if (DataSize != NULL) {
@@ -325,8 +355,10 @@ PeiConvertDataPointer (
   UBA_PEIM_PRIVATE_DATA                 *UbaPeimPrivate;
   UBA_BOARD_NODE                        *SkuNode;
   UBA_CONFIG_NODE                       *DataNode;
+  UBA_PEIM_CONFIG_NODE                  *HashNode;
   LIST_ENTRY                            *DataListHead;
   LIST_ENTRY                            *DataLink;
+  UINTN                                 Index;
   UbaPeimPrivate = NULL;
   SkuNode = NULL;
   DataNode = NULL;
@@ -351,10 +383,20 @@ PeiConvertDataPointer (
     PeiConvertListPointer (DataLink, PtrPositive, PtrDelta);
     DataNode = CONFIG_NODE_INSTANCE_FROM_THIS (DataLink);
     PeiConvertVoidPointer (&DataNode->Data, PtrPositive, PtrDelta);
+    HashNode = BASE_CR (DataNode, UBA_PEIM_CONFIG_NODE, Node);
+    if (HashNode->HashNext != NULL) {
+      PeiConvertVoidPointer ((VOID**) &HashNode->HashNext, PtrPositive, PtrDelta);
+    }
 
     DataLink = DataLink->ForwardLink;
   }
 
+  for (Index = 0; Index < UBA_CONFIG_HASH_BUCKETS; Index ++) {
+    if (UbaPeimPrivate->HashBuckets[Index] != NULL) {
+      PeiConvertVoidPointer ((VOID**) &UbaPeimPrivate->HashBuckets[Index], PtrPositive, PtrDelta);
+    }
+  }
+
   UbaPeimPrivate->ThisAddress = (UINTN) This;
 
   return EFI_SUCCESS;
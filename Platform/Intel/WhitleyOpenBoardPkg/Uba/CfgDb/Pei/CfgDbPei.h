@@ -15,6 +15,19 @@
 #include <Ppi/UbaCfgDb.h>
 #include <Guid/UbaCfgHob.h>
 
+//
+// Number of buckets of the ResId hash index, must be a power of two
+//
+#define UBA_CONFIG_HASH_BUCKETS         32
+
+//
+// Configuration data node, chained in a ResId hash bucket
+//
+typedef struct _UBA_PEIM_CONFIG_NODE {
+  UBA_CONFIG_NODE                 Node;
+  struct _UBA_PEIM_CONFIG_NODE    *HashNext;
+} UBA_PEIM_CONFIG_NODE;
+
 typedef struct _UBA_PEIM_PRIVATE_DATA {
   UINT32                          Signature;
   UINT32                          Version;
@@ -22,6 +35,7 @@ typedef struct _UBA_PEIM_PRIVATE_DATA {
   UINTN                           ConfigDataCount;      //for AllConfigDataSize
   UINTN                           HandleCount;
   UBA_BOARD_NODE                  *CurrentSku;
+  UBA_PEIM_CONFIG_NODE            *HashBuckets[UBA_CONFIG_HASH_BUCKETS];   //ResId index of CurrentSku data
   UINTN                           ThisAddress;
 
   UBA_CONFIG_DATABASE_PPI         UbaCfgDbPpi;
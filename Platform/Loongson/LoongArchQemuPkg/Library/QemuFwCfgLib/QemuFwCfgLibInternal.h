@@ -26,6 +26,17 @@ InternalQemuFwCfgIsAvailable (
   VOID
   );
 
+/**
+  To get firmware configure DMA address.
+
+  @retval  firmware configure DMA address, 0 if the DMA interface is unavailable
+**/
+UINTN
+EFIAPI
+QemuGetFwCfgDmaAddress (
+  VOID
+  );
+
 /**
   Returns a boolean indicating whether QEMU provides the DMA-like access method
   for fw_cfg.
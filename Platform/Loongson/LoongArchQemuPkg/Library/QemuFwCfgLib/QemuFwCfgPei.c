@@ -11,6 +11,7 @@
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
+#include <Library/IoLib.h>
 #include <Library/QemuFwCfgLib.h>
 
 #include "QemuFwCfgLibInternal.h"
@@ -84,7 +85,7 @@ InternalQemuFwCfgDmaIsAvailable (
   VOID
   )
 {
-  return FALSE;
+  return QemuGetFwCfgDmaAddress () != 0;
 }
 
 /**
@@ -109,9 +110,45 @@ InternalQemuFwCfgDmaBytes (
   IN     UINT32   Control
   )
 {
+  volatile FW_CFG_DMA_ACCESS  Access;
+  UINT32                      Status;
+
+  //
+  // Size is zero, or there is nothing to transfer or skip.
+  //
+  if (Size == 0) {
+    return;
+  }
+
+  Access.Control = SwapBytes32 (Control);
+  Access.Length  = SwapBytes32 (Size);
+  Access.Address = SwapBytes64 ((UINTN)Buffer);
+
+  //
+  // Make sure the descriptor and any data to write reach memory before
+  // QEMU is told about the descriptor.
+  //
+  MemoryFence ();
+
+  //
+  // Writing the big-endian descriptor address starts the transfer.
+  //
+  MmioWrite64 (QemuGetFwCfgDmaAddress (), SwapBytes64 ((UINTN)&Access));
+
+  //
+  // QEMU clears all control bits except ERROR once done.
+  //
+  do {
+    Status = SwapBytes32 (Access.Control);
+  } while ((Status & ~FW_CFG_DMA_CTL_ERROR) != 0);
+
+  if ((Status & FW_CFG_DMA_CTL_ERROR) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a: fw_cfg DMA error, Control 0x%x\n", __FUNCTION__, Control));
+    ASSERT (FALSE);
+  }
+
   //
-  // We should never reach here
+  // Make sure the data read by QEMU is visible to the caller.
   //
-  ASSERT (FALSE);
-  CpuDeadLoop ();
+  MemoryFence ();
 }
@@ -23,6 +23,7 @@
 
 STATIC UINTN mFwCfgSelectorAddress;
 STATIC UINTN mFwCfgDataAddress;
+STATIC UINTN mFwCfgDmaAddress;
 /**
   To get firmware configure selector address.
 
@@ -61,6 +62,25 @@ QemuGetFwCfgDataAddress (
   }
   return FwCfgDataAddress;
 }
+/**
+  To get firmware configure DMA address.
+
+  @param VOID
+
+  @retval  firmware configure DMA address, 0 if the DMA interface is unavailable
+**/
+UINTN
+EFIAPI
+QemuGetFwCfgDmaAddress (
+  VOID
+  )
+{
+  UINTN FwCfgDmaAddress = mFwCfgDmaAddress;
+  if (FwCfgDmaAddress == 0) {
+    FwCfgDmaAddress = (UINTN)PcdGet64 (PcdFwCfgDmaAddress);
+  }
+  return FwCfgDmaAddress;
+}
 /**
   Selects a firmware configuration item for reading.
 
@@ -404,6 +424,8 @@ QemuFwCfgInitialize (
   UINT64            FwCfgSelectorAddress;
   UINT64            FwCfgDataAddress;
   UINT64            FwCfgDataSize;
+  UINT64            FwCfgRegSize;
+  UINT32            Features;
   RETURN_STATUS     PcdStatus;
 
   DeviceTreeBase = (VOID *) (UINTN)PcdGet64 (PcdDeviceTreeBase);
@@ -451,6 +473,26 @@ QemuFwCfgInitialize (
           FwCfgDataAddress
           );
         ASSERT_RETURN_ERROR (PcdStatus);
+
+        //
+        // The DMA address register follows the selector, when the region
+        // covers it and the device advertises the DMA feature.
+        //
+        FwCfgRegSize = SwapBytes64 (RegProp[1]);
+        if (FwCfgRegSize >= 0x18) {
+          QemuFwCfgSelectItem (QemuFwCfgItemInterfaceVersion);
+          Features = QemuFwCfgRead32 ();
+          if ((Features & FW_CFG_F_DMA) != 0) {
+            mFwCfgDmaAddress = (UINTN)(FwCfgDataAddress + 0x10);
+            DEBUG ((DEBUG_INFO, "QemuFwCfg DMA interface at 0x%lx\n", mFwCfgDmaAddress));
+
+            PcdStatus = PcdSet64S (
+              PcdFwCfgDmaAddress,
+              mFwCfgDmaAddress
+              );
+            ASSERT_RETURN_ERROR (PcdStatus);
+          }
+        }
         break;
       } else {
         DEBUG ((DEBUG_ERROR, "%a: Failed to parse FDT QemuCfg node\n",
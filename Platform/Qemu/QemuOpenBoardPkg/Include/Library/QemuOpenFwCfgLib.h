@@ -29,6 +29,21 @@
 
 #define FW_CFG_QEMU_SIGNATURE SIGNATURE_32('Q', 'E', 'M', 'U')
 
+// Reading the DMA address register returns "QEMU CFG" when DMA is supported
+#define FW_CFG_DMA_SIGNATURE_HI  SIGNATURE_32('Q', 'E', 'M', 'U')
+#define FW_CFG_DMA_SIGNATURE_LO  SIGNATURE_32(' ', 'C', 'F', 'G')
+
+// FW_CFG_ID feature bits
+#define FW_CFG_FEATURE_TRADITIONAL  BIT0
+#define FW_CFG_FEATURE_DMA          BIT1
+
+// QEMU fw_cfg DMA control bits
+#define FW_CFG_DMA_CONTROL_ERROR   BIT0
+#define FW_CFG_DMA_CONTROL_READ    BIT1
+#define FW_CFG_DMA_CONTROL_SKIP    BIT2
+#define FW_CFG_DMA_CONTROL_SELECT  BIT3
+#define FW_CFG_DMA_CONTROL_WRITE   BIT4
+
 typedef struct {
   UINT32    Size;
   UINT16    Select;
@@ -36,6 +51,24 @@ typedef struct {
   CHAR8     Name[56];
 } QEMU_FW_CFG_FILE;
 
+//
+// Data of the gQemuOpenFwCfgFileDirHobGuid HOB: the fw_cfg file directory
+// with Size and Select in CPU byte order, sorted by Name
+//
+typedef struct {
+  UINT32              FileCount;
+  QEMU_FW_CFG_FILE    Files[];
+} QEMU_FW_CFG_FILE_DIR;
+
+// QEMU fw_cfg DMA access descriptor, all fields are big-endian
+#pragma pack (1)
+typedef struct {
+  UINT32    Control;
+  UINT32    Length;
+  UINT64    Address;
+} QEMU_FW_CFG_DMA_ACCESS;
+#pragma pack ()
+
 /**
   Checks for Qemu fw_cfg device by reading "QEMU" using the signature selector
 
@@ -86,6 +119,57 @@ QemuFwCfgReadBytes (
   OUT VOID  *Buffer
   );
 
+/**
+  Writes N bytes to the data register
+
+  @param[in] Size
+  @param[in] Buffer
+ */
+VOID
+EFIAPI
+QemuFwCfgWriteBytes (
+  IN UINTN  Size,
+  IN VOID   *Buffer
+  );
+
+/**
+  Skips N bytes of the selected item
+
+  @param[in] Size
+ */
+VOID
+EFIAPI
+QemuFwCfgSkipBytes (
+  IN UINTN  Size
+  );
+
+/**
+  Checks whether the fw_cfg DMA interface is available, using the FW_CFG_ID
+  feature bitmap. This changes the selected item.
+
+  @return TRUE  - The DMA interface can be used
+  @return FALSE - Only the port I/O interface is available
+ */
+BOOLEAN
+EFIAPI
+QemuFwCfgDmaIsAvailable (
+  VOID
+  );
+
+/**
+  Reads the fw_cfg file directory once and saves it sorted by name in a
+  gQemuOpenFwCfgFileDirHobGuid HOB, for QemuFwCfgFindFile to search in PEI
+  and DXE. Must be called from PEI. This changes the selected item.
+
+  @return EFI_SUCCESS - The HOB was built, or already exists
+  @return EFI_OUT_OF_RESOURCES - The directory does not fit in a HOB
+ */
+EFI_STATUS
+EFIAPI
+QemuFwCfgBuildFileDirHob (
+  VOID
+  );
+
 /**
   Finds a file in fw_cfg by its name
 
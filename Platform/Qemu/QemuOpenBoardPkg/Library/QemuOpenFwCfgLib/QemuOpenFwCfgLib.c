@@ -11,8 +11,16 @@
 **/
 
 #include <Library/QemuOpenFwCfgLib.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+
+//
+// Transfers below this size are cheaper through the data register than
+// through a DMA descriptor
+//
+#define FW_CFG_DMA_THRESHOLD  16
 
 /**
   Reads 8 bits from the data register.
@@ -53,9 +61,78 @@ QemuFwCfgSelectItem (
   return EFI_SUCCESS;
 }
 
+/**
+  Checks the DMA address register signature.
+
+  Unlike the FW_CFG_ID feature bitmap, this does not change the selected item,
+  so it can be checked in the middle of a transfer. The library may run from
+  flash in PEI, so the result cannot be cached in a global.
+
+  @retval TRUE  The DMA interface is present
+  @retval FALSE The DMA interface is absent
+**/
+STATIC
+BOOLEAN
+QemuFwCfgDmaSignatureMatches (
+  VOID
+  )
+{
+  return IoRead32 (FW_CFG_PORT_DMA) == FW_CFG_DMA_SIGNATURE_HI &&
+         IoRead32 (FW_CFG_PORT_DMA + 4) == FW_CFG_DMA_SIGNATURE_LO;
+}
+
+/**
+  Transfers or skips N bytes of the selected item through the DMA interface
+
+  @param Size
+  @param Buffer   Ignored for FW_CFG_DMA_CONTROL_SKIP
+  @param Control  FW_CFG_DMA_CONTROL_READ, _WRITE or _SKIP
+**/
+STATIC
+VOID
+QemuFwCfgDmaBytes (
+  IN     UINT32  Size,
+  IN OUT VOID    *Buffer OPTIONAL,
+  IN     UINT32  Control
+  )
+{
+  volatile QEMU_FW_CFG_DMA_ACCESS  Access;
+  UINT64                           AccessAddress;
+
+  Access.Control = SwapBytes32 (Control);
+  Access.Length  = SwapBytes32 (Size);
+  Access.Address = SwapBytes64 ((UINTN)Buffer);
+
+  //
+  // Make the descriptor and any data to write visible before starting,
+  // writing the low half of the address triggers the transfer
+  //
+  MemoryFence ();
+
+  AccessAddress = (UINTN)&Access;
+  IoWrite32 (FW_CFG_PORT_DMA, SwapBytes32 ((UINT32)RShiftU64 (AccessAddress, 32)));
+  IoWrite32 (FW_CFG_PORT_DMA + 4, SwapBytes32 ((UINT32)AccessAddress));
+
+  //
+  // QEMU completes the transfer synchronously, this normally doesn't spin
+  //
+  while ((SwapBytes32 (Access.Control) & ~FW_CFG_DMA_CONTROL_ERROR) != 0) {
+    CpuPause ();
+  }
+
+  MemoryFence ();
+
+  if ((SwapBytes32 (Access.Control) & FW_CFG_DMA_CONTROL_ERROR) != 0) {
+    DEBUG ((DEBUG_ERROR, "QemuFwCfg: DMA transfer error, control 0x%x\n", Control));
+    ASSERT (FALSE);
+  }
+}
+
 /**
   Reads N bytes from the data register
 
+  Uses the DMA interface for bulk reads when available.
+
   @param Size
   @param Buffer
 **/
@@ -66,9 +143,93 @@ QemuFwCfgReadBytes (
   OUT VOID  *Buffer
   )
 {
+  if ((Size >= FW_CFG_DMA_THRESHOLD) && (Size <= MAX_UINT32) &&
+      QemuFwCfgDmaSignatureMatches ())
+  {
+    QemuFwCfgDmaBytes ((UINT32)Size, Buffer, FW_CFG_DMA_CONTROL_READ);
+    return;
+  }
+
   IoReadFifo8 (FW_CFG_PORT_DATA, Size, Buffer);
 }
 
+/**
+  Writes N bytes to the data register
+
+  Writes are only supported by QEMU through the DMA interface, they are
+  ignored otherwise.
+
+  @param Size
+  @param Buffer
+**/
+VOID
+EFIAPI
+QemuFwCfgWriteBytes (
+  IN UINTN  Size,
+  IN VOID   *Buffer
+  )
+{
+  if ((Size <= MAX_UINT32) && QemuFwCfgDmaSignatureMatches ()) {
+    QemuFwCfgDmaBytes ((UINT32)Size, Buffer, FW_CFG_DMA_CONTROL_WRITE);
+    return;
+  }
+
+  IoWriteFifo8 (FW_CFG_PORT_DATA, Size, Buffer);
+}
+
+/**
+  Skips N bytes of the selected item
+
+  @param Size
+**/
+VOID
+EFIAPI
+QemuFwCfgSkipBytes (
+  IN UINTN  Size
+  )
+{
+  UINTN  ChunkSize;
+  UINT8  SkipBuffer[256];
+
+  if ((Size <= MAX_UINT32) && QemuFwCfgDmaSignatureMatches ()) {
+    QemuFwCfgDmaBytes ((UINT32)Size, NULL, FW_CFG_DMA_CONTROL_SKIP);
+    return;
+  }
+
+  while (Size > 0) {
+    ChunkSize = MIN (Size, sizeof (SkipBuffer));
+    IoReadFifo8 (FW_CFG_PORT_DATA, ChunkSize, SkipBuffer);
+    Size -= ChunkSize;
+  }
+}
+
+/**
+  Checks whether the fw_cfg DMA interface is available, using the FW_CFG_ID
+  feature bitmap. This changes the selected item.
+
+  @retval TRUE  - The DMA interface can be used
+  @retval FALSE - Only the port I/O interface is available
+**/
+BOOLEAN
+EFIAPI
+QemuFwCfgDmaIsAvailable (
+  VOID
+  )
+{
+  UINT32  Features;
+
+  if (EFI_ERROR (QemuFwCfgSelectItem (FW_CFG_ID))) {
+    return FALSE;
+  }
+
+  IoReadFifo8 (FW_CFG_PORT_DATA, sizeof (Features), &Features);
+  if ((Features & FW_CFG_FEATURE_DMA) == 0) {
+    return FALSE;
+  }
+
+  return QemuFwCfgDmaSignatureMatches ();
+}
+
 /**
   Checks for Qemu fw_cfg device by reading "QEMU" using the signature selector
 
@@ -97,9 +258,86 @@ QemuFwCfgIsPresent (
   return EFI_SUCCESS;
 }
 
+/**
+  Reads the fw_cfg file directory once and saves it sorted by name in a
+  gQemuOpenFwCfgFileDirHobGuid HOB, for QemuFwCfgFindFile to search in PEI
+  and DXE. Must be called from PEI. This changes the selected item.
+
+  @retval EFI_SUCCESS - The HOB was built, or already exists
+  @retval EFI_OUT_OF_RESOURCES - The directory does not fit in a HOB
+**/
+EFI_STATUS
+EFIAPI
+QemuFwCfgBuildFileDirHob (
+  VOID
+  )
+{
+  QEMU_FW_CFG_FILE_DIR  *FileDir;
+  QEMU_FW_CFG_FILE      FirmwareConfigFile;
+  UINT32                FilesCount;
+  UINT32                Idx;
+  UINT32                Pos;
+
+  if (GetFirstGuidHob (&gQemuOpenFwCfgFileDirHobGuid) != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  QemuFwCfgSelectItem (FW_CFG_FILE_DIR);
+  QemuFwCfgReadBytes (sizeof (UINT32), &FilesCount);
+
+  FilesCount = SwapBytes32 (FilesCount);
+
+  //
+  // GUID HOB data is limited to a bit less than 64KB
+  //
+  if (FilesCount > (MAX_UINT16 - sizeof (EFI_HOB_GUID_TYPE) - sizeof (QEMU_FW_CFG_FILE_DIR)) / sizeof (QEMU_FW_CFG_FILE)) {
+    DEBUG ((DEBUG_WARN, "QemuFwCfg: %u files do not fit in the directory HOB\n", FilesCount));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  FileDir = BuildGuidHob (
+              &gQemuOpenFwCfgFileDirHobGuid,
+              sizeof (QEMU_FW_CFG_FILE_DIR) + FilesCount * sizeof (QEMU_FW_CFG_FILE)
+              );
+  if (FileDir == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Read the whole directory in one transfer, then convert and sort it in
+  // place. QEMU usually lists the files sorted already, so the insertion
+  // sort is a single pass.
+  //
+  FileDir->FileCount = FilesCount;
+  QemuFwCfgReadBytes (FilesCount * sizeof (QEMU_FW_CFG_FILE), FileDir->Files);
+
+  for (Idx = 0; Idx < FilesCount; Idx++) {
+    CopyMem (&FirmwareConfigFile, &FileDir->Files[Idx], sizeof (QEMU_FW_CFG_FILE));
+    FirmwareConfigFile.Select = SwapBytes16 (FirmwareConfigFile.Select);
+    FirmwareConfigFile.Size   = SwapBytes32 (FirmwareConfigFile.Size);
+
+    FirmwareConfigFile.Name[sizeof (FirmwareConfigFile.Name) - 1] = '\0';
+
+    for (Pos = Idx; Pos > 0; Pos--) {
+      if (AsciiStrCmp (FileDir->Files[Pos - 1].Name, FirmwareConfigFile.Name) <= 0) {
+        break;
+      }
+
+      CopyMem (&FileDir->Files[Pos], &FileDir->Files[Pos - 1], sizeof (QEMU_FW_CFG_FILE));
+    }
+
+    CopyMem (&FileDir->Files[Pos], &FirmwareConfigFile, sizeof (QEMU_FW_CFG_FILE));
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Finds a file in fw_cfg by its name
 
+  Uses the gQemuOpenFwCfgFileDirHobGuid HOB when it exists, otherwise reads
+  the file directory from the device.
+
   @param String Pointer to an ASCII string to match in the database
   @param FWConfigFile Buffer for the config file
 
@@ -113,9 +351,37 @@ QemuFwCfgFindFile (
   OUT QEMU_FW_CFG_FILE  *FWConfigFile
   )
 {
-  QEMU_FW_CFG_FILE  FirmwareConfigFile;
-  UINT32            FilesCount;
-  UINT32            Idx;
+  QEMU_FW_CFG_FILE      FirmwareConfigFile;
+  QEMU_FW_CFG_FILE_DIR  *FileDir;
+  EFI_HOB_GUID_TYPE     *GuidHob;
+  UINT32                FilesCount;
+  UINT32                Idx;
+  UINT32                Low;
+  UINT32                High;
+  INTN                  Compare;
+
+  GuidHob = GetFirstGuidHob (&gQemuOpenFwCfgFileDirHobGuid);
+  if (GuidHob != NULL) {
+    FileDir = GET_GUID_HOB_DATA (GuidHob);
+    Low     = 0;
+    High    = FileDir->FileCount;
+    while (Low < High) {
+      Idx     = Low + (High - Low) / 2;
+      Compare = AsciiStrCmp (FileDir->Files[Idx].Name, String);
+      if (Compare == 0) {
+        CopyMem (FWConfigFile, &FileDir->Files[Idx], sizeof (QEMU_FW_CFG_FILE));
+        return EFI_SUCCESS;
+      }
+
+      if (Compare < 0) {
+        Low = Idx + 1;
+      } else {
+        High = Idx;
+      }
+    }
+
+    return EFI_UNSUPPORTED;
+  }
 
   QemuFwCfgSelectItem (FW_CFG_FILE_DIR);
   QemuFwCfgReadBytes (sizeof (UINT32), &FilesCount);
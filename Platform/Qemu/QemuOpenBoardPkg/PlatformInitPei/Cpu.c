@@ -16,9 +16,21 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/HobLib.h>
+#include <Library/BaseLib.h>
+#include <Register/Intel/Cpuid.h>
+
+//
+// Highest initial APIC ID that can be addressed in xAPIC mode
+//
+#define MAX_XAPIC_ID  0xFE
 
 /**
-  Probe Qemu FW CFG device for current CPU count and report to MpInitLib.
+  Probe Qemu FW CFG device for current and maximum CPU count and report to
+  MpInitLib.
+
+  MpInitLib switches to x2APIC mode by itself when it finds an APIC ID above
+  MAX_XAPIC_ID. A virtual CPU without x2APIC support can not address that
+  many CPUs, and the boot stops there.
 
   @return EFI_SUCCESS      Detection was successful.
   @retval EFI_UNSUPPORTED  QEMU FW CFG device is not present.
@@ -29,8 +41,10 @@ MaxCpuInit (
   VOID
   )
 {
-  UINT16      BootCpuCount;
-  EFI_STATUS  Status;
+  UINT16                  BootCpuCount;
+  UINT16                  MaxCpuCount;
+  EFI_STATUS              Status;
+  CPUID_VERSION_INFO_ECX  VersionInfoEcx;
 
   Status = QemuFwCfgIsPresent ();
 
@@ -52,13 +66,43 @@ MaxCpuInit (
 
   QemuFwCfgReadBytes (sizeof (BootCpuCount), &BootCpuCount);
 
+  //
+  //  The maximum count includes the CPUs that can be hot-plugged, older QEMU
+  //  versions may not report it
+  //
+
+  MaxCpuCount = 0;
+  Status      = QemuFwCfgSelectItem (QemuFwCfgItemMaximumCpuCount);
+  if (!EFI_ERROR (Status)) {
+    QemuFwCfgReadBytes (sizeof (MaxCpuCount), &MaxCpuCount);
+  }
+
+  if (MaxCpuCount < BootCpuCount) {
+    MaxCpuCount = BootCpuCount;
+  }
+
+  DEBUG ((DEBUG_INFO, "QemuFwCfg: %u boot CPUs, %u max CPUs\n", BootCpuCount, MaxCpuCount));
+
+  if (MaxCpuCount > MAX_XAPIC_ID) {
+    AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &VersionInfoEcx.Uint32, NULL);
+    if (VersionInfoEcx.Bits.x2APIC == 0) {
+      //
+      //  Reporting fewer CPUs than QEMU runs would let the extra APs write past
+      //  the MpInitLib CPU arrays, so do not carry on
+      //
+      DEBUG ((DEBUG_ERROR, "%u CPUs need x2APIC, which the virtual CPU does not support\n", MaxCpuCount));
+      ASSERT (VersionInfoEcx.Bits.x2APIC != 0);
+      CpuDeadLoop ();
+    }
+  }
+
   //
   //  Report count to MpInitLib
   //
 
   PcdSet32S (PcdCpuBootLogicalProcessorNumber, BootCpuCount);
 
-  PcdSet32S (PcdCpuMaxLogicalProcessorNumber, 64);
+  PcdSet32S (PcdCpuMaxLogicalProcessorNumber, MaxCpuCount);
 
   return EFI_SUCCESS;
 }
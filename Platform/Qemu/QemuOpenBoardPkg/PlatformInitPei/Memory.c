@@ -124,6 +124,11 @@ InstallMemory (
     DEBUG ((DEBUG_INFO, "QEMU fw_cfg device is present\n"));
   }
 
+  //
+  // Cache the fw_cfg file directory for this and all later lookups
+  //
+  QemuFwCfgBuildFileDirHob ();
+
   Status = QemuFwCfgFindFile ("etc/e820", &FwCfgFile);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "etc/e820 was not found \n"));
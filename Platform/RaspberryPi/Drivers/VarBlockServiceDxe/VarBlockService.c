@@ -86,6 +86,30 @@ EFI_FW_VOL_BLOCK_DEVICE mFvbDeviceTemplate = {
 };
 
 
+STATIC
+VOID
+VarStoreMarkDirty (
+  IN UINTN Address,
+  IN UINTN Length
+  )
+{
+  UINTN Block;
+  UINTN LastBlock;
+
+  mFvInstance->Dirty = TRUE;
+  if (mFvInstance->DirtyBlocks == NULL || Length == 0) {
+    return;
+  }
+
+  Block = (Address - mFvInstance->FvBase) / mFvInstance->BlockSize;
+  LastBlock = (Address - mFvInstance->FvBase + Length - 1) /
+                mFvInstance->BlockSize;
+  for (; Block <= LastBlock; Block++) {
+    mFvInstance->DirtyBlocks[Block / 8] |= (UINT8)(1 << (Block % 8));
+  }
+}
+
+
 EFI_STATUS
 VarStoreWrite (
   IN     UINTN Address,
@@ -94,7 +118,7 @@ VarStoreWrite (
   )
 {
   CopyMem ((VOID*)Address, Buffer, *NumBytes);
-  mFvInstance->Dirty = TRUE;
+  VarStoreMarkDirty (Address, *NumBytes);
 
   return EFI_SUCCESS;
 }
@@ -107,7 +131,7 @@ VarStoreErase (
   )
 {
   SetMem ((VOID*)Address, LbaLength, 0xff);
-  mFvInstance->Dirty = TRUE;
+  VarStoreMarkDirty (Address, LbaLength);
 
   return EFI_SUCCESS;
 }
@@ -847,6 +871,12 @@ FvbInitialize (
    * Should I parse config.txt instead and find the real name?
    */
   mFvInstance->MappedFile = L"RPI_EFI.FD";
+  mFvInstance->BlockSize = PcdGet32 (PcdFirmwareBlockSize);
+  //
+  // Without the dirty block map, the whole store gets dumped.
+  //
+  mFvInstance->DirtyBlocks = AllocateRuntimeZeroPool (
+                               FV_DIRTY_BLOCKS_SIZE (mFvInstance));
 
   Status = ValidateFvHeader (mFvInstance->VolumeHeader);
   if (!EFI_ERROR (Status)) {
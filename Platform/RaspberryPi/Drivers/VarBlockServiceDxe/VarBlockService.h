@@ -33,8 +33,21 @@ typedef struct {
   EFI_DEVICE_PATH_PROTOCOL   *Device;
   CHAR16                     *MappedFile;
   BOOLEAN                    Dirty;
+  //
+  // One bit per block of BlockSize bytes written or erased since the
+  // last dump, so that only those blocks get written back to MappedFile.
+  //
+  UINTN                      BlockSize;
+  UINT8                      *DirtyBlocks;
+  UINT64                     DumpedBytes;
 } EFI_FW_VOL_INSTANCE;
 
+#define FV_DIRTY_BLOCK_COUNT(Instance) \
+          (((Instance)->FvLength + (Instance)->BlockSize - 1) / \
+            (Instance)->BlockSize)
+#define FV_DIRTY_BLOCKS_SIZE(Instance) \
+          ((FV_DIRTY_BLOCK_COUNT (Instance) + 7) / 8)
+
 extern EFI_FW_VOL_INSTANCE *mFvInstance;
 
 typedef struct {
@@ -8,6 +8,8 @@
  *
  **/
 
+#include <Library/BaseMemoryLib.h>
+
 #include "VarBlockService.h"
 
 //
@@ -106,6 +108,7 @@ FvbVirtualAddressChangeEvent (
 {
   EfiConvertPointer (0x0, (VOID**)&mFvInstance->FvBase);
   EfiConvertPointer (0x0, (VOID**)&mFvInstance->VolumeHeader);
+  EfiConvertPointer (0x1, (VOID**)&mFvInstance->DirtyBlocks);
   EfiConvertPointer (0x0, (VOID**)&mFvInstance);
 }
 
@@ -138,6 +141,12 @@ DoDump (
 {
   EFI_STATUS Status;
   EFI_FILE_PROTOCOL *File;
+  UINTN NumOfBlocks;
+  UINTN Block;
+  UINTN RunStart;
+  UINTN RunLength;
+  UINTN Writes;
+  UINTN Bytes;
 
   Status = FileOpen (Device,
              mFvInstance->MappedFile,
@@ -148,11 +157,50 @@ DoDump (
     return Status;
   }
 
-  Status = FileWrite (File,
-             mFvInstance->Offset,
-             mFvInstance->FvBase,
-             mFvInstance->FvLength);
+  if (mFvInstance->DirtyBlocks == NULL) {
+    Status = FileWrite (File,
+               mFvInstance->Offset,
+               mFvInstance->FvBase,
+               mFvInstance->FvLength);
+    Writes = 1;
+    Bytes = mFvInstance->FvLength;
+  } else {
+    //
+    // Write back each run of adjacent dirty blocks with a single write.
+    //
+    NumOfBlocks = FV_DIRTY_BLOCK_COUNT (mFvInstance);
+    Writes = 0;
+    Bytes = 0;
+    Block = 0;
+    while (Block < NumOfBlocks && !EFI_ERROR (Status)) {
+      if ((mFvInstance->DirtyBlocks[Block / 8] & (1 << (Block % 8))) == 0) {
+        Block++;
+        continue;
+      }
+
+      RunStart = Block;
+      while (Block < NumOfBlocks &&
+             (mFvInstance->DirtyBlocks[Block / 8] & (1 << (Block % 8))) != 0) {
+        Block++;
+      }
+      RunLength = MIN (Block * mFvInstance->BlockSize, mFvInstance->FvLength) -
+                    RunStart * mFvInstance->BlockSize;
+
+      Status = FileWrite (File,
+                 mFvInstance->Offset + RunStart * mFvInstance->BlockSize,
+                 mFvInstance->FvBase + RunStart * mFvInstance->BlockSize,
+                 RunLength);
+      Writes++;
+      Bytes += RunLength;
+    }
+  }
   FileClose (File);
+
+  if (!EFI_ERROR (Status)) {
+    mFvInstance->DumpedBytes += Bytes;
+    DEBUG ((DEBUG_INFO, "Dumped %lu bytes in %lu writes (%lu bytes since boot)\n",
+      (UINT64)Bytes, (UINT64)Writes, mFvInstance->DumpedBytes));
+  }
   return Status;
 }
 
@@ -197,6 +245,9 @@ DumpVars (
     ASSERT_RETURN_ERROR (PcdStatus);
   }
 
+  if (mFvInstance->DirtyBlocks != NULL) {
+    ZeroMem (mFvInstance->DirtyBlocks, FV_DIRTY_BLOCKS_SIZE (mFvInstance));
+  }
   mFvInstance->Dirty = FALSE;
 }
 
@@ -33,6 +33,24 @@ FlashLibConstructor (
   return EFI_SUCCESS;
 }
 
+/**
+  Allocate the memory backing the read cache of an NVRAM region.
+
+  This instance serves PEI and boot-time callers which read each range a
+  few times at most, so it does not cache reads.
+
+  @param[in]  Size                Number of bytes to allocate.
+
+  @retval NULL                    Reads are not cached.
+**/
+VOID *
+FlashLibAllocateCacheBuffer (
+  IN UINTN Size
+  )
+{
+  return NULL;
+}
+
 /**
   Provides an interface to access the Flash services via MM interface.
 
@@ -18,6 +18,12 @@
 BOOLEAN                       gFlashLibRuntime = FALSE;
 UINT8                         *gFlashLibPhysicalBuffer;
 UINT8                         *gFlashLibVirtualBuffer;
+FLASH_LIB_CACHE_REGION        gFlashLibCache[FLASH_LIB_CACHE_REGION_COUNT];
+
+STATIC BOOLEAN                mFlashLibCacheInitialized = FALSE;
+
+#define FLASH_LIB_CACHE_CHUNK_COUNT(Size) \
+          (((Size) + EFI_MM_MAX_TMP_BUF_SIZE - 1) / EFI_MM_MAX_TMP_BUF_SIZE)
 
 /**
   Convert Virtual Address to Physical Address at Runtime.
@@ -43,6 +49,243 @@ ConvertToPhysicalBuffer (
   return VirtualPtr;
 }
 
+/**
+  Read data from the Flash through the MM temp buffer.
+
+  @param[in]  ByteAddress        Start address of the region.
+  @param[out] Buffer             Pointer to the data buffer.
+  @param[in]  Length             Number of bytes to read.
+
+  @retval EFI_SUCCESS            Operation succeeded.
+  @retval Others                 An error has occurred.
+**/
+STATIC
+EFI_STATUS
+FlashMmRead (
+  IN  UINTN  ByteAddress,
+  OUT UINT8  *Buffer,
+  IN  UINTN  Length
+  )
+{
+  EFI_MM_COMMUNICATE_SPINOR_RESPONSE MmSpiNorRes;
+  EFI_STATUS                         Status;
+  UINT64                             MmData[5];
+  UINTN                              Remain, NumRead;
+  UINTN                              Count = 0;
+
+  Remain = Length;
+  while (Remain > 0) {
+    NumRead = (Remain > EFI_MM_MAX_TMP_BUF_SIZE) ? EFI_MM_MAX_TMP_BUF_SIZE : Remain;
+
+    MmData[0] = MM_SPINOR_FUNC_READ;
+    MmData[1] = ByteAddress + Count;
+    MmData[2] = NumRead;
+    MmData[3] = (UINT64)gFlashLibPhysicalBuffer;  // Read data into the temp buffer with specified virtual address
+
+    Status = FlashMmCommunicate (
+              MmData,
+              sizeof (MmData),
+              &MmSpiNorRes,
+              sizeof (MmSpiNorRes)
+              );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (MmSpiNorRes.Status != MM_SPINOR_RES_SUCCESS) {
+      DEBUG ((DEBUG_ERROR, "%a: Device error %llx\n", __FUNCTION__, MmSpiNorRes.Status));
+      return EFI_DEVICE_ERROR;
+    }
+
+    //
+    // Get data from the virtual address of the temp buffer.
+    //
+    CopyMem ((VOID *)(Buffer + Count), (VOID *)gFlashLibVirtualBuffer, NumRead);
+    Remain -= NumRead;
+    Count += NumRead;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Set up the read cache for the NVRAM regions.
+
+  The cache is only set up before ExitBootServices, and only by library
+  instances which provide memory for it. Failing to set it up is not an
+  error; reads then go to MM as before.
+**/
+STATIC
+VOID
+FlashLibInitializeCache (
+  VOID
+  )
+{
+  FLASH_LIB_CACHE_REGION *Region;
+  EFI_STATUS             Status;
+  UINTN                  Index;
+  UINTN                  Base;
+  UINT32                 Size;
+  UINT8                  *Data;
+
+  mFlashLibCacheInitialized = TRUE;
+
+  for (Index = 0; Index < FLASH_LIB_CACHE_REGION_COUNT; Index++) {
+    Base = 0;
+    Size = 0;
+    if (Index == 0) {
+      Status = FlashGetNvRamInfo (&Base, &Size);
+    } else {
+      Status = FlashGetNvRam2Info (&Base, &Size);
+    }
+    if (EFI_ERROR (Status) || Size == 0) {
+      continue;
+    }
+
+    Data = FlashLibAllocateCacheBuffer (
+             Size + (FLASH_LIB_CACHE_CHUNK_COUNT (Size) + 7) / 8
+             );
+    if (Data == NULL) {
+      continue;
+    }
+
+    Region = &gFlashLibCache[Index];
+    Region->Base = Base;
+    Region->Size = Size;
+    Region->Data = Data;
+    Region->ValidChunks = Data + Size;
+  }
+}
+
+/**
+  Find the cached NVRAM region which holds a range of the Flash.
+
+  @param[in] ByteAddress         Start address of the range.
+  @param[in] Length              Number of bytes in the range.
+
+  @retval Pointer to the region, or NULL if the range is not entirely cached.
+**/
+STATIC
+FLASH_LIB_CACHE_REGION *
+FlashLibFindCacheRegion (
+  IN UINTN  ByteAddress,
+  IN UINT32 Length
+  )
+{
+  FLASH_LIB_CACHE_REGION *Region;
+  UINTN                  Index;
+
+  for (Index = 0; Index < FLASH_LIB_CACHE_REGION_COUNT; Index++) {
+    Region = &gFlashLibCache[Index];
+    if (Region->Data != NULL
+        && ByteAddress >= Region->Base
+        && Length <= Region->Size
+        && ByteAddress - Region->Base <= Region->Size - Length) {
+      return Region;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop the cached data of a range of the Flash which is being changed.
+
+  @param[in] ByteAddress         Start address of the range.
+  @param[in] Length              Number of bytes in the range.
+**/
+STATIC
+VOID
+FlashLibInvalidateCache (
+  IN UINTN  ByteAddress,
+  IN UINT32 Length
+  )
+{
+  FLASH_LIB_CACHE_REGION *Region;
+  UINTN                  Index;
+  UINTN                  Start;
+  UINTN                  End;
+  UINTN                  Chunk;
+
+  for (Index = 0; Index < FLASH_LIB_CACHE_REGION_COUNT; Index++) {
+    Region = &gFlashLibCache[Index];
+    if (Region->Data == NULL
+        || ByteAddress >= Region->Base + Region->Size
+        || ByteAddress + Length <= Region->Base) {
+      continue;
+    }
+
+    Start = MAX (ByteAddress, Region->Base) - Region->Base;
+    End = MIN (ByteAddress + Length, Region->Base + Region->Size) - Region->Base;
+    for (Chunk = Start / EFI_MM_MAX_TMP_BUF_SIZE;
+         Chunk < FLASH_LIB_CACHE_CHUNK_COUNT (End);
+         Chunk++) {
+      Region->ValidChunks[Chunk / 8] &= (UINT8)~(1 << (Chunk % 8));
+    }
+  }
+}
+
+/**
+  Make sure that a range of a cached NVRAM region holds the Flash content.
+
+  Runs of adjacent chunks which are not cached yet are read with a single
+  pass through MM.
+
+  @param[in] Region              Pointer to the cached region.
+  @param[in] Offset              Offset of the range in the region.
+  @param[in] Length              Number of bytes in the range.
+
+  @retval EFI_SUCCESS            Operation succeeded.
+  @retval Others                 An error has occurred.
+**/
+STATIC
+EFI_STATUS
+FlashLibFillCache (
+  IN FLASH_LIB_CACHE_REGION *Region,
+  IN UINTN                  Offset,
+  IN UINT32                 Length
+  )
+{
+  EFI_STATUS Status;
+  UINTN      Chunk;
+  UINTN      LastChunk;
+  UINTN      RunStart;
+  UINTN      RunOffset;
+  UINTN      RunLength;
+
+  Chunk = Offset / EFI_MM_MAX_TMP_BUF_SIZE;
+  LastChunk = FLASH_LIB_CACHE_CHUNK_COUNT (Offset + Length);
+  while (Chunk < LastChunk) {
+    if ((Region->ValidChunks[Chunk / 8] & (1 << (Chunk % 8))) != 0) {
+      Chunk++;
+      continue;
+    }
+
+    RunStart = Chunk;
+    while (Chunk < LastChunk
+           && (Region->ValidChunks[Chunk / 8] & (1 << (Chunk % 8))) == 0) {
+      Chunk++;
+    }
+
+    RunOffset = RunStart * EFI_MM_MAX_TMP_BUF_SIZE;
+    RunLength = MIN (Chunk * EFI_MM_MAX_TMP_BUF_SIZE, Region->Size) - RunOffset;
+    Status = FlashMmRead (
+               Region->Base + RunOffset,
+               Region->Data + RunOffset,
+               RunLength
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    for (; RunStart < Chunk; RunStart++) {
+      Region->ValidChunks[RunStart / 8] |= (UINT8)(1 << (RunStart % 8));
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Get the information about the Flash region to store the FailSafe status.
 
@@ -225,6 +468,8 @@ FlashEraseCommand (
     return EFI_INVALID_PARAMETER;
   }
 
+  FlashLibInvalidateCache (ByteAddress, Length);
+
   MmData[0] = MM_SPINOR_FUNC_ERASE;
   MmData[1] = ByteAddress;
   MmData[2] = Length;
@@ -276,6 +521,8 @@ FlashWriteCommand (
     return EFI_INVALID_PARAMETER;
   }
 
+  FlashLibInvalidateCache (ByteAddress, Length);
+
   Remain = Length;
   while (Remain > 0) {
     NumWrite = (Remain > EFI_MM_MAX_TMP_BUF_SIZE) ? EFI_MM_MAX_TMP_BUF_SIZE : Remain;
@@ -326,47 +573,29 @@ FlashReadCommand (
   IN  UINT32 Length
   )
 {
-  EFI_MM_COMMUNICATE_SPINOR_RESPONSE MmSpiNorRes;
-  EFI_STATUS                         Status;
-  UINT64                             MmData[5];
-  UINTN                              Remain, NumRead;
-  UINTN                              Count = 0;
+  FLASH_LIB_CACHE_REGION *Region;
+  EFI_STATUS             Status;
 
   if (Buffer == NULL || Length == 0) {
     return EFI_INVALID_PARAMETER;
   }
 
-  Remain = Length;
-  while (Remain > 0) {
-    NumRead = (Remain > EFI_MM_MAX_TMP_BUF_SIZE) ? EFI_MM_MAX_TMP_BUF_SIZE : Remain;
-
-    MmData[0] = MM_SPINOR_FUNC_READ;
-    MmData[1] = ByteAddress + Count;
-    MmData[2] = NumRead;
-    MmData[3] = (UINT64)gFlashLibPhysicalBuffer;  // Read data into the temp buffer with specified virtual address
-
-    Status = FlashMmCommunicate (
-              MmData,
-              sizeof (MmData),
-              &MmSpiNorRes,
-              sizeof (MmSpiNorRes)
-              );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+  if (!mFlashLibCacheInitialized && !gFlashLibRuntime) {
+    FlashLibInitializeCache ();
+  }
 
-    if (MmSpiNorRes.Status != MM_SPINOR_RES_SUCCESS) {
-      DEBUG ((DEBUG_ERROR, "%a: Device error %llx\n", __FUNCTION__, MmSpiNorRes.Status));
-      return EFI_DEVICE_ERROR;
+  //
+  // Serve reads of the NVRAM regions from the cache, filling it from MM
+  // on a miss.
+  //
+  Region = FlashLibFindCacheRegion (ByteAddress, Length);
+  if (Region != NULL) {
+    Status = FlashLibFillCache (Region, ByteAddress - Region->Base, Length);
+    if (!EFI_ERROR (Status)) {
+      CopyMem (Buffer, Region->Data + (ByteAddress - Region->Base), Length);
+      return EFI_SUCCESS;
     }
-
-    //
-    // Get data from the virtual address of the temp buffer.
-    //
-    CopyMem ((VOID *)(Buffer + Count), (VOID *)gFlashLibVirtualBuffer, NumRead);
-    Remain -= NumRead;
-    Count += NumRead;
   }
 
-  return EFI_SUCCESS;
+  return FlashMmRead (ByteAddress, Buffer, Length);
 }
@@ -64,9 +64,27 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Number of NVRAM regions (NVRAM and NVRAM2) that can be cached.
+//
+#define FLASH_LIB_CACHE_REGION_COUNT      2
+
+//
+// A copy of an NVRAM region of the Flash. The region is filled in
+// EFI_MM_MAX_TMP_BUF_SIZE chunks on demand; ValidChunks holds one bit
+// per chunk and is cleared by the erase and write commands.
+//
+typedef struct {
+  UINTN  Base;
+  UINT32 Size;
+  UINT8  *Data;
+  UINT8  *ValidChunks;
+} FLASH_LIB_CACHE_REGION;
+
 extern BOOLEAN                        gFlashLibRuntime;
 extern UINT8                          *gFlashLibPhysicalBuffer;
 extern UINT8                          *gFlashLibVirtualBuffer;
+extern FLASH_LIB_CACHE_REGION         gFlashLibCache[FLASH_LIB_CACHE_REGION_COUNT];
 
 /**
   Provides an interface to access the Flash services via MM interface.
@@ -89,4 +107,17 @@ FlashMmCommunicate (
   IN  UINT32 ResponseDataSize
   );
 
+/**
+  Allocate the memory backing the read cache of an NVRAM region.
+
+  @param[in]  Size                Number of bytes to allocate.
+
+  @retval Pointer to the allocated buffer, or NULL if the library instance
+          does not cache reads.
+**/
+VOID *
+FlashLibAllocateCacheBuffer (
+  IN UINTN Size
+  );
+
 #endif /* FLASH_LIB_COMMON_H_ */
@@ -33,9 +33,16 @@ FlashLibAddressChangeEvent (
   IN VOID      *Context
   )
 {
+  UINTN Index;
+
   gRT->ConvertPointer (0x0, (VOID **)&gFlashLibVirtualBuffer);
   gRT->ConvertPointer (0x0, (VOID **)&mMmCommunicationProtocol);
 
+  for (Index = 0; Index < FLASH_LIB_CACHE_REGION_COUNT; Index++) {
+    gRT->ConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&gFlashLibCache[Index].Data);
+    gRT->ConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&gFlashLibCache[Index].ValidChunks);
+  }
+
   gFlashLibRuntime = TRUE;
 }
 
@@ -81,6 +88,24 @@ FlashLibConstructor (
   return Status;
 }
 
+/**
+  Allocate the memory backing the read cache of an NVRAM region.
+
+  The cache is kept across ExitBootServices so that the variable services
+  at runtime do not go to MM for every read of the variable store.
+
+  @param[in]  Size                Number of bytes to allocate.
+
+  @retval Pointer to the allocated buffer, or NULL on allocation failure.
+**/
+VOID *
+FlashLibAllocateCacheBuffer (
+  IN UINTN Size
+  )
+{
+  return AllocateRuntimeZeroPool (Size);
+}
+
 /**
   Provides an interface to access the Flash services via MM interface.
 
@@ -114,6 +114,7 @@
 #define GENET_DMA_DESC_COUNT                    256
 #define GENET_DMA_DESC_SIZE                     12
 #define GENET_DMA_DEFAULT_QUEUE                 16
+#define GENET_TX_MAX_FRAGMENTS                  4
 
 #define GENET_DMA_RING_SIZE                     0x40
 #define GENET_DMA_RINGS_SIZE                    (GENET_DMA_RING_SIZE * (GENET_DMA_DEFAULT_QUEUE + 1))
@@ -218,8 +219,11 @@ typedef struct {
 
   UINT8                               *TxBuffer[GENET_DMA_DESC_COUNT];
   VOID                                *TxBufferMap[GENET_DMA_DESC_COUNT];
-  UINT8                               TxQueued;
+  UINT16                              TxQueued;
   UINT16                              TxNext;
+  VOID                                *TxRecycled[GENET_DMA_DESC_COUNT];
+  UINT16                              TxRecycledHead;
+  UINT16                              TxRecycledCount;
   UINT16                              TxConsIndex;
   UINT16                              TxProdIndex;
 
@@ -334,11 +338,17 @@ GenetDmaFree (
   );
 
 VOID
-GenetDmaTriggerTx (
+GenetDmaQueueTx (
   IN GENET_PRIVATE_DATA   *Genet,
   IN UINT8                DescIndex,
   IN EFI_PHYSICAL_ADDRESS PhysAddr,
-  IN UINTN                NumberOfBytes
+  IN UINTN                NumberOfBytes,
+  IN UINT32               DescFlags
+  );
+
+VOID
+GenetDmaTriggerTx (
+  IN GENET_PRIVATE_DATA   *Genet
   );
 
 EFI_STATUS
@@ -545,6 +545,8 @@ GenetDmaInitRings (
 
   Genet->TxQueued = 0;
   Genet->TxNext = 0;
+  Genet->TxRecycledHead = 0;
+  Genet->TxRecycledCount = 0;
   Genet->TxConsIndex = 0;
   Genet->TxProdIndex = 0;
 
@@ -707,26 +709,30 @@ GenetDmaFree (
 }
 
 /**
-  Queue TX transmission, given a buffer to transmit and a TX descriptor index.
+  Fill in a TX descriptor for one fragment of a frame. The descriptor is not
+  handed over to the hardware until GenetDmaTriggerTx() is called.
 
   @param  Genet[in]          Pointer to GENET_PRIVATE_DATA.
   @param  DescIndex[in]      TX descriptor index.
-  @param  PhysAddr[in]       Buffer to transmit.
-  @param  NumberOfBytes[in]  Buffer length.
+  @param  PhysAddr[in]       Fragment to transmit.
+  @param  NumberOfBytes[in]  Fragment length.
+  @param  DescFlags[in]      GENET_TX_DESC_STATUS_SOP and/or
+                             GENET_TX_DESC_STATUS_EOP for the first and last
+                             fragment of the frame.
 
 **/
 VOID
-GenetDmaTriggerTx (
+GenetDmaQueueTx (
   IN GENET_PRIVATE_DATA * Genet,
   IN UINT8                DescIndex,
   IN EFI_PHYSICAL_ADDRESS PhysAddr,
-  IN UINTN                NumberOfBytes
+  IN UINTN                NumberOfBytes,
+  IN UINT32               DescFlags
   )
 {
   UINT32    DescStatus;
 
-  DescStatus = GENET_TX_DESC_STATUS_SOP |
-               GENET_TX_DESC_STATUS_EOP |
+  DescStatus = DescFlags |
                GENET_TX_DESC_STATUS_CRC |
                GENET_TX_DESC_STATUS_QTAG |
                SHIFTIN (NumberOfBytes, GENET_TX_DESC_STATUS_BUFLEN);
@@ -736,7 +742,20 @@ GenetDmaTriggerTx (
   GenetMmioWrite (Genet, GENET_TX_DESC_ADDRESS_HI (DescIndex),
     (PhysAddr >> 32) & 0xFFFFFFFF);
   GenetMmioWrite (Genet, GENET_TX_DESC_STATUS (DescIndex), DescStatus);
+}
+
+/**
+  Start TX transmission of all descriptors queued so far, by publishing the
+  producer index to the hardware.
 
+  @param  Genet[in]          Pointer to GENET_PRIVATE_DATA.
+
+**/
+VOID
+GenetDmaTriggerTx (
+  IN GENET_PRIVATE_DATA * Genet
+  )
+{
   GenetMmioWrite (Genet, GENET_TX_DMA_PROD_INDEX (GENET_DMA_DEFAULT_QUEUE),
     Genet->TxProdIndex);
 }
@@ -744,6 +763,10 @@ GenetDmaTriggerTx (
 /**
   Simulate a "TX interrupt", return the next (completed) TX buffer to recycle.
 
+  All descriptors completed by the hardware since the last call are reaped
+  in one go. The buffers of completed frames are kept on a recycle queue and
+  handed back one per call.
+
   @param  Genet[in]   Pointer to GENET_PRIVATE_DATA.
   @param  TxBuf[out]  Location to store pointer to next TX buffer to recycle.
 
@@ -755,14 +778,27 @@ GenetTxIntr (
   )
 {
   UINT32 Total;
+  UINT16 Tail;
 
   Total = GenetTxPending (Genet);
-  if (Genet->TxQueued > 0 && Total > 0) {
+  while (Genet->TxQueued > 0 && Total > 0) {
     DmaUnmap (Genet->TxBufferMap[Genet->TxNext]);
-    *TxBuf = Genet->TxBuffer[Genet->TxNext];
+    if (Genet->TxBuffer[Genet->TxNext] != NULL) {
+      Tail = (Genet->TxRecycledHead + Genet->TxRecycledCount) % GENET_DMA_DESC_COUNT;
+      Genet->TxRecycled[Tail] = Genet->TxBuffer[Genet->TxNext];
+      Genet->TxRecycledCount++;
+      Genet->TxBuffer[Genet->TxNext] = NULL;
+    }
     Genet->TxQueued--;
     Genet->TxNext = (Genet->TxNext + 1) % GENET_DMA_DESC_COUNT;
     Genet->TxConsIndex = (Genet->TxConsIndex + 1) & 0xFFFF;
+    Total--;
+  }
+
+  if (Genet->TxRecycledCount > 0) {
+    *TxBuf = Genet->TxRecycled[Genet->TxRecycledHead];
+    Genet->TxRecycledHead = (Genet->TxRecycledHead + 1) % GENET_DMA_DESC_COUNT;
+    Genet->TxRecycledCount--;
   } else {
     *TxBuf = NULL;
   }
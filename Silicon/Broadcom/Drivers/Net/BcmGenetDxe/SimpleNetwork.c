@@ -514,7 +514,7 @@ GenetSimpleNetworkGetStatus (
     if (GenetRxPending (Genet) > 0) {
       *InterruptStatus |= EFI_SIMPLE_NETWORK_RECEIVE_INTERRUPT;
     }
-    if (GenetTxPending (Genet) > 0) {
+    if (GenetTxPending (Genet) > 0 || Genet->TxRecycledCount > 0) {
       *InterruptStatus |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
     }
   }
@@ -574,6 +574,9 @@ GenetSimpleNetworkTransmit (
   UINT8               Desc;
   PHYSICAL_ADDRESS    DmaDeviceAddress;
   UINTN               DmaNumberOfBytes;
+  UINTN               Offset;
+  UINTN               Fragments;
+  UINT32              DescFlags;
   INTN                Retries;
 
   if (This == NULL || Buffer == NULL) {
@@ -642,7 +645,12 @@ GenetSimpleNetworkTransmit (
     return EFI_ACCESS_DENIED;
   }
 
-  if (Genet->TxQueued == GENET_DMA_DESC_COUNT - 1) {
+  //
+  // Reserve room for a maximally fragmented frame, counting the completed
+  // buffers not yet handed back to the caller through GetStatus.
+  //
+  if (Genet->TxQueued + Genet->TxRecycledCount + GENET_TX_MAX_FRAGMENTS >
+      GENET_DMA_DESC_COUNT - 1) {
     EfiReleaseLock (&Genet->Lock);
 
     DEBUG ((DEBUG_ERROR, "%a: Queue full\n", __FUNCTION__));
@@ -656,29 +664,72 @@ GenetSimpleNetworkTransmit (
     Frame[13] = *Protocol & 0xFF;
   }
 
-  Desc = Genet->TxProdIndex % GENET_DMA_DESC_COUNT;
+  //
+  // DmaMap () may map less than requested, e.g. when bounce buffering is
+  // involved, so the frame is queued as one descriptor per mapped fragment.
+  //
+  Offset = 0;
+  Fragments = 0;
+  while (Offset < BufferSize) {
+    Desc = (Genet->TxProdIndex + Fragments) % GENET_DMA_DESC_COUNT;
+    if (Fragments == GENET_TX_MAX_FRAGMENTS) {
+      DEBUG ((DEBUG_ERROR, "%a: Too many fragments\n", __FUNCTION__));
+      Status = EFI_DEVICE_ERROR;
+      goto UnmapFragments;
+    }
 
-  Genet->TxBuffer[Desc] = Frame;
+    DmaNumberOfBytes = BufferSize - Offset;
+    Status = DmaMap (MapOperationBusMasterRead,
+                     (VOID *)(UINTN)(Frame + Offset),
+                     &DmaNumberOfBytes,
+                     &DmaDeviceAddress,
+                     &Genet->TxBufferMap[Desc]);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: DmaMap failed: %r\n", __FUNCTION__, Status));
+      goto UnmapFragments;
+    }
 
-  DmaNumberOfBytes = BufferSize;
-  Status = DmaMap (MapOperationBusMasterRead,
-                   (VOID *)(UINTN)Frame,
-                   &DmaNumberOfBytes,
-                   &DmaDeviceAddress,
-                   &Genet->TxBufferMap[Desc]);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: DmaMap failed: %r\n", __FUNCTION__, Status));
-    EfiReleaseLock (&Genet->Lock);
-    return Status;
+    DescFlags = 0;
+    if (Offset == 0) {
+      DescFlags |= GENET_TX_DESC_STATUS_SOP;
+    }
+    Offset += DmaNumberOfBytes;
+    if (Offset == BufferSize) {
+      DescFlags |= GENET_TX_DESC_STATUS_EOP;
+    }
+
+    //
+    // Only the last descriptor of a frame carries the buffer to recycle.
+    //
+    Genet->TxBuffer[Desc] = (Offset == BufferSize) ? Frame : NULL;
+    GenetDmaQueueTx (Genet, Desc, DmaDeviceAddress, DmaNumberOfBytes, DescFlags);
+    Fragments++;
   }
 
-  Genet->TxProdIndex = (Genet->TxProdIndex + 1) & 0xFFFF;
-  GenetDmaTriggerTx (Genet, Desc, DmaDeviceAddress, DmaNumberOfBytes);
-  Genet->TxQueued++;
+  Genet->TxProdIndex = (Genet->TxProdIndex + Fragments) & 0xFFFF;
+  Genet->TxQueued += Fragments;
+
+  //
+  // Publish all fragments of the frame with a single producer index write.
+  // The frame must reach the hardware before Transmit returns, callers may
+  // not poll again until a timer expires.
+  //
+  GenetDmaTriggerTx (Genet);
 
   EfiReleaseLock (&Genet->Lock);
 
   return EFI_SUCCESS;
+
+UnmapFragments:
+  while (Fragments-- > 0) {
+    Desc = (Genet->TxProdIndex + Fragments) % GENET_DMA_DESC_COUNT;
+    DmaUnmap (Genet->TxBufferMap[Desc]);
+    Genet->TxBuffer[Desc] = NULL;
+  }
+
+  EfiReleaseLock (&Genet->Lock);
+
+  return Status;
 }
 
 /**
@@ -43,6 +43,61 @@ GpioConfigurePads (
   IN GPIO_INIT_CONFIG          *GpioInitTableAddress
   );
 
+#define GPIO_PAD_CONFIG_IMAGE_SIGNATURE  SIGNATURE_32 ('G', 'P', 'C', 'I')
+#define GPIO_PAD_CONFIG_IMAGE_REVISION   1
+
+///
+/// Header of a GPIO pad configuration image built by GpioBuildPadConfigImage.
+/// The records following the header are private to the GPIO library.
+///
+typedef struct {
+  UINT32             Signature;          ///< GPIO_PAD_CONFIG_IMAGE_SIGNATURE
+  UINT16             Revision;           ///< GPIO_PAD_CONFIG_IMAGE_REVISION
+  UINT16             GroupCount;         ///< Number of group records in the image
+  UINT32             PadCount;           ///< Number of pad records in the image
+  UINT32             Size;               ///< Size of the image, including this header
+} GPIO_PAD_CONFIG_IMAGE_HEADER;
+
+/**
+  This procedure will translate a GPIO initialization table into a pad configuration
+  image. The image holds the PADCFG register values and the per group register masks
+  which GpioConfigurePads would program for the same table, so that it can later be
+  applied with GpioConfigurePadsFromImage without translating every pad again.
+  The image does not contain pointers and can be stored, e.g. in a HOB or in flash.
+
+  @param[in]      NumberOfItems         Number of GPIO pads in the table
+  @param[in]      GpioInitTableAddress  GPIO initialization table
+  @param[out]     Image                 Buffer receiving the image, may be NULL if *ImageSize is 0
+  @param[in, out] ImageSize             On input, size of the Image buffer in bytes.
+                                        On output, size of the image in bytes.
+
+  @retval EFI_SUCCESS                   The image was built
+  @retval EFI_BUFFER_TOO_SMALL          Image buffer is too small, *ImageSize holds the required size
+  @retval EFI_INVALID_PARAMETER         Invalid group or pad number
+**/
+EFI_STATUS
+GpioBuildPadConfigImage (
+  IN     UINT32                NumberOfItems,
+  IN     GPIO_INIT_CONFIG      *GpioInitTableAddress,
+  OUT    VOID                  *Image,
+  IN OUT UINT32                *ImageSize
+  );
+
+/**
+  This procedure will program GPIO pads from a pad configuration image built by
+  GpioBuildPadConfigImage. It performs the same register writes as GpioConfigurePads
+  for the table the image was built from, without translating the pad configuration.
+
+  @param[in] Image                      Pad configuration image
+
+  @retval EFI_SUCCESS                   The function completed successfully
+  @retval EFI_INVALID_PARAMETER         Image is not a valid pad configuration image
+**/
+EFI_STATUS
+GpioConfigurePadsFromImage (
+  IN CONST VOID                *Image
+  );
+
 //
 // Functions for setting/getting multiple GpioPad settings
 //
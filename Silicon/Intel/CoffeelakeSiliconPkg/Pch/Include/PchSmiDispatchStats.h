@@ -0,0 +1,38 @@
+/** @file
+  This file contains definitions of the PCH SMI dispatcher statistics that
+  are returned through SMM communication.
+
+  Copyright (c) 2019 Intel Corporation. All rights reserved. <BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#ifndef _PCH_SMI_DISPATCH_STATS_H_
+#define _PCH_SMI_DISPATCH_STATS_H_
+
+//
+// GUID of the SMM communication handler. The communicate buffer data must be
+// large enough for a PCH_SMI_DISPATCH_STATS, which the handler fills in.
+//
+extern EFI_GUID gPchSmiDispatchStatsGuid;
+
+//
+// SMI sources are identified by their top level bit in the PMC SMI_STS register.
+// Sources without a top level SMI_STS bit are accounted in the last entry.
+//
+#define PCH_SMI_DISPATCH_SOURCE_OTHER  32
+#define PCH_SMI_DISPATCH_SOURCE_MAX    33
+
+typedef struct {
+  UINT64    DispatchCount;        ///< Number of times the source was found active and dispatched
+  UINT64    Cycles;               ///< Time stamp counter ticks spent finding, dispatching and clearing the source
+} PCH_SMI_DISPATCH_SOURCE_STATS;
+
+typedef struct {
+  UINT64                          SmiCount;         ///< Number of SMIs seen by the PCH SMI dispatcher
+  UINT64                          UnclaimedCount;   ///< Number of SMIs where no registered source was active
+  UINT32                          IndexedRecords;   ///< Records in the dispatch index, 0 until SmmReadyToLock
+  UINT32                          Reserved;
+  PCH_SMI_DISPATCH_SOURCE_STATS   Source[PCH_SMI_DISPATCH_SOURCE_MAX];
+} PCH_SMI_DISPATCH_STATS;
+
+#endif
@@ -47,6 +47,7 @@
 #include <Protocol/IoTrapExDispatch.h>
 #include <Library/PmcLib.h>
 #include "IoTrap.h"
+#include <PchSmiDispatchStats.h>
 
 #define EFI_BAD_POINTER          0xAFAFAFAFAFAFAFAFULL
 
@@ -592,6 +593,22 @@ typedef struct {
 } PRIVATE_DATA;
 
 extern PRIVATE_DATA           mPrivateData;
+
+///
+/// Dispatch index over the callback database. Records are grouped by the top
+/// level SMI_STS bit of their source, in registration order within a group,
+/// so the dispatcher only walks the groups whose status bit is pending.
+/// Built at SmmReadyToLock, after which the database no longer changes.
+///
+typedef struct {
+  UINT32                      StsMask;
+  UINT32                      RecordCount;
+  UINT32                      Start[PCH_SMI_DISPATCH_SOURCE_MAX + 1];
+  DATABASE_RECORD             **Records;
+} PCH_SMM_DISPATCH_INDEX;
+
+extern PCH_SMM_DISPATCH_INDEX mDispatchIndex;
+extern PCH_SMI_DISPATCH_STATS mDispatchStats;
 extern UINT16                 mAcpiBaseAddr;
 extern UINT16                 mTcoBaseAddr;
 
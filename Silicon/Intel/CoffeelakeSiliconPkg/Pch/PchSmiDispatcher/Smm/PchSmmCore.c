@@ -11,6 +11,7 @@
 #include "PchSmmHelpers.h"
 #include "PchSmmEspi.h"
 #include <Library/SmiHandlerProfileLib.h>
+#include <Library/SmmMemLib.h>
 #include <Register/PchRegsGpio.h>
 #include <Register/PchRegsPmc.h>
 #include <Register/PchRegsLpc.h>
@@ -24,6 +25,8 @@
 GLOBAL_REMOVE_IF_UNREFERENCED UINT16                mAcpiBaseAddr;
 GLOBAL_REMOVE_IF_UNREFERENCED UINT16                mTcoBaseAddr;
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN               mReadyToLock;
+GLOBAL_REMOVE_IF_UNREFERENCED PCH_SMM_DISPATCH_INDEX mDispatchIndex;
+GLOBAL_REMOVE_IF_UNREFERENCED PCH_SMI_DISPATCH_STATS mDispatchStats;
 
 GLOBAL_REMOVE_IF_UNREFERENCED PRIVATE_DATA          mPrivateData = {
   {
@@ -146,6 +149,133 @@ PchSmmCoreDispatcher (
 //
 // FUNCTIONS
 //
+/**
+  Get the dispatch index bucket of an SMI source, which is its top level
+  SMI_STS bit. This mirrors the early out in SourceIsActive(), so a source
+  in bucket N can only be active while SMI_STS bit N is set.
+
+  @param[in] SrcDesc              Pointer to the PCH SMI source description
+
+  @retval                         SMI_STS bit of the source, or
+                                  PCH_SMI_DISPATCH_SOURCE_OTHER if it has none
+**/
+STATIC
+UINTN
+GetSmiStsSourceIndex (
+  IN CONST PCH_SMM_SOURCE_DESC    *SrcDesc
+  )
+{
+  if (!IS_BIT_DESC_NULL (SrcDesc->PmcSmiSts) &&
+      (SrcDesc->PmcSmiSts.Reg.Type == ACPI_ADDR_TYPE) &&
+      (SrcDesc->PmcSmiSts.Reg.Data.acpi == R_ACPI_IO_SMI_STS) &&
+      (SrcDesc->PmcSmiSts.Bit < PCH_SMI_DISPATCH_SOURCE_OTHER)) {
+    return SrcDesc->PmcSmiSts.Bit;
+  }
+  return PCH_SMI_DISPATCH_SOURCE_OTHER;
+}
+
+/**
+  Build the dispatch index from the callback database.
+  Must only be called once registration is locked, since the index holds
+  pointers to the records and is not updated on register or unregister.
+**/
+STATIC
+VOID
+PchSmmBuildDispatchIndex (
+  VOID
+  )
+{
+  EFI_STATUS                   Status;
+  LIST_ENTRY                   *LinkInDb;
+  DATABASE_RECORD              *RecordInDb;
+  UINT32                       Fill[PCH_SMI_DISPATCH_SOURCE_MAX];
+  UINTN                        Bucket;
+  UINT32                       RecordCount;
+
+  ZeroMem (&mDispatchIndex, sizeof (mDispatchIndex));
+  ZeroMem (Fill, sizeof (Fill));
+
+  //
+  // Count the records of each bucket
+  //
+  RecordCount = 0;
+  LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+  while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+    Fill[GetSmiStsSourceIndex (&RecordInDb->SrcDesc)]++;
+    RecordCount++;
+    LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, &RecordInDb->Link);
+  }
+  if (RecordCount == 0) {
+    return;
+  }
+
+  Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (DATABASE_RECORD *), (VOID **) &mDispatchIndex.Records);
+  if (EFI_ERROR (Status)) {
+    //
+    // Keep dispatching from the linked list
+    //
+    mDispatchIndex.Records = NULL;
+    return;
+  }
+
+  for (Bucket = 0; Bucket < PCH_SMI_DISPATCH_SOURCE_MAX; Bucket++) {
+    mDispatchIndex.Start[Bucket + 1] = mDispatchIndex.Start[Bucket] + Fill[Bucket];
+    if ((Bucket < PCH_SMI_DISPATCH_SOURCE_OTHER) && (Fill[Bucket] != 0)) {
+      mDispatchIndex.StsMask |= (1u << Bucket);
+    }
+    Fill[Bucket] = mDispatchIndex.Start[Bucket];
+  }
+
+  //
+  // Place the records, keeping the registration order within each bucket
+  //
+  LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+  while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+    mDispatchIndex.Records[Fill[GetSmiStsSourceIndex (&RecordInDb->SrcDesc)]++] = RecordInDb;
+    LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, &RecordInDb->Link);
+  }
+  mDispatchIndex.RecordCount   = RecordCount;
+  mDispatchStats.IndexedRecords = RecordCount;
+}
+
+/**
+  SMM communication handler returning the PCH SMI dispatcher statistics.
+
+  @param[in]     DispatchHandle   The unique handle assigned to this handler by SmiHandlerRegister().
+  @param[in]     Context          Points to an optional handler context which was specified when the
+                                  handler was registered.
+  @param[in,out] CommBuffer       A pointer to a PCH_SMI_DISPATCH_STATS to fill in.
+  @param[in,out] CommBufferSize   The size of the CommBuffer.
+
+  @retval EFI_SUCCESS             The statistics are returned, or the request is ignored.
+**/
+EFI_STATUS
+EFIAPI
+PchSmiDispatchStatsHandler (
+  IN     EFI_HANDLE               DispatchHandle,
+  IN     CONST VOID               *Context         OPTIONAL,
+  IN OUT VOID                     *CommBuffer      OPTIONAL,
+  IN OUT UINTN                    *CommBufferSize  OPTIONAL
+  )
+{
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  if ((*CommBufferSize < sizeof (PCH_SMI_DISPATCH_STATS)) ||
+      !SmmIsBufferOutsideSmmValid ((EFI_PHYSICAL_ADDRESS) (UINTN) CommBuffer, sizeof (PCH_SMI_DISPATCH_STATS))) {
+    DEBUG ((DEBUG_ERROR, "PchSmiDispatchStatsHandler: invalid communication buffer\n"));
+    return EFI_SUCCESS;
+  }
+
+  CopyMem (CommBuffer, &mDispatchStats, sizeof (PCH_SMI_DISPATCH_STATS));
+  *CommBufferSize = sizeof (PCH_SMI_DISPATCH_STATS);
+
+  return EFI_SUCCESS;
+}
+
 /**
   SMM ready to lock notification event handler.
 
@@ -165,6 +295,7 @@ SmmReadyToLockCallback (
   )
 {
   mReadyToLock = TRUE;
+  PchSmmBuildDispatchIndex ();
 
   return EFI_SUCCESS;
 }
@@ -219,6 +350,7 @@ InitializePchSmmDispatcher (
 {
   EFI_STATUS           Status;
   VOID                 *SmmReadyToLockRegistration;
+  EFI_HANDLE           StatsHandle;
 
   //
   // Access ACPI Base Addresses Register
@@ -240,6 +372,8 @@ InitializePchSmmDispatcher (
   //
   Status = gSmst->SmiHandlerRegister (PchSmmCoreDispatcher, NULL, &mPrivateData.SmiHandle);
   ASSERT_EFI_ERROR (Status);
+  Status = gSmst->SmiHandlerRegister (PchSmiDispatchStatsHandler, &gPchSmiDispatchStatsGuid, &StatsHandle);
+  ASSERT_EFI_ERROR (Status);
   //
   // Initialize Callback DataBase
   //
@@ -648,6 +782,98 @@ ClearPendingSmiStatus (
   }
 }
 
+/**
+  Dispatch a child of the callback database if it registered for the active source.
+
+  @param[in]      RecordToExhaust       The record to dispatch.
+  @param[in]      ActiveSource          Source description of the active SMI source.
+  @param[in, out] SxChildWasDispatched  Set to TRUE when a child of the Sx dispatch protocol was dispatched.
+**/
+STATIC
+VOID
+PchSmmDispatchRecord (
+  IN     DATABASE_RECORD        *RecordToExhaust,
+  IN     PCH_SMM_SOURCE_DESC    *ActiveSource,
+  IN OUT BOOLEAN                *SxChildWasDispatched
+  )
+{
+  BOOLEAN             ContextsMatch;
+  PCH_SMM_CONTEXT     Context;
+  VOID                *CommBuffer;
+  UINTN               CommBufferSize;
+
+  if (!CompareSources (&RecordToExhaust->SrcDesc, ActiveSource)) {
+    return;
+  }
+
+  //
+  // These source descriptions are equal, so this callback should be
+  // dispatched.
+  //
+  if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
+    //
+    // This child requires that we get a calling context from
+    // hardware and compare that context to the one supplied
+    // by the child.
+    //
+    ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
+
+    //
+    // Make sure contexts match before dispatching event to child
+    //
+    RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
+    ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
+
+  } else {
+    //
+    // This child doesn't require any more calling context beyond what
+    // it supplied in registration.  Simply pass back what it gave us.
+    //
+    Context       = RecordToExhaust->ChildContext;
+    ContextsMatch = TRUE;
+  }
+
+  if (!ContextsMatch) {
+    return;
+  }
+
+  if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
+    //
+    // For PCH SMI dispatch protocols
+    //
+    PchSmiTypeCallbackDispatcher (RecordToExhaust);
+  } else {
+    //
+    // For EFI standard SMI dispatch protocols
+    //
+    if (RecordToExhaust->Callback != NULL) {
+      if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
+        //
+        // This callback function needs CommBuffer and CommBufferSize.
+        // Get those from child and then pass to callback function.
+        //
+        RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
+      } else {
+        //
+        // Child doesn't support the CommBuffer and CommBufferSize.
+        // Just pass NULL value to callback function.
+        //
+        CommBuffer     = NULL;
+        CommBufferSize = 0;
+      }
+
+      PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+      RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
+      PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
+      if (RecordToExhaust->ProtocolType == SxType) {
+        *SxChildWasDispatched = TRUE;
+      }
+    } else {
+      ASSERT (FALSE);
+    }
+  }
+}
+
 /**
   The callback function to handle subsequent SMIs.  This callback will be called by SmmCoreDispatcher.
 
@@ -672,18 +898,18 @@ PchSmmCoreDispatcher (
   //
   UINTN               EscapeCount;
 
-  BOOLEAN             ContextsMatch;
   BOOLEAN             EosSet;
   BOOLEAN             SxChildWasDispatched;
+  BOOLEAN             Claimed;
 
   DATABASE_RECORD     *RecordInDb;
   LIST_ENTRY          *LinkInDb;
   DATABASE_RECORD     *RecordToExhaust;
   LIST_ENTRY          *LinkToExhaust;
 
-  PCH_SMM_CONTEXT     Context;
-  VOID                *CommBuffer;
-  UINTN               CommBufferSize;
+  UINTN               Bucket;
+  UINT32              Index;
+  UINT64              StartTsc;
 
   EFI_STATUS          Status;
   BOOLEAN             SciEn;
@@ -700,8 +926,8 @@ PchSmmCoreDispatcher (
   NullInitSourceDesc (&ActiveSource);
 
   EscapeCount           = 3;
-  ContextsMatch         = FALSE;
   EosSet                = FALSE;
+  Claimed               = FALSE;
   SxChildWasDispatched  = FALSE;
   Status                = EFI_SUCCESS;
 
@@ -714,14 +940,14 @@ PchSmmCoreDispatcher (
   Port76Save = IoRead8 (R_RTC_IO_EXT_INDEX_ALT);
   Port74Save = IoRead8 (R_RTC_IO_INDEX_ALT);
 
+  mDispatchStats.SmiCount++;
   if (!IsListEmpty (&mPrivateData.CallbackDataBase)) {
     //
     // We have children registered w/ us -- continue
     //
     while ((!EosSet) && (EscapeCount > 0)) {
       EscapeCount--;
-
-      LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+      StartTsc = AsmReadTsc ();
 
       //
       // Cache SciEn, SmiEnValue and SmiStsValue to determine if source is active
@@ -730,29 +956,58 @@ PchSmmCoreDispatcher (
       SmiEnValue  = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_EN));
       SmiStsValue = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_STS));
 
-      while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
-        RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
-
+      RecordInDb = NULL;
+      if (mDispatchIndex.Records != NULL) {
         //
-        // look for the first active source
+        // Registration is locked, so only look at the buckets of the pending
+        // SMI_STS bits and at the sources without a top level status bit.
         //
-        if (!SourceIsActive (&RecordInDb->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+        for (Bucket = 0; Bucket < PCH_SMI_DISPATCH_SOURCE_MAX; Bucket++) {
+          if ((Bucket < PCH_SMI_DISPATCH_SOURCE_OTHER) &&
+              ((SmiStsValue & mDispatchIndex.StsMask & (1u << Bucket)) == 0)) {
+            continue;
+          }
+          for (Index = mDispatchIndex.Start[Bucket]; Index < mDispatchIndex.Start[Bucket + 1]; Index++) {
+            if (SourceIsActive (&mDispatchIndex.Records[Index]->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+              RecordInDb = mDispatchIndex.Records[Index];
+              break;
+            }
+          }
+          if (RecordInDb != NULL) {
+            break;
+          }
+        }
+
+        if (RecordInDb != NULL) {
           //
-          // Didn't find the source yet, keep looking
+          // "cache" the source description and don't query I/O anymore
           //
-          LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, &RecordInDb->Link);
-
+          CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
+          if (RecordInDb->ProtocolType == SxType) {
+            SxChildWasDispatched = TRUE;
+          }
           //
-          // if it's the last one, try to clear EOS
+          // Records for the same source share the top level status bit, so
+          // exhaust the rest of this bucket looking for the same source.
           //
-          if (IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
-            //
-            // Clear pending SMI status before EOS
-            //
-            ClearPendingSmiStatus (SmiStsValue, SciEn);
-            EosSet = PchSmmSetAndCheckEos ();
+          for (; Index < mDispatchIndex.Start[Bucket + 1]; Index++) {
+            PchSmmDispatchRecord (mDispatchIndex.Records[Index], &ActiveSource, &SxChildWasDispatched);
           }
-        } else {
+        }
+      } else {
+        LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+        while (!IsNull (&mPrivateData.CallbackDataBase, LinkInDb)) {
+          //
+          // look for the first active source
+          //
+          if (SourceIsActive (&DATABASE_RECORD_FROM_LINK (LinkInDb)->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+            RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+            break;
+          }
+          LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb);
+        }
+
+        if (RecordInDb != NULL) {
           //
           // We found a source. If this is a sleep type, we have to go to
           // appropriate sleep state anyway.No matter there is sleep child or not
@@ -777,102 +1032,41 @@ PchSmmCoreDispatcher (
             // To prevent the issue, we need to get next record in DB here (before Callback function).
             //
             LinkToExhaust = GetNextNode (&mPrivateData.CallbackDataBase, &RecordToExhaust->Link);
-
-            if (CompareSources (&RecordToExhaust->SrcDesc, &ActiveSource)) {
-              //
-              // These source descriptions are equal, so this callback should be
-              // dispatched.
-              //
-              if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
-                //
-                // This child requires that we get a calling context from
-                // hardware and compare that context to the one supplied
-                // by the child.
-                //
-                ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
-
-                //
-                // Make sure contexts match before dispatching event to child
-                //
-                RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
-                ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
-
-              } else {
-                //
-                // This child doesn't require any more calling context beyond what
-                // it supplied in registration.  Simply pass back what it gave us.
-                //
-                Context       = RecordToExhaust->ChildContext;
-                ContextsMatch = TRUE;
-              }
-
-              if (ContextsMatch) {
-                if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
-                  //
-                  // For PCH SMI dispatch protocols
-                  //
-                  PchSmiTypeCallbackDispatcher (RecordToExhaust);
-                } else {
-                  //
-                  // For EFI standard SMI dispatch protocols
-                  //
-                  if (RecordToExhaust->Callback != NULL) {
-                    if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
-                      //
-                      // This callback function needs CommBuffer and CommBufferSize.
-                      // Get those from child and then pass to callback function.
-                      //
-                      RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
-                    } else {
-                      //
-                      // Child doesn't support the CommBuffer and CommBufferSize.
-                      // Just pass NULL value to callback function.
-                      //
-                      CommBuffer     = NULL;
-                      CommBufferSize = 0;
-                    }
-
-                    PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
-                    PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    if (RecordToExhaust->ProtocolType == SxType) {
-                      SxChildWasDispatched = TRUE;
-                    }
-                  } else {
-                    ASSERT (FALSE);
-                  }
-                }
-              }
-            }
+            PchSmmDispatchRecord (RecordToExhaust, &ActiveSource, &SxChildWasDispatched);
           }
+        }
+      }
 
-          if (RecordInDb->ClearSource == NULL) {
-            //
-            // Clear the SMI associated w/ the source using the default function
-            //
-            PchSmmClearSource (&ActiveSource);
-          } else {
-            //
-            // This source requires special handling to clear
-            //
-            RecordInDb->ClearSource (&ActiveSource);
-          }
-          //
-          // Clear pending SMI status before EOS
-          //
-          ClearPendingSmiStatus (SmiStsValue, SciEn);
+      if (RecordInDb != NULL) {
+        Claimed = TRUE;
+        if (RecordInDb->ClearSource == NULL) {
           //
-          // Also, try to clear EOS
+          // Clear the SMI associated w/ the source using the default function
           //
-          EosSet = PchSmmSetAndCheckEos ();
+          PchSmmClearSource (&ActiveSource);
+        } else {
           //
-          // Queue is empty, reset the search
+          // This source requires special handling to clear
           //
-          break;
+          RecordInDb->ClearSource (&ActiveSource);
         }
+        Bucket = GetSmiStsSourceIndex (&ActiveSource);
+        mDispatchStats.Source[Bucket].DispatchCount++;
+        mDispatchStats.Source[Bucket].Cycles += AsmReadTsc () - StartTsc;
       }
+      //
+      // Clear pending SMI status before EOS
+      //
+      ClearPendingSmiStatus (SmiStsValue, SciEn);
+      //
+      // Also, try to clear EOS
+      //
+      EosSet = PchSmmSetAndCheckEos ();
     }
   }
+  if (!Claimed) {
+    mDispatchStats.UnclaimedCount++;
+  }
   //
   // If you arrive here, there are two possible reasons:
   // (1) you've got problems with clearing the SMI status bits in the
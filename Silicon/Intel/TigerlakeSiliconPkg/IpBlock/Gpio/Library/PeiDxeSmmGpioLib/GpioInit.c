@@ -34,6 +34,31 @@ typedef struct {
 //
 #define GPIO_GROUP_DW_NUMBER  1
 
+//
+// Number of PADCFG_DW registers programmed for each pad (DW0, DW1 and DW2)
+//
+#define GPIO_PADCFG_DW_REG_PROGRAMMED  3
+
+//
+// A pad configuration image built by GpioBuildPadConfigImage starts with
+// GPIO_PAD_CONFIG_IMAGE_HEADER. It is followed by one GPIO_IMAGE_GROUP record
+// for every run of adjacent table entries which belong to the same group, and
+// each group record is followed by the GPIO_IMAGE_PAD records of that run.
+//
+typedef struct {
+  GPIO_GROUP             Group;
+  UINT32                 GroupIndex;
+  UINT32                 PadCount;
+  UINT32                 PadsToUnlock[GPIO_GROUP_DW_NUMBER];
+  GPIO_GROUP_DW_DATA     GroupDwData[GPIO_GROUP_DW_NUMBER];
+} GPIO_IMAGE_GROUP;
+
+typedef struct {
+  UINT32                 PadCfgReg;
+  UINT32                 PadCfgDwReg[GPIO_PADCFG_DW_REG_PROGRAMMED];
+  UINT32                 PadCfgDwRegMask[GPIO_PADCFG_DW_REG_PROGRAMMED];
+} GPIO_IMAGE_PAD;
+
 /**
   Get GPIO DW Register values (HOSTSW_OWN, GPE_EN, NMI_EN, Lock).
 
@@ -194,6 +219,122 @@ GpioUnlockPadsForAGroup (
   return EFI_SUCCESS;
 }
 
+/**
+  Write PADCFG DW0, DW1 and DW2 registers of one pad.
+
+  @param[in] GpioCom                    GPIO community
+  @param[in] PadCfgReg                  Offset of the pad PADCFG DW0 register
+  @param[in] PadCfgDwReg                PADCFG DWx register values
+  @param[in] PadCfgDwRegMask            Mask with PADCFG DWx register bits to be modified
+**/
+STATIC
+VOID
+GpioWritePadCfgRegs (
+  IN PCH_SBI_PID               GpioCom,
+  IN UINT32                    PadCfgReg,
+  IN CONST UINT32              *PadCfgDwReg,
+  IN CONST UINT32              *PadCfgDwRegMask
+  )
+{
+  UINT32  DwReg;
+
+  for (DwReg = 0; DwReg < GPIO_PADCFG_DW_REG_PROGRAMMED; DwReg++) {
+    MmioAndThenOr32 (
+      PCH_PCR_ADDRESS (GpioCom, PadCfgReg + DwReg * 0x4),
+      ~PadCfgDwRegMask[DwReg],
+      PadCfgDwReg[DwReg]
+      );
+  }
+}
+
+/**
+  Write HOSTSW_OWN, GPI_GPE_EN, GPI_NMI_EN and GPI_SMI_EN registers of one group
+  and store its pad unlock data.
+
+  @param[in] GpioGroupInfo              GPIO group information table
+  @param[in] GroupIndex                 GPIO group index
+  @param[in] GroupDwData                Values for GPIO DW Registers of the group
+**/
+STATIC
+VOID
+GpioWriteGroupDwRegs (
+  IN CONST GPIO_GROUP_INFO     *GpioGroupInfo,
+  IN UINT32                    GroupIndex,
+  IN CONST GPIO_GROUP_DW_DATA  *GroupDwData
+  )
+{
+  UINT32                 DwNum;
+  PCH_SBI_PID            GpioCom;
+
+  GpioCom = GpioGroupInfo[GroupIndex].Community;
+
+  for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
+    //
+    // Write HOSTSW_OWN registers
+    //
+    if (GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) {
+      MmioAndThenOr32 (
+        PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].HostOwnOffset + DwNum * 0x4),
+        ~GroupDwData[DwNum].HostSoftOwnRegMask,
+        GroupDwData[DwNum].HostSoftOwnReg
+        );
+    }
+
+    //
+    // Write GPI_GPE_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      MmioAndThenOr32 (
+        PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].GpiGpeEnOffset + DwNum * 0x4),
+        ~GroupDwData[DwNum].GpiGpeEnRegMask,
+        GroupDwData[DwNum].GpiGpeEnReg
+        );
+    }
+
+    //
+    // Write GPI_NMI_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].NmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      MmioAndThenOr32 (
+        PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4),
+        ~GroupDwData[DwNum].GpiNmiEnRegMask,
+        GroupDwData[DwNum].GpiNmiEnReg
+        );
+    } else if (GroupDwData[DwNum].GpiNmiEnReg != 0x0) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting NMI\n", GroupIndex));
+      ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
+    }
+
+    //
+    // Write GPI_SMI_EN registers
+    //
+    if (GpioGroupInfo[GroupIndex].SmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
+      MmioAndThenOr32 (
+        PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4),
+        ~GroupDwData[DwNum].GpiSmiEnRegMask,
+        GroupDwData[DwNum].GpiSmiEnReg
+        );
+    } else if (GroupDwData[DwNum].GpiSmiEnReg != 0x0) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting SMI\n", GroupIndex));
+      ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
+    }
+
+    //
+    // Update Pad Configuration unlock data
+    //
+    if (GroupDwData[DwNum].ConfigUnlockMask) {
+      GpioStoreGroupDwUnlockPadConfigData (GroupIndex, DwNum, GroupDwData[DwNum].ConfigUnlockMask);
+    }
+
+    //
+    // Update Pad Output unlock data
+    //
+    if (GroupDwData[DwNum].OutputUnlockMask) {
+      GpioStoreGroupDwUnlockOutputData (GroupIndex, DwNum, GroupDwData[DwNum].OutputUnlockMask);
+    }
+  }
+}
+
 /**
   This procedure will initialize multiple PCH GPIO pins
 
@@ -215,7 +356,6 @@ GpioConfigurePch (
   UINT32                 PadCfgDwRegMask[GPIO_PADCFG_DW_REG_NUMBER];
   UINT32                 PadCfgReg;
   GPIO_GROUP_DW_DATA     GroupDwData[GPIO_GROUP_DW_NUMBER];
-  UINT32                 DwNum;
   CONST GPIO_GROUP_INFO  *GpioGroupInfo;
   UINT32                 GpioGroupInfoLength;
   GPIO_PAD_OWN           PadOwnVal;
@@ -321,31 +461,7 @@ GpioConfigurePch (
       //
       PadCfgReg = S_GPIO_PCR_PADCFG * PadNumber + GpioGroupInfo[GroupIndex].PadCfgOffset;
 
-      //
-      // Write PADCFG DW0 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg),
-        ~PadCfgDwRegMask[0],
-        PadCfgDwReg[0]
-        );
-      //
-      // Write PADCFG DW1 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x4),
-        ~PadCfgDwRegMask[1],
-        PadCfgDwReg[1]
-        );
-
-      //
-      // Write PADCFG DW2 register
-      //
-      MmioAndThenOr32 (
-        PCH_PCR_ADDRESS (GpioCom, PadCfgReg + 0x8),
-        ~PadCfgDwRegMask[2],
-        PadCfgDwReg[2]
-        );
+      GpioWritePadCfgRegs (GpioCom, PadCfgReg, PadCfgDwReg, PadCfgDwRegMask);
 
       //
       // Get GPIO DW register values from GPIO config data
@@ -360,71 +476,7 @@ GpioConfigurePch (
       Index++;
     }
 
-    for (DwNum = 0; DwNum <= GPIO_GET_DW_NUM (GpioGroupInfo[GroupIndex].PadPerGroup); DwNum++) {
-      //
-      // Write HOSTSW_OWN registers
-      //
-      if (GpioGroupInfo[GroupIndex].HostOwnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].HostOwnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].HostSoftOwnRegMask,
-          GroupDwData[DwNum].HostSoftOwnReg
-          );
-      }
-
-      //
-      // Write GPI_GPE_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].GpiGpeEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].GpiGpeEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiGpeEnRegMask,
-          GroupDwData[DwNum].GpiGpeEnReg
-          );
-      }
-
-      //
-      // Write GPI_NMI_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].NmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].NmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiNmiEnRegMask,
-          GroupDwData[DwNum].GpiNmiEnReg
-          );
-      } else if (GroupDwData[DwNum].GpiNmiEnReg != 0x0) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting NMI\n", GroupIndex));
-        ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
-      }
-
-      //
-      // Write GPI_SMI_EN registers
-      //
-      if (GpioGroupInfo[GroupIndex].SmiEnOffset != NO_REGISTER_FOR_PROPERTY) {
-        MmioAndThenOr32 (
-          PCH_PCR_ADDRESS (GpioCom, GpioGroupInfo[GroupIndex].SmiEnOffset + DwNum * 0x4),
-          ~GroupDwData[DwNum].GpiSmiEnRegMask,
-          GroupDwData[DwNum].GpiSmiEnReg
-          );
-      } else if (GroupDwData[DwNum].GpiSmiEnReg != 0x0) {
-        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Group %d has no pads supporting SMI\n", GroupIndex));
-        ASSERT_EFI_ERROR (EFI_UNSUPPORTED);
-      }
-
-      //
-      // Update Pad Configuration unlock data
-      //
-      if (GroupDwData[DwNum].ConfigUnlockMask) {
-        GpioStoreGroupDwUnlockPadConfigData (GroupIndex, DwNum, GroupDwData[DwNum].ConfigUnlockMask);
-      }
-
-      //
-      // Update Pad Output unlock data
-      //
-      if (GroupDwData[DwNum].OutputUnlockMask) {
-        GpioStoreGroupDwUnlockOutputData (GroupIndex, DwNum, GroupDwData[DwNum].OutputUnlockMask);
-      }
-    }
+    GpioWriteGroupDwRegs (GpioGroupInfo, GroupIndex, GroupDwData);
   }
 
   return EFI_SUCCESS;
@@ -556,3 +608,258 @@ GpioConfigurePads (
   return Status;
 }
 
+/**
+  This procedure will translate a GPIO initialization table into a pad configuration
+  image. The image holds the PADCFG register values and the per group register masks
+  which GpioConfigurePads would program for the same table, so that it can later be
+  applied with GpioConfigurePadsFromImage without translating every pad again.
+  The image does not contain pointers and can be stored, e.g. in a HOB or in flash.
+
+  @param[in]      NumberOfItems         Number of GPIO pads in the table
+  @param[in]      GpioInitTableAddress  GPIO initialization table
+  @param[out]     Image                 Buffer receiving the image, may be NULL if *ImageSize is 0
+  @param[in, out] ImageSize             On input, size of the Image buffer in bytes.
+                                        On output, size of the image in bytes.
+
+  @retval EFI_SUCCESS                   The image was built
+  @retval EFI_BUFFER_TOO_SMALL          Image buffer is too small, *ImageSize holds the required size
+  @retval EFI_INVALID_PARAMETER         Invalid group or pad number
+**/
+EFI_STATUS
+GpioBuildPadConfigImage (
+  IN     UINT32                NumberOfItems,
+  IN     GPIO_INIT_CONFIG      *GpioInitTableAddress,
+  OUT    VOID                  *Image,
+  IN OUT UINT32                *ImageSize
+  )
+{
+  GPIO_PAD_CONFIG_IMAGE_HEADER  Header;
+  GPIO_IMAGE_GROUP              ImageGroup;
+  GPIO_IMAGE_PAD                ImagePad;
+  UINT32                        PadCfgDwReg[GPIO_PADCFG_DW_REG_NUMBER];
+  UINT32                        PadCfgDwRegMask[GPIO_PADCFG_DW_REG_NUMBER];
+  UINT32                        Index;
+  UINT32                        Offset;
+  UINT32                        GroupOffset;
+  UINT32                        DwNum;
+  CONST GPIO_GROUP_INFO         *GpioGroupInfo;
+  UINT32                        GpioGroupInfoLength;
+  GPIO_PAD_OWN                  PadOwnVal;
+  CONST GPIO_INIT_CONFIG        *GpioData;
+  UINT32                        GroupIndex;
+  UINT32                        PadNumber;
+
+  if ((ImageSize == NULL) || ((Image == NULL) && (*ImageSize != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PadOwnVal = GpioPadOwnHost;
+
+  GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
+
+  ZeroMem (&Header, sizeof (Header));
+  Header.Signature = GPIO_PAD_CONFIG_IMAGE_SIGNATURE;
+  Header.Revision  = GPIO_PAD_CONFIG_IMAGE_REVISION;
+
+  //
+  // Records are only copied while they fit, the required size is always computed
+  //
+  Offset = sizeof (GPIO_PAD_CONFIG_IMAGE_HEADER);
+  Index  = 0;
+  while (Index < NumberOfItems) {
+
+    GpioData   = &GpioInitTableAddress[Index];
+    GroupIndex = GpioGetGroupIndexFromGpioPad (GpioData->GpioPad);
+
+    DEBUG_CODE_BEGIN();
+    if (!GpioIsCorrectPadForThisChipset (GpioData->GpioPad)) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Incorrect GpioPad (0x%08x) used on this chipset!\n", GpioData->GpioPad));
+      ASSERT (FALSE);
+      return EFI_UNSUPPORTED;
+    }
+    DEBUG_CODE_END ();
+
+    ZeroMem (&ImageGroup, sizeof (ImageGroup));
+    ImageGroup.Group      = GpioGetGroupFromGpioPad (GpioData->GpioPad);
+    ImageGroup.GroupIndex = GroupIndex;
+    GroupOffset           = Offset;
+    Offset               += sizeof (GPIO_IMAGE_GROUP);
+
+    //
+    // Loop through pads for one group. If pad belongs to a different group then
+    // break and close the group record.
+    //
+    while (Index < NumberOfItems) {
+
+      GpioData   = &GpioInitTableAddress[Index];
+      if (GroupIndex != GpioGetGroupIndexFromGpioPad (GpioData->GpioPad)) {
+        //if next pad is from different group then break loop
+        break;
+      }
+
+      PadNumber  = GpioGetPadNumberFromGpioPad (GpioData->GpioPad);
+
+      //
+      // Check if legal pin number
+      //
+      if (PadNumber >= GpioGroupInfo[GroupIndex].PadPerGroup) {
+        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Pin number (%d) exceeds possible range for group %d\n", PadNumber, GroupIndex));
+        return EFI_INVALID_PARAMETER;
+      }
+
+      DwNum = GPIO_GET_DW_NUM (PadNumber);
+      if (DwNum >= GPIO_GROUP_DW_NUMBER) {
+        ASSERT (FALSE);
+        return EFI_UNSUPPORTED;
+      }
+      //
+      // All pads of the table are unlocked before reconfiguring, see GpioConfigurePch
+      //
+      ImageGroup.PadsToUnlock[DwNum] |= 0x1 << GPIO_GET_PAD_POSITION (PadNumber);
+
+      DEBUG_CODE_BEGIN ();
+      //
+      // Check if selected GPIO Pad is not owned by CSME/ISH
+      //
+      GpioGetPadOwnership (GpioData->GpioPad, &PadOwnVal);
+
+      if (PadOwnVal != GpioPadOwnHost) {
+        DEBUG ((DEBUG_ERROR, "GPIO ERROR: Accessing pad not owned by host (Group=%d, Pad=%d)!\n", GroupIndex, PadNumber));
+        DEBUG ((DEBUG_ERROR, "** Please make sure the GPIO usage in sync between CSME and BIOS configuration. \n"));
+        DEBUG ((DEBUG_ERROR, "** All the GPIO occupied by CSME should not do any configuration by BIOS.\n"));
+        //Move to next item
+        Index++;
+        continue;
+      }
+
+      //
+      // Check if Pad enabled for SCI is to be in unlocked state
+      //
+      if (((GpioData->GpioConfig.InterruptConfig & GpioIntSci) == GpioIntSci) &&
+          ((GpioData->GpioConfig.LockConfig & B_GPIO_LOCK_CONFIG_PAD_CONF_LOCK_MASK) != GpioPadConfigUnlock)){
+        DEBUG ((DEBUG_ERROR, "GPIO ERROR: %a used for SCI is not unlocked!\n", GpioName (GpioData->GpioPad)));
+        ASSERT (FALSE);
+        return EFI_INVALID_PARAMETER;
+      }
+      DEBUG_CODE_END ();
+
+      ZeroMem (PadCfgDwReg, sizeof (PadCfgDwReg));
+      ZeroMem (PadCfgDwRegMask, sizeof (PadCfgDwRegMask));
+      GpioPadCfgRegValueFromGpioConfig (
+        GpioData->GpioPad,
+        &GpioData->GpioConfig,
+        PadCfgDwReg,
+        PadCfgDwRegMask
+        );
+
+      ImagePad.PadCfgReg = S_GPIO_PCR_PADCFG * PadNumber + GpioGroupInfo[GroupIndex].PadCfgOffset;
+      CopyMem (ImagePad.PadCfgDwReg, PadCfgDwReg, sizeof (ImagePad.PadCfgDwReg));
+      CopyMem (ImagePad.PadCfgDwRegMask, PadCfgDwRegMask, sizeof (ImagePad.PadCfgDwRegMask));
+      if ((Offset + sizeof (GPIO_IMAGE_PAD)) <= *ImageSize) {
+        CopyMem ((UINT8 *) Image + Offset, &ImagePad, sizeof (GPIO_IMAGE_PAD));
+      }
+      Offset += sizeof (GPIO_IMAGE_PAD);
+      ImageGroup.PadCount++;
+      Header.PadCount++;
+
+      GpioDwRegValueFromGpioConfig (
+        PadNumber,
+        &GpioData->GpioConfig,
+        ImageGroup.GroupDwData
+        );
+
+      //Move to next item
+      Index++;
+    }
+
+    if ((GroupOffset + sizeof (GPIO_IMAGE_GROUP)) <= *ImageSize) {
+      CopyMem ((UINT8 *) Image + GroupOffset, &ImageGroup, sizeof (GPIO_IMAGE_GROUP));
+    }
+    Header.GroupCount++;
+  }
+
+  Header.Size = Offset;
+  if (Offset > *ImageSize) {
+    *ImageSize = Offset;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+  CopyMem (Image, &Header, sizeof (Header));
+  *ImageSize = Offset;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This procedure will program GPIO pads from a pad configuration image built by
+  GpioBuildPadConfigImage. It performs the same register writes as GpioConfigurePads
+  for the table the image was built from, without translating the pad configuration.
+
+  @param[in] Image                      Pad configuration image
+
+  @retval EFI_SUCCESS                   The function completed successfully
+  @retval EFI_INVALID_PARAMETER         Image is not a valid pad configuration image
+**/
+EFI_STATUS
+GpioConfigurePadsFromImage (
+  IN CONST VOID                *Image
+  )
+{
+  CONST GPIO_PAD_CONFIG_IMAGE_HEADER  *Header;
+  CONST GPIO_IMAGE_GROUP              *ImageGroup;
+  CONST GPIO_IMAGE_PAD                *ImagePad;
+  CONST UINT8                         *ImageEnd;
+  CONST GPIO_GROUP_INFO               *GpioGroupInfo;
+  UINT32                              GpioGroupInfoLength;
+  UINT32                              GroupNum;
+  UINT32                              PadNum;
+  UINT32                              DwNum;
+
+  Header = (CONST GPIO_PAD_CONFIG_IMAGE_HEADER *) Image;
+  if ((Header == NULL) ||
+      (Header->Signature != GPIO_PAD_CONFIG_IMAGE_SIGNATURE) ||
+      (Header->Revision != GPIO_PAD_CONFIG_IMAGE_REVISION) ||
+      (Header->Size < sizeof (GPIO_PAD_CONFIG_IMAGE_HEADER))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  GpioGroupInfo = GpioGetGroupInfoTable (&GpioGroupInfoLength);
+
+  ImageEnd   = (CONST UINT8 *) Image + Header->Size;
+  ImageGroup = (CONST GPIO_IMAGE_GROUP *) (Header + 1);
+  for (GroupNum = 0; GroupNum < Header->GroupCount; GroupNum++) {
+    if (((CONST UINT8 *) (ImageGroup + 1) > ImageEnd) ||
+        ((CONST UINT8 *) ((CONST GPIO_IMAGE_PAD *) (ImageGroup + 1) + ImageGroup->PadCount) > ImageEnd) ||
+        (ImageGroup->GroupIndex >= GpioGroupInfoLength)) {
+      DEBUG ((DEBUG_ERROR, "GPIO ERROR: Pad configuration image is corrupted\n"));
+      ASSERT (FALSE);
+      return EFI_INVALID_PARAMETER;
+    }
+
+    //
+    // Unlock pads for a given group which are going to be reconfigured
+    //
+    for (DwNum = 0; DwNum < GPIO_GROUP_DW_NUMBER; DwNum++) {
+      if (ImageGroup->PadsToUnlock[DwNum] != 0) {
+        GpioUnlockPadCfgForGroupDw (ImageGroup->Group, DwNum, ImageGroup->PadsToUnlock[DwNum]);
+        GpioUnlockPadCfgTxForGroupDw (ImageGroup->Group, DwNum, ImageGroup->PadsToUnlock[DwNum]);
+      }
+    }
+
+    ImagePad = (CONST GPIO_IMAGE_PAD *) (ImageGroup + 1);
+    for (PadNum = 0; PadNum < ImageGroup->PadCount; PadNum++, ImagePad++) {
+      GpioWritePadCfgRegs (
+        GpioGroupInfo[ImageGroup->GroupIndex].Community,
+        ImagePad->PadCfgReg,
+        ImagePad->PadCfgDwReg,
+        ImagePad->PadCfgDwRegMask
+        );
+    }
+
+    GpioWriteGroupDwRegs (GpioGroupInfo, ImageGroup->GroupIndex, ImageGroup->GroupDwData);
+
+    ImageGroup = (CONST GPIO_IMAGE_GROUP *) ImagePad;
+  }
+
+  GpioClearAllGpioInterrupts ();
+  return EFI_SUCCESS;
+}
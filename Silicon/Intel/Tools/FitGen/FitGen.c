@@ -45,6 +45,9 @@ typedef struct {
 #define MICROCODE_ALIGNMENT    0x7FF
 
 #define MICROCODE_EXTERNAL_HEADER_SIZE 0x30
+#define MICROCODE_DEFAULT_TOTAL_SIZE   0x800
+#define MICROCODE_EXTENDED_TABLE_HEADER_SIZE  0x14
+#define MICROCODE_EXTENDED_SIGNATURE_SIZE     0xC
 
 #define ACM_PKCS_1_5_RSA_SIGNATURE_SHA256_SIZE          256
 #define ACM_PKCS_1_5_RSA_SIGNATURE_SHA384_SIZE          384
@@ -341,6 +344,51 @@ typedef struct {
 
 FIT_TABLE_CONTEXT   gFitTableContext = {0};
 
+//
+// Index of the FVs and FFS files of the input image, built once so that
+// GUID lookups do not walk the whole image again.
+//
+#define FIT_FFS_HASH_SIZE  1024
+
+typedef struct {
+  EFI_FIRMWARE_VOLUME_HEADER *FvHeader;
+  UINT64                     FvLength;
+} FIT_FV_INDEX_ENTRY;
+
+typedef struct {
+  EFI_GUID                   Name;
+  UINT8                      *FileData;
+  UINT32                     FileSize;
+  UINT32                     FvIndex;
+  UINT32                     Next;
+} FIT_FFS_INDEX_ENTRY;
+
+typedef struct {
+  UINT8                      *Buffer;
+  UINTN                      Size;
+  FIT_FV_INDEX_ENTRY         *Fv;
+  UINT32                     FvNumber;
+  FIT_FFS_INDEX_ENTRY        *Ffs;
+  UINT32                     FfsNumber;
+  UINT32                     Bucket[FIT_FFS_HASH_SIZE];
+} FIT_FFS_INDEX;
+
+#define FIT_FFS_INDEX_END  0xFFFFFFFF
+
+FIT_FFS_INDEX       mFfsIndex = {0};
+
+//
+// Timing mode (-TIMING) reports the time spent in each phase.
+//
+BOOLEAN             mTiming = FALSE;
+clock_t             mPhaseStart;
+
+//
+// Size of the input image mapping, or 0 if the input image was read into
+// an allocated buffer.
+//
+UINTN               mMappedInputSize = 0;
+
 unsigned int
 xtoi (
   char  *str
@@ -468,6 +516,7 @@ PrintUsage (
           "\t[-P RecordType <IndexPort DataPort Width Bit Index> [-V <RecordVersion>]] [-P ... [-V ...]]\n"
           "\t[-BP <BootPolicySize>[-V <BootPolicyVersion>]\n"
           "\t[-T <FixedFitLocation>]\n"
+          "\t[-TIMING]\n"
           , UTILITY_NAME);
   printf ("  Where:\n");
   printf ("\t-D                     - It is FD file instead of FV file. (The tool will search FV file)\n");
@@ -517,10 +566,15 @@ PrintUsage (
   printf ("\tBit                    - The Bit Number of the port.\n");
   printf ("\tIndex                  - The Index Number of the port.\n");
   printf ("\tFixedFitLocation       - Fixed FIT location in flash address. FIT table will be generated at this location and Option Modules will be directly put right before it.\n");
+  printf ("\t-TIMING                - Report the time spent in each phase of the FIT generation.\n");
   printf ("\nUsage (view): %s [-view] InputFile -F <FitTablePointerOffset>\n", UTILITY_NAME);
   printf ("  Where:\n");
   printf ("\tInputFile              - Name of the input file.\n");
   printf ("\tFitTablePointerOffset  - FIT table pointer offset from end of file. 0x%x as default.\n", DEFAULT_FIT_TABLE_POINTER_OFFSET);
+  printf ("\nUsage (verify): %s [-verify] InputFile -F <FitTablePointerOffset>\n", UTILITY_NAME);
+  printf ("  Where:\n");
+  printf ("\tInputFile              - Name of the input file. It is not modified.\n");
+  printf ("\tFitTablePointerOffset  - FIT table pointer offset from end of file. 0x%x as default.\n", DEFAULT_FIT_TABLE_POINTER_OFFSET);
   printf ("\nTool return values:\n");
   printf ("\tSTATUS_SUCCESS=%d, STATUS_WARNING=%d, STATUS_ERROR=%d\n", STATUS_SUCCESS, STATUS_WARNING, STATUS_ERROR);
 }
@@ -711,6 +765,131 @@ ReadInputFile (
   return STATUS_SUCCESS;
 }
 
+/**
+  Map the input image file into memory.
+
+  The mapping is private, so that changes made to the image in memory are not
+  written back to the input file. The image data is aligned like the buffer
+  returned by ReadInputFile. If the file cannot be mapped, it is read into an
+  allocated buffer instead.
+
+  @param FileName                    The input file name.
+  @param FileData                    The input file data, the memory is aligned.
+  @param FileSize                    The input file size.
+  @param FileBufferRaw               The memory to hold input file data. The caller must release
+                                     it with ReleaseInputFile.
+
+  @return STATUS_SUCCESS             The file found and data mapped or read.
+  @return STATUS_ERROR               The file data is not read.
+  @return STATUS_WARNING             The file is not found.
+**/
+STATUS
+MapInputFile (
+  IN CHAR8    *FileName,
+  OUT UINT8   **FileData,
+  OUT UINT32  *FileSize,
+  OUT UINT8   **FileBufferRaw
+  )
+{
+#ifndef _WIN32
+  int                         Fd;
+  struct stat                 FileStat;
+  UINT8                       *Reserved;
+  UINT8                       *Mapped;
+  UINTN                       MapSize;
+
+  mMappedInputSize = 0;
+
+  if (!CheckPath(FileName)) {
+    Error (NULL, 0, 0, "File path is invalid!", NULL);
+    return STATUS_ERROR;
+  }
+
+  Fd = open (FileName, O_RDONLY);
+  if (Fd < 0) {
+    return STATUS_WARNING;
+  }
+  if ((fstat (Fd, &FileStat) != 0) || (FileStat.st_size == 0) || (FileStat.st_size > 0xFFFFFFFF)) {
+    close (Fd);
+    return ReadInputFile (FileName, FileData, FileSize, FileBufferRaw);
+  }
+
+  //
+  // Reserve 128K more than needed and map the file at the first 64K boundary
+  // of the reservation. The zero filled space left after the file keeps
+  // the signature scans near the end of the image within readable memory.
+  //
+  MapSize = (UINTN)FileStat.st_size + 0x20000;
+  Reserved = mmap (NULL, MapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (Reserved == MAP_FAILED) {
+    close (Fd);
+    return ReadInputFile (FileName, FileData, FileSize, FileBufferRaw);
+  }
+  Mapped = (UINT8 *)(((UINTN)Reserved + 0xFFFF) & ~(UINTN)0xFFFF);
+  if (mmap (Mapped, (size_t)FileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, Fd, 0) == MAP_FAILED) {
+    munmap (Reserved, MapSize);
+    close (Fd);
+    return ReadInputFile (FileName, FileData, FileSize, FileBufferRaw);
+  }
+  close (Fd);
+
+  *FileBufferRaw   = Reserved;
+  *FileData        = Mapped;
+  *FileSize        = (UINT32)FileStat.st_size;
+  mMappedInputSize = MapSize;
+
+  return STATUS_SUCCESS;
+#else
+  return ReadInputFile (FileName, FileData, FileSize, FileBufferRaw);
+#endif
+}
+
+/**
+  Release the input image returned by MapInputFile.
+
+  @param FileBufferRaw               The memory holding the input file data.
+**/
+VOID
+ReleaseInputFile (
+  IN UINT8    *FileBufferRaw
+  )
+{
+#ifndef _WIN32
+  if (mMappedInputSize != 0) {
+    munmap (FileBufferRaw, mMappedInputSize);
+    mMappedInputSize = 0;
+    return;
+  }
+#endif
+  free ((VOID *)FileBufferRaw);
+}
+
+/**
+  Start timing a phase.
+**/
+VOID
+StartPhase (
+  VOID
+  )
+{
+  mPhaseStart = clock ();
+}
+
+/**
+  Report the time spent in a phase, in timing mode.
+
+  @param PhaseName        Name of the phase.
+**/
+VOID
+EndPhase (
+  IN CHAR8  *PhaseName
+  )
+{
+  if (mTiming) {
+    printf ("Timing: %-24s %8.3f ms\n", PhaseName, (double)(clock () - mPhaseStart) * 1000.0 / CLOCKS_PER_SEC);
+  }
+}
+
 /**
     Find next FvHeader in the FileBuffer.
 
@@ -729,6 +908,23 @@ FindNextFvHeader (
   UINT8                       *FileHeader;
   EFI_FIRMWARE_VOLUME_HEADER  *FvHeader;
   UINT16                      FileChecksum;
+  UINT32                      Index;
+
+  //
+  // The FVs of the indexed image are found from its start, and from the
+  // end of each FV, so those searches are answered from the index.
+  //
+  if ((mFfsIndex.Buffer != NULL) &&
+      ((UINTN)FileBuffer + FileLength == (UINTN)mFfsIndex.Buffer + mFfsIndex.Size)) {
+    if (FileBuffer == mFfsIndex.Buffer) {
+      return (mFfsIndex.FvNumber != 0) ? (UINT8 *)mFfsIndex.Fv[0].FvHeader : NULL;
+    }
+    for (Index = 0; Index < mFfsIndex.FvNumber; Index++) {
+      if ((UINTN)mFfsIndex.Fv[Index].FvHeader + (UINTN)mFfsIndex.Fv[Index].FvLength == (UINTN)FileBuffer) {
+        return (Index + 1 < mFfsIndex.FvNumber) ? (UINT8 *)mFfsIndex.Fv[Index + 1].FvHeader : NULL;
+      }
+    }
+  }
 
   FileHeader = FileBuffer;
   for (; (UINTN)FileBuffer < (UINTN)FileHeader + FileLength; FileBuffer += 8) {
@@ -774,6 +970,216 @@ FindNextFvHeader (
   return NULL;
 }
 
+/**
+  Hash a GUID into a bucket of the FFS index.
+
+  @param Guid             The GUID.
+
+  @return The bucket number.
+**/
+UINT32
+HashFfsGuid (
+  IN EFI_GUID  *Guid
+  )
+{
+  UINT32  *Data;
+
+  Data = (UINT32 *)Guid;
+  return (Data[0] ^ Data[1] ^ Data[2] ^ Data[3]) & (FIT_FFS_HASH_SIZE - 1);
+}
+
+/**
+  Build the index of the FVs and FFS files of an image.
+
+  The FVs are found and the FFS files are walked the same way as
+  FindFileFromFvByGuid does, in a single pass over the image.
+
+  @param Buffer           The image buffer.
+  @param Size             The image size.
+
+  @return STATUS_SUCCESS  The index is built.
+  @return STATUS_ERROR    No sufficient memory for the index.
+**/
+STATUS
+BuildFfsIndex (
+  IN UINT8     *Buffer,
+  IN UINT32    Size
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FvHeader;
+  EFI_FFS_FILE_HEADER         *FileHeader;
+  UINT64                      FvLength;
+  UINTN                       Offset;
+  UINTN                       FileLength;
+  UINTN                       FileOccupiedSize;
+  UINT32                      FvCapacity;
+  UINT32                      FfsCapacity;
+  UINT32                      Index;
+  UINT32                      Bucket;
+  VOID                        *NewBuffer;
+
+  FvCapacity  = 0;
+  FfsCapacity = 0;
+  mFfsIndex.Buffer = NULL;
+
+  FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FindNextFvHeader (Buffer, Size);
+  while (FvHeader != NULL) {
+    FvLength = FvHeader->FvLength;
+
+    if (mFfsIndex.FvNumber == FvCapacity) {
+      FvCapacity = (FvCapacity == 0) ? 0x20 : FvCapacity * 2;
+      NewBuffer = realloc (mFfsIndex.Fv, FvCapacity * sizeof (FIT_FV_INDEX_ENTRY));
+      if (NewBuffer == NULL) {
+        Error (NULL, 0, 0, "No sufficient memory to allocate!", NULL);
+        return STATUS_ERROR;
+      }
+      mFfsIndex.Fv = NewBuffer;
+    }
+    mFfsIndex.Fv[mFfsIndex.FvNumber].FvHeader = FvHeader;
+    mFfsIndex.Fv[mFfsIndex.FvNumber].FvLength = FvLength;
+
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINTN)FvHeader + FvHeader->HeaderLength);
+    Offset     = (UINTN) FileHeader - (UINTN) FvHeader;
+    while (Offset < FvLength) {
+      if ((UINTN)FileHeader + sizeof (EFI_FFS_FILE_HEADER) > (UINTN)Buffer + Size) {
+        break;
+      }
+      FileLength = (*(UINT32 *)(FileHeader->Size)) & 0x00FFFFFF;
+      FileOccupiedSize = GETOCCUPIEDSIZE(FileLength, 8);
+
+      if (mFfsIndex.FfsNumber == FfsCapacity) {
+        FfsCapacity = (FfsCapacity == 0) ? 0x400 : FfsCapacity * 2;
+        NewBuffer = realloc (mFfsIndex.Ffs, FfsCapacity * sizeof (FIT_FFS_INDEX_ENTRY));
+        if (NewBuffer == NULL) {
+          Error (NULL, 0, 0, "No sufficient memory to allocate!", NULL);
+          return STATUS_ERROR;
+        }
+        mFfsIndex.Ffs = NewBuffer;
+      }
+      CopyMem (&mFfsIndex.Ffs[mFfsIndex.FfsNumber].Name, &FileHeader->Name, sizeof (EFI_GUID));
+      mFfsIndex.Ffs[mFfsIndex.FfsNumber].FileData = (UINT8 *)FileHeader + sizeof(EFI_FFS_FILE_HEADER);
+      mFfsIndex.Ffs[mFfsIndex.FfsNumber].FileSize = (UINT32)(FileLength - sizeof(EFI_FFS_FILE_HEADER));
+#if (PI_SPECIFICATION_VERSION < 0x00010000)
+      if (FileHeader->Attributes & FFS_ATTRIB_TAIL_PRESENT) {
+        mFfsIndex.Ffs[mFfsIndex.FfsNumber].FileSize -= sizeof(EFI_FFS_FILE_TAIL);
+      }
+#endif
+      mFfsIndex.Ffs[mFfsIndex.FfsNumber].FvIndex = mFfsIndex.FvNumber;
+      mFfsIndex.FfsNumber++;
+
+      if (FileOccupiedSize == 0) {
+        break;
+      }
+      FileHeader = (EFI_FFS_FILE_HEADER *)((UINTN)FileHeader + FileOccupiedSize);
+      Offset = (UINTN) FileHeader - (UINTN) FvHeader;
+    }
+    mFfsIndex.FvNumber++;
+
+    //
+    // Next FV
+    //
+    if ((UINTN)Buffer + Size > (UINTN)FvHeader + FvLength) {
+      FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FindNextFvHeader ((UINT8 *)FvHeader + (UINTN)FvLength, (UINTN)Buffer + Size - ((UINTN)FvHeader + (UINTN)FvLength));
+    } else {
+      break;
+    }
+  }
+
+  //
+  // Chain the files of each bucket in image order, so that a lookup finds
+  // the same file as a walk over the image.
+  //
+  for (Bucket = 0; Bucket < FIT_FFS_HASH_SIZE; Bucket++) {
+    mFfsIndex.Bucket[Bucket] = FIT_FFS_INDEX_END;
+  }
+  for (Index = mFfsIndex.FfsNumber; Index > 0; Index--) {
+    Bucket = HashFfsGuid (&mFfsIndex.Ffs[Index - 1].Name);
+    mFfsIndex.Ffs[Index - 1].Next = mFfsIndex.Bucket[Bucket];
+    mFfsIndex.Bucket[Bucket] = Index - 1;
+  }
+
+  mFfsIndex.Buffer = Buffer;
+  mFfsIndex.Size   = Size;
+  if (mTiming) {
+    printf ("Timing: FFS index %u FVs, %u files\n", mFfsIndex.FvNumber, mFfsIndex.FfsNumber);
+  }
+
+  return STATUS_SUCCESS;
+}
+
+/**
+  Free the index of the FVs and FFS files.
+**/
+VOID
+FreeFfsIndex (
+  VOID
+  )
+{
+  free (mFfsIndex.Fv);
+  free (mFfsIndex.Ffs);
+  SetMem (&mFfsIndex, sizeof (mFfsIndex), 0);
+}
+
+/**
+  Find File with GUID in the FFS index.
+
+  @param FvBuffer         FV binary buffer.
+  @param FvSize           FV size.
+  @param Guid             File GUID value to be searched.
+  @param FileSize         Guid File size.
+  @param FileLocation     Guid File location, or NULL if the file is not found.
+
+  @return TRUE            The search is answered from the index.
+  @return FALSE           The buffer is not indexed, it has to be walked.
+**/
+BOOLEAN
+FindFileFromFfsIndex (
+  IN UINT8     *FvBuffer,
+  IN UINT32    FvSize,
+  IN EFI_GUID  *Guid,
+  OUT UINT32   *FileSize,
+  OUT UINT8    **FileLocation
+  )
+{
+  UINT32  FvIndex;
+  UINT32  Index;
+
+  if (mFfsIndex.Buffer == NULL) {
+    return FALSE;
+  }
+
+  //
+  // The search covers either the whole image, or a single FV of it.
+  //
+  if ((FvBuffer == mFfsIndex.Buffer) && (FvSize == mFfsIndex.Size)) {
+    FvIndex = FIT_FFS_INDEX_END;
+  } else {
+    for (FvIndex = 0; FvIndex < mFfsIndex.FvNumber; FvIndex++) {
+      if (((UINT8 *)mFfsIndex.Fv[FvIndex].FvHeader == FvBuffer) &&
+          (mFfsIndex.Fv[FvIndex].FvLength == FvSize)) {
+        break;
+      }
+    }
+    if (FvIndex == mFfsIndex.FvNumber) {
+      return FALSE;
+    }
+  }
+
+  *FileLocation = NULL;
+  for (Index = mFfsIndex.Bucket[HashFfsGuid (Guid)]; Index != FIT_FFS_INDEX_END; Index = mFfsIndex.Ffs[Index].Next) {
+    if ((FvIndex != FIT_FFS_INDEX_END) && (mFfsIndex.Ffs[Index].FvIndex != FvIndex)) {
+      continue;
+    }
+    if (CompareGuid (&mFfsIndex.Ffs[Index].Name, Guid) == 0) {
+      *FileSize     = mFfsIndex.Ffs[Index].FileSize;
+      *FileLocation = mFfsIndex.Ffs[Index].FileData;
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Find File with GUID in an FV.
 
@@ -802,6 +1208,10 @@ FindFileFromFvByGuid (
   UINTN                       FileLength;
   UINTN                       FileOccupiedSize;
 
+  if (FindFileFromFfsIndex (FvBuffer, FvSize, Guid, FileSize, &FixPoint)) {
+    return FixPoint;
+  }
+
   //
   // Find the FFS file
   //
@@ -1007,6 +1417,84 @@ GetMicrocodeBufferFromFv (
   return MicrocodeBuffer;
 }
 
+/**
+  Check a microcode update: header, size and checksums.
+
+  The DWORD sum of the whole update must be zero, and so must the DWORD sum
+  of the extended signature table if there is one.
+
+  @param MicrocodeBuffer  The microcode update.
+  @param MaxSize          The maximum size the update may occupy.
+  @param TotalSize        The total size of the update, from its header.
+
+  @return TRUE            The microcode update is valid.
+  @return FALSE           The microcode update is not valid.
+**/
+BOOLEAN
+VerifyMicrocode (
+  IN UINT8   *MicrocodeBuffer,
+  IN UINT32  MaxSize,
+  OUT UINT32 *TotalSize
+  )
+{
+  UINT32  DataSize;
+  UINT32  Size;
+  UINT32  Index;
+  UINT32  Sum;
+  UINT32  ExtendedTableSize;
+  UINT32  *ExtendedTable;
+
+  *TotalSize = 0;
+  if (MaxSize < MICROCODE_EXTERNAL_HEADER_SIZE) {
+    return FALSE;
+  }
+  if ((*(UINT32 *)(MicrocodeBuffer) != 0x1) ||       // HeaderVersion
+      (*(UINT32 *)(MicrocodeBuffer + 20) != 0x1)) {  // LoaderVersion
+    return FALSE;
+  }
+
+  DataSize = *(UINT32 *)(MicrocodeBuffer + 28);
+  if (DataSize == 0) {
+    DataSize = MICROCODE_DEFAULT_TOTAL_SIZE - MICROCODE_EXTERNAL_HEADER_SIZE;
+    Size     = MICROCODE_DEFAULT_TOTAL_SIZE;
+  } else {
+    Size     = *(UINT32 *)(MicrocodeBuffer + 32);
+  }
+  if ((Size > MaxSize) || ((Size & 0x3) != 0) ||
+      (DataSize > Size - MICROCODE_EXTERNAL_HEADER_SIZE)) {
+    return FALSE;
+  }
+  *TotalSize = Size;
+
+  Sum = 0;
+  for (Index = 0; Index < Size / sizeof (UINT32); Index++) {
+    Sum += ((UINT32 *)MicrocodeBuffer)[Index];
+  }
+  if (Sum != 0) {
+    return FALSE;
+  }
+
+  //
+  // Extended signature table
+  //
+  if (Size - MICROCODE_EXTERNAL_HEADER_SIZE - DataSize >= MICROCODE_EXTENDED_TABLE_HEADER_SIZE) {
+    ExtendedTable     = (UINT32 *)(MicrocodeBuffer + MICROCODE_EXTERNAL_HEADER_SIZE + DataSize);
+    ExtendedTableSize = MICROCODE_EXTENDED_TABLE_HEADER_SIZE + ExtendedTable[0] * MICROCODE_EXTENDED_SIGNATURE_SIZE;
+    if (ExtendedTableSize > Size - MICROCODE_EXTERNAL_HEADER_SIZE - DataSize) {
+      return FALSE;
+    }
+    Sum = 0;
+    for (Index = 0; Index < ExtendedTableSize / sizeof (UINT32); Index++) {
+      Sum += ExtendedTable[Index];
+    }
+    if (Sum != 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 /**
   Get FIT entry number and fill global FIT table context, from argument.
 
@@ -1040,6 +1528,7 @@ GetFitEntryNumber (
   UINT32    MicrocodeSize;
   UINT8     *MicrocodeBuffer;
   UINT32    MicrocodeBufferSize;
+  UINT32    MicrocodeTotalSize;
   UINT8     *Walker;
   UINT32    MicrocodeRegionOffset;
   UINT32    MicrocodeRegionSize;
@@ -1390,6 +1879,10 @@ GetFitEntryNumber (
                 }
               }
 
+              if (!VerifyMicrocode (MicrocodeBuffer, MicrocodeFileSize - (UINT32)(MicrocodeBuffer - MicrocodeFileBuffer), &MicrocodeTotalSize)) {
+                printf ("WARNING: Microcode at 0x%x failed the header or checksum check!\n", MicrocodeBase + (UINT32)((UINTN) MicrocodeBuffer - (UINTN) MicrocodeFileBuffer));
+              }
+
               //
               // Add Microcode
               //
@@ -1804,6 +2297,10 @@ GetFitEntryNumber (
         }
       }
 
+      if (!VerifyMicrocode (MicrocodeBuffer, MicrocodeFileSize - (UINT32)(MicrocodeBuffer - MicrocodeFileBuffer), &MicrocodeTotalSize)) {
+        printf ("WARNING: Microcode at 0x%x failed the header or checksum check!\n", MicrocodeBase + (UINT32)((UINTN) MicrocodeBuffer - (UINTN) MicrocodeFileBuffer));
+      }
+
       //
       // Add Microcode
       //
@@ -3304,9 +3801,16 @@ WriteOutputFile (
   }
 
   //
-  // Open the output FvRecovery.fv file
+  // Open the output FvRecovery.fv file.
+  // The data may be a private mapping of the output file itself, whose
+  // unchanged pages are read from the file. So an existing output file is
+  // only truncated after it has been written.
   //
-  if ((FpOut = fopen (FileName, "w+b")) == NULL) {
+  FpOut = NULL;
+  if (mMappedInputSize != 0) {
+    FpOut = fopen (FileName, "r+b");
+  }
+  if ((FpOut == NULL) && ((FpOut = fopen (FileName, "w+b")) == NULL)) {
     Error (NULL, 0, 0, "Unable to open file", "%s", FileName);
     return STATUS_ERROR;
   }
@@ -3318,6 +3822,16 @@ WriteOutputFile (
     fclose (FpOut);
     return STATUS_ERROR;
   }
+#ifndef _WIN32
+  if (mMappedInputSize != 0) {
+    fflush (FpOut);
+    if (ftruncate (fileno (FpOut), FileSize) != 0) {
+      Error (NULL, 0, 0, "Write output file error!", NULL);
+      fclose (FpOut);
+      return STATUS_ERROR;
+    }
+  }
+#endif
 
   //
   // Close the output FvRecovery.fv file
@@ -3653,8 +4167,9 @@ FitGen (
   //
   // Step 1: Read InputFvRecovery.fv data
   //
+  StartPhase ();
   if (IsFv) {
-    Status = ReadInputFile (argv[1], &FileBuffer, &FvRecoveryFileSize, &FileBufferRaw);
+    Status = MapInputFile (argv[1], &FileBuffer, &FvRecoveryFileSize, &FileBufferRaw);
     if (Status != STATUS_SUCCESS) {
       Error (NULL, 0, 0, "Unable to open file", "%s", argv[1]);
       goto exitFunc;
@@ -3662,12 +4177,25 @@ FitGen (
     FdFileBuffer = FileBuffer;
     FdFileSize = FvRecoveryFileSize;
   } else {
-    Status = ReadInputFile (argv[2], &FdFileBuffer, &FdFileSize, &FileBufferRaw);
+    Status = MapInputFile (argv[2], &FdFileBuffer, &FdFileSize, &FileBufferRaw);
     if (Status != STATUS_SUCCESS) {
       Error (NULL, 0, 0, "Unable to open file", "%s", argv[2]);
       goto exitFunc;
     }
+  }
+  EndPhase ("Read input");
 
+  //
+  // Index the FVs and FFS files once for all the GUID lookups.
+  //
+  StartPhase ();
+  Status = BuildFfsIndex (FdFileBuffer, FdFileSize);
+  if (Status != STATUS_SUCCESS) {
+    goto exitFunc;
+  }
+  EndPhase ("Build FFS index");
+
+  if (!IsFv) {
     //
     // Get Fvrecovery information
     //
@@ -3682,7 +4210,9 @@ FitGen (
   //
   // Step 2: Calculate FIT entry number.
   //
+  StartPhase ();
   FitEntryNumber = GetFitEntryNumber (argc, argv, FdFileBuffer, FdFileSize);
+  EndPhase ("Parse FIT entries");
   if (!gFitTableContext.Clear) {
     if (FitEntryNumber == 0) {
       Status = STATUS_ERROR;
@@ -3705,6 +4235,7 @@ FitGen (
     //
     // Step 3: Get enough space for FIT
     //
+    StartPhase ();
     FixedFitLocation = GetFixedFitLocation (argc, argv);
     if (FixedFitLocation != 0 &&
       (FixedFitLocation < TOP_FLASH_ADDRESS - FdFileSize || FixedFitLocation + FitTableSize > TOP_FLASH_ADDRESS)) {
@@ -3765,10 +4296,14 @@ FitGen (
       }
     }
 
+    EndPhase ("Find FIT space");
+
     //
     // Step 4: Fill the FIT table one by one
     //
+    StartPhase ();
     FillFitTable (FdFileBuffer, FdFileSize, FitTableOffset);
+    EndPhase ("Fill FIT table");
 
     //
     // For debug
@@ -3800,15 +4335,18 @@ FitGen (
   //
   // Step 5: Write OutputFvRecovery.fv data
   //
+  StartPhase ();
   if (IsFv) {
     Status = WriteOutputFile (argv[2], FileBuffer, FvRecoveryFileSize);
   } else {
     Status = WriteOutputFile (argv[3], FdFileBuffer, FdFileSize);
   }
+  EndPhase ("Write output");
 
 exitFunc:
+  FreeFfsIndex ();
   if (FileBufferRaw != NULL) {
-    free ((VOID *)FileBufferRaw);
+    ReleaseInputFile (FileBufferRaw);
   }
   return Status;
 }
@@ -3842,7 +4380,7 @@ FitView (
   //
   // Step 1: Read input file
   //
-  Status = ReadInputFile (argv[2], &FileBuffer, &FvRecoveryFileSize, &FileBufferRaw);
+  Status = MapInputFile (argv[2], &FileBuffer, &FvRecoveryFileSize, &FileBufferRaw);
   if (Status != STATUS_SUCCESS) {
     Error (NULL, 0, 0, "Unable to open file", "%s", argv[2]);
     goto exitFunc;
@@ -3920,7 +4458,317 @@ FitView (
 
 exitFunc:
   if (FileBufferRaw != NULL) {
-    free ((VOID *)FileBufferRaw);
+    ReleaseInputFile (FileBufferRaw);
+  }
+  return Status;
+}
+
+//
+// A flash range covered by a FIT entry, for the overlap check.
+//
+typedef struct {
+  UINT64  Start;
+  UINT64  End;
+  UINT32  FitIndex;
+} FIT_VERIFY_RANGE;
+
+/**
+  Compare two FIT entry ranges by start address, for qsort.
+
+  @param Range1           The first range.
+  @param Range2           The second range.
+
+  @return <0, 0 or >0 as Range1 starts below, at or above Range2.
+**/
+int
+CompareFitRange (
+  IN CONST VOID  *Range1,
+  IN CONST VOID  *Range2
+  )
+{
+  if (((FIT_VERIFY_RANGE *)Range1)->Start < ((FIT_VERIFY_RANGE *)Range2)->Start) {
+    return -1;
+  }
+  if (((FIT_VERIFY_RANGE *)Range1)->Start > ((FIT_VERIFY_RANGE *)Range2)->Start) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  Check that no two ranges overlap.
+
+  The ranges are sorted by start address, so that each range only needs to
+  be compared with the furthest end seen so far.
+
+  @param Range            The ranges, sorted in place.
+  @param RangeNumber      The number of ranges.
+  @param RangeName        Name of the ranges, for the error message.
+
+  @return The number of overlaps found.
+**/
+UINT32
+CheckFitRangeOverlap (
+  IN FIT_VERIFY_RANGE  *Range,
+  IN UINT32            RangeNumber,
+  IN CHAR8             *RangeName
+  )
+{
+  UINT32  Index;
+  UINT32  LastIndex;
+  UINT32  Errors;
+
+  Errors = 0;
+  qsort (Range, RangeNumber, sizeof (FIT_VERIFY_RANGE), CompareFitRange);
+  for (Index = 1, LastIndex = 0; Index < RangeNumber; Index++) {
+    if (Range[Index].Start < Range[LastIndex].End) {
+      printf ("ERROR: FIT entry %02d %s overlaps FIT entry %02d!\n", Range[Index].FitIndex, RangeName, Range[LastIndex].FitIndex);
+      Errors++;
+    }
+    if (Range[Index].End > Range[LastIndex].End) {
+      LastIndex = Index;
+    }
+  }
+
+  return Errors;
+}
+
+/**
+  Verify the FIT table of an image, without changing the image.
+
+  The checks are: FIT pointer and header, header checksum, entry order,
+  entry addresses within the image, microcode update checksums, startup
+  ACM headers and overlaps among BIOS modules and among microcode updates.
+
+  @param FvBuffer         The image buffer.
+  @param FvSize           The image size.
+
+  @return The number of errors found.
+**/
+UINT32
+VerifyFitTable (
+  IN UINT8   *FvBuffer,
+  IN UINT32  FvSize
+  )
+{
+  FIRMWARE_INTERFACE_TABLE_ENTRY  *FitEntry;
+  UINT32                          FitTableOffset;
+  UINT32                          EntryNum;
+  UINT32                          Index;
+  UINT32                          Errors;
+  UINT32                          EntrySize;
+  UINT32                          MicrocodeSize;
+  UINT8                           *EntryBuffer;
+  FIT_VERIFY_RANGE                *BiosRange;
+  FIT_VERIFY_RANGE                *MicrocodeRange;
+  UINT32                          BiosRangeNumber;
+  UINT32                          MicrocodeRangeNumber;
+
+  Errors = 0;
+
+  //
+  // FIT pointer and header
+  //
+  if ((gFitTableContext.FitTablePointerOffset < sizeof (UINT32)) ||
+      (gFitTableContext.FitTablePointerOffset > FvSize)) {
+    printf ("ERROR: FIT pointer offset 0x%x is outside of the image!\n", gFitTableContext.FitTablePointerOffset);
+    return 1;
+  }
+  FitTableOffset = *(UINT32 *)(FvBuffer + FvSize - gFitTableContext.FitTablePointerOffset);
+  FitEntry = (FIRMWARE_INTERFACE_TABLE_ENTRY *)FLASH_TO_MEMORY (FitTableOffset, FvBuffer, FvSize);
+  if (((UINT8 *)FitEntry < FvBuffer) ||
+      ((UINT8 *)FitEntry + sizeof (FIRMWARE_INTERFACE_TABLE_ENTRY) > FvBuffer + FvSize)) {
+    printf ("ERROR: FIT table address 0x%x is outside of the image!\n", FitTableOffset);
+    return 1;
+  }
+  if ((FitTableOffset & 0xF) != 0) {
+    printf ("ERROR: FIT table address 0x%x is not 16 byte aligned!\n", FitTableOffset);
+    Errors++;
+  }
+  if ((FitEntry[0].Address != *(UINT64 *)"_FIT_   ") || (FitEntry[0].Type != FIT_TABLE_TYPE_HEADER)) {
+    printf ("ERROR: FIT header not found at 0x%x!\n", FitTableOffset);
+    return Errors + 1;
+  }
+  EntryNum = GetFirmwareInterfaceTableEntrySize (&FitEntry[0]);
+  if ((EntryNum == 0) ||
+      ((UINT8 *)&FitEntry[EntryNum] > FvBuffer + FvSize)) {
+    printf ("ERROR: FIT entry number %d is invalid!\n", EntryNum);
+    return Errors + 1;
+  }
+  if ((FitEntry[0].C_V != 0) &&
+      (CalculateChecksum8 ((UINT8 *)FitEntry, sizeof (FIRMWARE_INTERFACE_TABLE_ENTRY) * EntryNum) != 0)) {
+    printf ("ERROR: FIT header checksum is invalid!\n");
+    Errors++;
+  }
+
+  BiosRange      = malloc (EntryNum * sizeof (FIT_VERIFY_RANGE));
+  MicrocodeRange = malloc (EntryNum * sizeof (FIT_VERIFY_RANGE));
+  if ((BiosRange == NULL) || (MicrocodeRange == NULL)) {
+    Error (NULL, 0, 0, "No sufficient memory to allocate!", NULL);
+    free (BiosRange);
+    free (MicrocodeRange);
+    return Errors + 1;
+  }
+  BiosRangeNumber      = 0;
+  MicrocodeRangeNumber = 0;
+
+  //
+  // FIT entries
+  //
+  for (Index = 1; Index < EntryNum; Index++) {
+    if (FitEntry[Index].Type == FIT_TABLE_TYPE_HEADER) {
+      printf ("ERROR: FIT entry %02d is a second header!\n", Index);
+      Errors++;
+      continue;
+    }
+    if (FitEntry[Index].Type < FitEntry[Index - 1].Type) {
+      printf ("ERROR: FIT entry %02d type %02x is out of order!\n", Index, FitEntry[Index].Type);
+      Errors++;
+    }
+
+    //
+    // Port based entries and unused addresses carry no flash data.
+    //
+    if ((((FitEntry[Index].Type == FIT_TABLE_TYPE_TPM_POLICY) ||
+          (FitEntry[Index].Type == FIT_TABLE_TYPE_TXT_POLICY)) && (FitEntry[Index].Version == 0)) ||
+        (FitEntry[Index].Address == 0) || (FitEntry[Index].Type == 0x7F)) {
+      continue;
+    }
+    EntryBuffer = FLASH_TO_MEMORY (FitEntry[Index].Address, FvBuffer, FvSize);
+    if ((EntryBuffer < FvBuffer) || (EntryBuffer >= FvBuffer + FvSize)) {
+      //
+      // The entry may point outside of the BIOS region, at the top of flash only.
+      //
+      if (FitEntry[Index].Type == FIT_TABLE_TYPE_MICROCODE || FitEntry[Index].Type == FIT_TABLE_TYPE_BIOS_MODULE) {
+        printf ("ERROR: FIT entry %02d address 0x%llx is outside of the image!\n", Index, (unsigned long long) FitEntry[Index].Address);
+        Errors++;
+      }
+      continue;
+    }
+
+    switch (FitEntry[Index].Type) {
+    case FIT_TABLE_TYPE_MICROCODE:
+      if (!VerifyMicrocode (EntryBuffer, (UINT32)(FvBuffer + FvSize - EntryBuffer), &MicrocodeSize)) {
+        printf ("ERROR: FIT entry %02d microcode at 0x%llx failed the header or checksum check!\n", Index, (unsigned long long) FitEntry[Index].Address);
+        Errors++;
+        break;
+      }
+      MicrocodeRange[MicrocodeRangeNumber].Start    = FitEntry[Index].Address;
+      MicrocodeRange[MicrocodeRangeNumber].End      = FitEntry[Index].Address + MicrocodeSize;
+      MicrocodeRange[MicrocodeRangeNumber].FitIndex = Index;
+      MicrocodeRangeNumber++;
+      break;
+    case FIT_TABLE_TYPE_STARTUP_ACM:
+      if (!CheckAcm ((ACM_FORMAT *)EntryBuffer, (UINTN)(FvBuffer + FvSize - EntryBuffer))) {
+        printf ("ERROR: FIT entry %02d startup ACM at 0x%llx is invalid!\n", Index, (unsigned long long) FitEntry[Index].Address);
+        Errors++;
+      }
+      break;
+    case FIT_TABLE_TYPE_BIOS_MODULE:
+      EntrySize = GetFirmwareInterfaceTableEntrySize (&FitEntry[Index]) * 16;
+      if (EntrySize > (UINT32)(FvBuffer + FvSize - EntryBuffer)) {
+        printf ("ERROR: FIT entry %02d BIOS module exceeds the image!\n", Index);
+        Errors++;
+      }
+      BiosRange[BiosRangeNumber].Start    = FitEntry[Index].Address;
+      BiosRange[BiosRangeNumber].End      = FitEntry[Index].Address + EntrySize;
+      BiosRange[BiosRangeNumber].FitIndex = Index;
+      BiosRangeNumber++;
+      break;
+    default:
+      break;
+    }
+  }
+
+  Errors += CheckFitRangeOverlap (BiosRange, BiosRangeNumber, "BIOS module");
+  Errors += CheckFitRangeOverlap (MicrocodeRange, MicrocodeRangeNumber, "microcode");
+
+  free (BiosRange);
+  free (MicrocodeRange);
+
+  return Errors;
+}
+
+/**
+  Verify function for FitGen.
+
+  @param argc             Number of command line parameters.
+  @param argv             Array of pointers to parameter strings
+
+  @retval STATUS_SUCCESS  The FIT table is valid.
+  @retval STATUS_ERROR    The FIT table is not valid, or some error occurred during execution.
+**/
+STATUS
+FitVerify (
+  IN INTN   argc,
+  IN CHAR8  **argv
+  )
+{
+  UINT32                        FvRecoveryFileSize;
+  UINT8                         *FileBuffer;
+  UINT8                         *FileBufferRaw = NULL;
+  STATUS                        Status;
+  UINT32                        Frba;
+  UINT32                        Errors;
+  FLASH_MAP_0_REGISTER          FlashMap0;
+  FLASH_REGION_1_BIOS_REGISTER  FlashRegion1;
+
+  //
+  // Step 1: Read input file
+  //
+  StartPhase ();
+  Status = MapInputFile (argv[2], &FileBuffer, &FvRecoveryFileSize, &FileBufferRaw);
+  if (Status != STATUS_SUCCESS) {
+    Error (NULL, 0, 0, "Unable to open file", "%s", argv[2]);
+    goto exitFunc;
+  }
+  EndPhase ("Read input");
+
+  if (argc == 3) {
+    gFitTableContext.FitTablePointerOffset = DEFAULT_FIT_TABLE_POINTER_OFFSET;
+  } else if ((stricmp (argv[3], "-f") == 0) && (argc == 5)) {
+    gFitTableContext.FitTablePointerOffset = xtoi (argv[3 + 1]);
+  } else {
+    Error (NULL, 0, 0, "Invalid verify option: ", "%s", argv[3]);
+    Status = STATUS_ERROR;
+    goto exitFunc;
+  }
+  gFitTableContext.TopFlashAddressRemapValue = 0x100000000;
+
+  //
+  // Use the BIOS region of a full flash image.
+  //
+  if ((FvRecoveryFileSize >= FLMAP0_BASE_OFFSET + sizeof (UINT32)) &&
+      (*(UINT32 *)(FileBuffer + FLVALSIG_BASE_OFFSET) == FLASH_VALID_SIGNATURE)) {
+    CopyMem (&FlashMap0, FileBuffer + FLMAP0_BASE_OFFSET, sizeof (FlashMap0));
+    Frba = FlashMap0.Frba << 4 & 0xFF0;
+    CopyMem (&FlashRegion1, FileBuffer + Frba + 0x4, sizeof (FlashRegion1));
+    if (((FlashRegion1.RegionLimit << 12 | 0xFFF) + 1) > FvRecoveryFileSize) {
+      Error (NULL, 0, 0, "BIOS region exceeds the image!", NULL);
+      Status = STATUS_ERROR;
+      goto exitFunc;
+    }
+    FileBuffer = (UINT8 *)(FileBuffer + (FlashRegion1.RegionBase << 12));
+    FvRecoveryFileSize = ((FlashRegion1.RegionLimit << 12 | 0xFFF) + 1) - (FlashRegion1.RegionBase << 12);
+  }
+
+  //
+  // Step 2: Verify FIT table
+  //
+  StartPhase ();
+  Errors = VerifyFitTable (FileBuffer, FvRecoveryFileSize);
+  EndPhase ("Verify FIT table");
+
+  if (Errors != 0) {
+    printf ("FIT table verification failed: %d error(s).\n", Errors);
+    Status = STATUS_ERROR;
+  } else {
+    printf ("FIT table verification passed.\n");
+  }
+
+exitFunc:
+  if (FileBufferRaw != NULL) {
+    ReleaseInputFile (FileBufferRaw);
   }
   return Status;
 }
@@ -3940,8 +4788,24 @@ main (
   char  **argv
   )
 {
+  int   Index;
+  int   NewArgc;
+
   SetUtilityName (UTILITY_NAME);
 
+  //
+  // -TIMING may appear anywhere, remove it before the positional parsing.
+  //
+  NewArgc = 0;
+  for (Index = 0; Index < argc; Index++) {
+    if ((Index > 0) && ((strcmp (argv[Index], "-TIMING") == 0) || (strcmp (argv[Index], "-timing") == 0))) {
+      mTiming = TRUE;
+      continue;
+    }
+    argv[NewArgc++] = argv[Index];
+  }
+  argc = NewArgc;
+
   //
   // Display utility information
   //
@@ -3952,6 +4816,8 @@ main (
   //
   if (argc >= MIN_VIEW_ARGS && stricmp (argv[1], "-view") == 0) {
     return FitView (argc, argv);
+  } else if (argc >= MIN_VIEW_ARGS && stricmp (argv[1], "-verify") == 0) {
+    return FitVerify (argc, argv);
   } else if (argc >= MIN_ARGS) {
     return FitGen (argc, argv);
   } else {
@@ -3437,6 +3437,8 @@ Mvpp2RxqHwInit (
   )
 {
   Rxq->LastDesc = Rxq->Size - 1;
+  Rxq->PendingDescs = 0;
+  Rxq->ProcessedDescs = 0;
 
   /* Zero occupied and non-occupied counters - direct access */
   Mvpp2Write (Port->Priv, MVPP2_RXQ_STATUS_REG(Rxq->Id), 0);
@@ -3485,6 +3487,8 @@ Mvpp2RxqHwDeinit (
   Rxq->Descs = NULL;
   Rxq->LastDesc = 0;
   Rxq->NextDescToProc = 0;
+  Rxq->PendingDescs = 0;
+  Rxq->ProcessedDescs = 0;
   Rxq->DescsPhys = 0;
 
   /*
@@ -424,7 +424,7 @@ Pp2DxeLatePortInitialize (
 
   Port->Rxqs[0].Descs = Mvpp2Shared->BufferLocation.RxDescs[Port->Id];
 
-  for (Queue = 0; Queue < TxqNumber; Queue++) {
+  for (Queue = 0; Queue < RxqNumber; Queue++) {
     MVPP2_RX_QUEUE *Rxq = &Port->Rxqs[Queue];
 
     Rxq->Id = Queue + Port->FirstRxq;
@@ -1201,6 +1201,34 @@ Pp2SnpTransmit (
   ReturnUnlock (SavedTpl, Status);
 }
 
+/*
+ * Pick the RX queue to serve the next packet from. Received descriptors
+ * are fetched from HW in batches - the occupied counter is only read
+ * again once all previously fetched descriptors have been processed.
+ */
+STATIC
+MVPP2_RX_QUEUE *
+Pp2DxeRxqSelect (
+  IN PP2DXE_PORT *Port
+  )
+{
+  MVPP2_RX_QUEUE *Rxq;
+  INTN Queue;
+
+  for (Queue = 0; Queue < RxqNumber; Queue++) {
+    Rxq = &Port->Rxqs[Queue];
+    if (Rxq->PendingDescs == 0) {
+      Rxq->PendingDescs = Mvpp2RxqReceived (Port, Rxq->Id);
+    }
+
+    if (Rxq->PendingDescs > 0) {
+      return Rxq;
+    }
+  }
+
+  return NULL;
+}
+
 EFI_STATUS
 EFIAPI
 Pp2SnpReceive (
@@ -1213,7 +1241,6 @@ Pp2SnpReceive (
   OUT UINT16                     *EtherType OPTIONAL
   )
 {
-  INTN ReceivedPackets;
   PP2DXE_CONTEXT *Pp2Context;
   PP2DXE_PORT *Port;
   UINTN PhysAddr, VirtAddr;
@@ -1255,17 +1282,17 @@ Pp2SnpReceive (
 
   Port = &Pp2Context->Port;
   ASSERT (Port != NULL);
-  Rxq = &Port->Rxqs[0];
-  ASSERT (Rxq != NULL);
-
-  ReceivedPackets = Mvpp2RxqReceived(Port, Rxq->Id);
 
-  if (ReceivedPackets == 0) {
+  Rxq = Pp2DxeRxqSelect (Port);
+  if (Rxq == NULL) {
     ReturnUnlock(SavedTpl, EFI_NOT_READY);
   }
 
-  /* Process one packet per call */
-  RxDesc = Mvpp2RxqNextDescGet(Rxq);
+  /*
+   * Peek at the descriptor first, so that it is left in place when
+   * the caller's buffer turns out to be too small.
+   */
+  RxDesc = Rxq->Descs + Rxq->NextDescToProc;
   StatusReg = RxDesc->status;
 
   /* extract addresses from descriptor */
@@ -1315,12 +1342,23 @@ Pp2SnpReceive (
   Status = EFI_SUCCESS;
 
 drop:
+  /* Consume the descriptor and prefetch the following one */
+  Mvpp2RxqNextDescGet (Rxq);
+  Rxq->PendingDescs--;
+  Rxq->ProcessedDescs++;
+
   /* Refill: pass packet back to BM */
   PoolId = (StatusReg & MVPP2_RXD_BM_POOL_ID_MASK) >> MVPP2_RXD_BM_POOL_ID_OFFS;
   Mvpp2BmPoolPut (Pp2Context->Port.Priv, PoolId, PhysAddr, VirtAddr);
 
-  /* Update counters with 1 packet received and 1 packet refilled */
-  Mvpp2RxqStatusUpdate(Port, Rxq->Id, 1, 1);
+  /*
+   * Update counters once per batch - with all packets received
+   * and refilled since the last HW status read.
+   */
+  if (Rxq->PendingDescs == 0) {
+    Mvpp2RxqStatusUpdate (Port, Rxq->Id, Rxq->ProcessedDescs, Rxq->ProcessedDescs);
+    Rxq->ProcessedDescs = 0;
+  }
 
   ReturnUnlock(SavedTpl, Status);
 }
@@ -199,6 +199,12 @@ typedef struct {
   /* Index of the next RX DMA descriptor to process */
   INT32 NextDescToProc;
 
+  /* Number of received descriptors fetched from HW and not yet processed */
+  INT32 PendingDescs;
+
+  /* Number of processed descriptors not yet returned to HW */
+  INT32 ProcessedDescs;
+
   /* ID of Port to which physical RXQ is mapped */
   INT32 Port;
 